@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "ofxMol/Cache.h"
+
+// Setup of a PDB file parsed, against setup from its cache file (see CACHE FILES in the README)
+namespace Benchmark
+{
+    struct SetupRun
+    {
+        std::string path;
+        OfxMol::SetupMode mode;
+        bool useCache;
+        OfxMol::System system;
+
+        void operator()()
+        {
+            system = OfxMol::System();
+            system.setup(path, mode, useCache);
+        }
+    };
+
+    //! True if both systems have the same atoms at the same positions
+    inline bool sameAtoms(OfxMol::System &a, OfxMol::System &b)
+    {
+        if (a.number_of_models() != b.number_of_models()) return false;
+        for (unsigned int m=0; m<a.number_of_models(); m++)
+        {
+            const OfxMol::AtomArrays &x = a.getModel(m).arrays();
+            const OfxMol::AtomArrays &y = b.getModel(m).arrays();
+            if (x.x != y.x || x.y != y.y || x.z != y.z || x.radius != y.radius) return false;
+        }
+        return true;
+    }
+
+    inline void benchCache(Report &report, const std::vector<std::string> &paths)
+    {
+        report.section("Cache files: setup parsing the PDB file, and from the cache");
+
+        for (size_t i=0; i<paths.size(); i++)
+        {
+            for (int m=0; m<2; m++)
+            {
+                SetupRun task;
+                task.path = paths[i];
+                task.mode = m == 0 ? OfxMol::SIMPLE : OfxMol::ADVANCED;
+                std::string cachePath = OfxMol::Cache::path(task.path, task.mode);
+
+                task.useCache = false;
+                double parse = bestOf(task);
+                OfxMol::System parsed = task.system;
+
+                // first setup with the cache parses the file and writes the cache
+                std::remove(cachePath.c_str());
+                task.useCache = true;
+                double write = bestOf(task, 1);
+
+                double read = bestOf(task);
+                bool same = sameAtoms(parsed, task.system);
+
+                report.add(ofFile(task.path).getFileName() + (m == 0 ? " SIMPLE" : " ADVANCED")
+                           + ": parse " + ms(parse) + ", parse and write " + ms(write)
+                           + ", cache " + ms(read) + " (x" + ofToString(parse / read, 1) + ")"
+                           + ", PDB " + mb(fileSize(task.path)) + ", cache " + mb(fileSize(cachePath))
+                           + (same ? "" : ", MODELS DIFFER"));
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Benchmark.h"
+#include <ESBTL/default.h>
+
+// Radius classifier built for every atom, as OfxMol::Atom did before, against the classifier
+// shared by the process and a property index per atom
+namespace Benchmark
+{
+    typedef OfxMol::Atom::Radius_classifier Radius_classifier;
+    typedef ESBTL::Default_system_with_coarse_grain::Atom Esbtl_atom;
+
+    //! Atoms are classified by a classifier of their own, which they kept along with their radius
+    struct PerAtomRun
+    {
+        std::vector<const Esbtl_atom*> *atoms;
+        std::vector<float> radii;
+
+        void operator()()
+        {
+            radii.resize(atoms->size());
+            for (size_t i=0; i<atoms->size(); i++)
+            {
+                Radius_classifier classifier;
+                radii[i] = classifier.get_properties(*(*atoms)[i]).value();
+            }
+        }
+    };
+
+    //! Atoms keep the index of their radius in the shared classifier
+    struct SharedRun
+    {
+        std::vector<const Esbtl_atom*> *atoms;
+        std::vector<unsigned char> indices;
+
+        void operator()()
+        {
+            const Radius_classifier &classifier = Radius_classifier::shared();
+            indices.resize(atoms->size());
+            for (size_t i=0; i<atoms->size(); i++)
+            {
+                indices[i] = classifier.get_index(*(*atoms)[i]);
+            }
+        }
+    };
+
+    inline void benchClassifier(Report &report, const std::string &path)
+    {
+        // the former per-atom classifiers take about 0.1 ms per atom: classify a sample of them
+        const size_t PER_ATOM_SAMPLE = 1000;
+
+        std::vector<ESBTL::Default_system_with_coarse_grain> systems;
+        ESBTL::PDB_line_selector sel;
+        ESBTL::All_atom_system_builder<ESBTL::Default_system_with_coarse_grain> builder(systems, sel.max_nb_systems());
+        ESBTL::read_a_pdb_file<ESBTL::MMAP>(path, sel, builder, ESBTL::Accept_none_occupancy_policy<ESBTL::PDB::Line_format<> >());
+
+        std::vector<const Esbtl_atom*> atoms;
+        ESBTL::Default_system_with_coarse_grain::Model &model = *systems[0].models_begin();
+        for (ESBTL::Default_system_with_coarse_grain::Model::Atoms_iterator a=model.atoms_begin(); a!=model.atoms_end(); ++a)
+        {
+            atoms.push_back(&(*a));
+        }
+        std::vector<const Esbtl_atom*> sample(atoms.begin(), atoms.begin() + std::min(atoms.size(), PER_ATOM_SAMPLE));
+
+        report.section("Radius classifiers on " + ofFile(path).getFileName() + " (" + ofToString(atoms.size()) + " atoms)");
+
+        PerAtomRun perAtom = {&sample, std::vector<float>()};
+        SharedRun shared = {&atoms, std::vector<unsigned char>()};
+        double perAtomTime = bestOf(perAtom) / sample.size();
+        double sharedTime = bestOf(shared) / atoms.size();
+
+        size_t mismatches = 0;
+        for (size_t i=0; i<sample.size(); i++)
+        {
+            mismatches += float(Radius_classifier::shared().get_properties(shared.indices[i]).value()) != perAtom.radii[i];
+        }
+
+        // heap of one classifier: the former atoms each held one, the current ones share it
+        size_t before = heapBytes();
+        Radius_classifier *classifier = new Radius_classifier();
+        size_t classifierHeap = heapBytes() - before;
+        delete classifier;
+
+        report.add("per-atom classifier: " + ofToString(perAtomTime * 1000, 2) + " us per atom, "
+                   + ofToString(sizeof(Radius_classifier) + classifierHeap + sizeof(float)) + " bytes per atom (classifier and radius)");
+        report.add("shared classifier:   " + ofToString(sharedTime * 1000, 3) + " us per atom, "
+                   + ofToString(sizeof(unsigned char)) + " byte per atom (property index), "
+                   + ofToString(sizeof(Radius_classifier) + classifierHeap) + " bytes once");
+        report.add("sizeof(OfxMol::Atom) " + ofToString(sizeof(OfxMol::Atom)) + ", sizeof(OfxMol::Coarse_Atom) " + ofToString(sizeof(OfxMol::Coarse_Atom))
+                   + ", radii " + (mismatches == 0 ? std::string("identical") : ofToString(mismatches) + " DIFFERENT"));
+    }
+}
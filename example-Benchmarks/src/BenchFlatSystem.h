@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Benchmark.h"
+#include <ESBTL/default.h>
+
+// ESBTL::Default_system (std::map hierarchy) against ESBTL::Flat_system (contiguous arrays)
+namespace Benchmark
+{
+    template<class System>
+    struct BuildRun
+    {
+        std::string path;
+        std::vector<System> systems;
+
+        void operator()()
+        {
+            systems.clear();
+            ESBTL::PDB_line_selector sel;
+            ESBTL::All_atom_system_builder<System> builder(systems, sel.max_nb_systems());
+            ESBTL::read_a_pdb_file<ESBTL::MMAP>(path, sel, builder, ESBTL::Accept_none_occupancy_policy<ESBTL::PDB::Line_format<> >());
+        }
+    };
+
+    template<class System>
+    struct AtomsRun
+    {
+        std::vector<System> *systems;
+        double sum;
+
+        void operator()()
+        {
+            for (typename std::vector<System>::iterator s=systems->begin(); s!=systems->end(); ++s)
+                for (typename System::Models_iterator m=s->models_begin(); m!=s->models_end(); ++m)
+                    for (typename System::Model::Atoms_iterator a=m->atoms_begin(); a!=m->atoms_end(); ++a)
+                        sum += a->x();
+        }
+    };
+
+    template<class System>
+    struct ResiduesRun
+    {
+        std::vector<System> *systems;
+        size_t sum;
+
+        void operator()()
+        {
+            for (typename std::vector<System>::iterator s=systems->begin(); s!=systems->end(); ++s)
+                for (typename System::Models_iterator m=s->models_begin(); m!=s->models_end(); ++m)
+                    for (typename System::Model::Residues_iterator r=m->residues_begin(); r!=m->residues_end(); ++r)
+                        sum += r->number_of_atoms();
+        }
+    };
+
+    template<class System>
+    std::string layout(const std::string &path)
+    {
+        BuildRun<System> build;
+        build.path = path;
+        double buildTime = bestOf(build);
+
+        // heap of the systems of a single build
+        build.systems.clear();
+        size_t before = heapBytes();
+        build();
+        size_t heap = heapBytes() - before;
+
+        size_t atoms = 0;
+        for (typename std::vector<System>::iterator s=build.systems.begin(); s!=build.systems.end(); ++s)
+            for (typename System::Models_iterator m=s->models_begin(); m!=s->models_end(); ++m)
+                atoms += m->number_of_atoms();
+
+        AtomsRun<System> atomsRun = {&build.systems, 0};
+        ResiduesRun<System> residuesRun = {&build.systems, 0};
+        std::string line = "build " + ms(buildTime)
+                         + ", atom iteration " + ms(bestOf(atomsRun))
+                         + ", residue iteration " + ms(bestOf(residuesRun));
+        if (heap > 0 && atoms > 0)
+        {
+            line += ", heap " + mb(heap) + " (" + ofToString(heap / atoms) + " bytes per atom)";
+        }
+        return line;
+    }
+
+    inline void benchFlatSystem(Report &report, const std::string &path)
+    {
+        report.section("System layouts on " + ofFile(path).getFileName());
+        report.add("Default_system: " + layout<ESBTL::Default_system>(path));
+        report.add("Flat_system:    " + layout<ESBTL::Flat_system>(path));
+    }
+}
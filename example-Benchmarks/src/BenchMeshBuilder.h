@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Benchmark.h"
+#include "ofxMol/MeshBuilder.h"
+
+// Mesh generators with 1 to 16 threads (see PARALLEL MESHES in the README)
+namespace Benchmark
+{
+    struct MeshRun
+    {
+        OfxMol::Model *model;
+        int kind;
+
+        void operator()()
+        {
+            switch (kind)
+            {
+                case 0: { ofMesh mesh = model->atomsMesh(6); break; }
+                case 1: { ofMesh mesh = model->atomsMesh(6, true); break; }
+                case 2: { ofMesh mesh = model->atomsPointCloud(); break; }
+                default: { ofPolyline line = model->backbonePoly(); break; }
+            }
+        }
+    };
+
+    //! A job doing nothing: the time of a run is the cost of dispatching its slices
+    class EmptyJob : public OfxMol::MeshBuilder::Job
+    {
+    public:
+        void run(size_t /*slice*/, size_t /*begin*/, size_t /*end*/) {}
+    };
+
+    struct EmptyRuns
+    {
+        EmptyJob job;
+
+        void operator()()
+        {
+            for (int i=0; i<1000; i++) OfxMol::MeshBuilder::shared().run(job, 1000);
+        }
+    };
+
+    inline void benchMeshBuilder(Report &report, const std::string &path)
+    {
+        report.section("Mesh generators of " + ofFile(path).getFileName() + " by number of threads ("
+                       + ofToString(OfxMol::MeshBuilder::hardwareThreads()) + " processors)");
+
+        OfxMol::System system;
+        system.setup(path, OfxMol::SIMPLE, false);
+        MeshRun task;
+        task.model = &system.getModel(0);
+
+        static const char *NAMES[] = {"atomsMesh(6)", "atomsMesh(6, indexed)", "atomsPointCloud", "backbonePoly"};
+        const unsigned int THREADS[] = {1, 2, 4, 8, 16};
+        for (int t=0; t<5; t++)
+        {
+            OfxMol::MeshBuilder::shared().setNumThreads(THREADS[t]);
+            std::string line = ofToString(THREADS[t]) + " threads:";
+            for (task.kind=0; task.kind<4; task.kind++)
+            {
+                line += std::string(task.kind == 0 ? " " : ", ") + NAMES[task.kind] + " " + ms(bestOf(task));
+            }
+            EmptyRuns runs;
+            // 1000 runs in ms: us per run
+            line += ", empty run " + ofToString(bestOf(runs), 2) + " us";
+            report.add(line);
+        }
+        OfxMol::MeshBuilder::shared().setNumThreads(0);
+    }
+}
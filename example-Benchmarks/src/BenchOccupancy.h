@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Benchmark.h"
+#include <ESBTL/default.h>
+
+// ESBTL occupancy policies on a file where half of the atoms are partially occupied
+namespace Benchmark
+{
+    template<ESBTL::Reading_mode mode, class Occupancy_policy>
+    struct ReadRun
+    {
+        std::string path;
+        size_t atoms;
+
+        void operator()()
+        {
+            std::vector<ESBTL::Default_system> systems;
+            ESBTL::PDB_line_selector sel;
+            ESBTL::All_atom_system_builder<ESBTL::Default_system> builder(systems, sel.max_nb_systems());
+            ESBTL::read_a_pdb_file<mode>(path, sel, builder, Occupancy_policy());
+            atoms = systems.empty() || systems[0].has_no_model() ? 0 : systems[0].models_begin()->number_of_atoms();
+        }
+    };
+
+    template<ESBTL::Reading_mode mode, class Occupancy_policy>
+    std::string readTime(const std::string &path)
+    {
+        ReadRun<mode, Occupancy_policy> task;
+        task.path = path;
+        double time = bestOf(task);
+        return ms(time) + " (" + ofToString(task.atoms) + " atoms)";
+    }
+
+    inline void benchOccupancy(Report &report, const std::string &path)
+    {
+        typedef ESBTL::PDB::Line_format<> Line_format;
+        typedef ESBTL::Accept_all_occupancy_policy<Line_format> All;
+        typedef ESBTL::Max_occupancy_policy<Line_format> Max;
+        typedef ESBTL::Min_occupancy_policy<Line_format> Min;
+
+        std::string partial = partiallyOccupiedPdb(path);
+        report.section("Occupancy policies on " + ofFile(partial).getFileName() + " (every other atom at 0.40 or 0.60)");
+        report.add("MMAP:  accept all " + readTime<ESBTL::MMAP, All>(partial)
+                   + ", max " + readTime<ESBTL::MMAP, Max>(partial)
+                   + ", min " + readTime<ESBTL::MMAP, Min>(partial));
+        report.add("ASCII: accept all " + readTime<ESBTL::ASCII, All>(partial)
+                   + ", max " + readTime<ESBTL::ASCII, Max>(partial)
+                   + ", min " + readTime<ESBTL::ASCII, Min>(partial));
+    }
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "Benchmark.h"
+
+// Sphere meshes of Model against the generators they replaced, which tessellated an
+// ofSpherePrimitive for every atom (see INSTANCED SPHERES in the README)
+namespace Benchmark
+{
+    //! Append the faces of sphere, moved to position, as the former generators did
+    inline void appendFaces(ofMesh &mesh, ofSpherePrimitive &sphere, const ofVec3f &position, const ofFloatColor *color)
+    {
+        std::vector<ofMeshFace> triangles = sphere.getMesh().getUniqueFaces();
+        for (size_t j=0; j<triangles.size(); j++)
+        {
+            for (int k=0; k<3; k++)
+            {
+                mesh.addVertex(triangles[j].getVertex(k) + position);
+                mesh.addNormal(triangles[j].getNormal(k));
+                if (color) mesh.addColor(*color);
+            }
+        }
+    }
+
+    //! Model::atomsMesh(resolution) before instancing
+    inline ofMesh perAtomMesh(OfxMol::Model &model, int resolution)
+    {
+        ofMesh mesh;
+        const OfxMol::AtomArrays &arrays = model.arrays();
+        for (size_t i=0; i<arrays.size(); i++)
+        {
+            ofSpherePrimitive sphere;
+            sphere.setResolution(resolution);
+            sphere.setRadius(arrays.radius[i]);
+            sphere.setPosition(arrays.position(i));
+            appendFaces(mesh, sphere, arrays.position(i), NULL);
+        }
+        return mesh;
+    }
+
+    //! Model::coarseAtomsMesh(resolution) before instancing
+    inline ofMesh perCoarseAtomMesh(OfxMol::Model &model, int resolution)
+    {
+        ofMesh mesh;
+        mesh.enableColors();
+        for (OfxMol::Model::Coarse_atoms_iterator atm=model.coarse_atoms_begin(); atm!=model.coarse_atoms_end(); ++atm)
+        {
+            ofSpherePrimitive sphere = atm->sphere(resolution);
+            // the former updateMesh took an ofColor: 8 bits colors
+            ofFloatColor color = ofColor(atm->getColor());
+            appendFaces(mesh, sphere, atm->position(), &color);
+        }
+        return mesh;
+    }
+
+    //! Bytes held by the arrays of a mesh
+    inline size_t meshBytes(ofMesh &mesh)
+    {
+        return (mesh.getVertices().capacity() + mesh.getNormals().capacity()) * sizeof(ofVec3f)
+            + mesh.getColors().capacity() * sizeof(ofFloatColor) + mesh.getIndices().capacity() * sizeof(ofIndexType);
+    }
+
+    //! Largest difference between the attributes of two meshes, "identical" if there is none
+    inline std::string compare(ofMesh &a, ofMesh &b)
+    {
+        if (a.getNumVertices() != b.getNumVertices() || a.getNumNormals() != b.getNumNormals() || a.getNumColors() != b.getNumColors())
+        {
+            return "DIFFERENT SIZES";
+        }
+        float difference = 0;
+        for (size_t i=0; i<a.getNumVertices(); i++)
+        {
+            difference = std::max(difference, a.getVertices()[i].distance(b.getVertices()[i]));
+            difference = std::max(difference, a.getNormals()[i].distance(b.getNormals()[i]));
+        }
+        for (size_t i=0; i<a.getNumColors(); i++)
+        {
+            const ofFloatColor &x = a.getColors()[i];
+            const ofFloatColor &y = b.getColors()[i];
+            difference = std::max(difference, std::max(std::max(fabsf(x.r - y.r), fabsf(x.g - y.g)), std::max(fabsf(x.b - y.b), fabsf(x.a - y.a))));
+        }
+        return difference == 0 ? "identical" : "differ by up to " + ofToString(difference);
+    }
+
+    struct SphereRun
+    {
+        OfxMol::Model *model;
+        int resolution;
+        bool coarse;
+        bool former;
+        ofMesh mesh;
+
+        void operator()()
+        {
+            if (former)
+                mesh = coarse ? perCoarseAtomMesh(*model, resolution) : perAtomMesh(*model, resolution);
+            else
+                mesh = coarse ? model->coarseAtomsMesh(resolution) : model->atomsMesh(resolution);
+        }
+    };
+
+    inline void benchSphereMeshes(Report &report, const std::string &path)
+    {
+        report.section("Sphere meshes of " + ofFile(path).getFileName() + ": per-atom ofSpherePrimitive, and current generators");
+
+        OfxMol::System system;
+        system.setup(path, OfxMol::SIMPLE, false);
+
+        const int RESOLUTIONS[] = {8, 16, 24};
+        for (int r=0; r<3; r++)
+        {
+            for (int coarse=0; coarse<2; coarse++)
+            {
+                SphereRun former = {&system.getModel(0), RESOLUTIONS[r], coarse == 1, true, ofMesh()};
+                SphereRun current = {&system.getModel(0), RESOLUTIONS[r], coarse == 1, false, ofMesh()};
+                double formerTime = bestOf(former);
+                double currentTime = bestOf(current);
+
+                OfxMol::SphereInstances instances = coarse ? system.getModel(0).coarseAtomsInstances(RESOLUTIONS[r])
+                                                           : system.getModel(0).atomsInstances(RESOLUTIONS[r]);
+                size_t instancesBytes = instances.instances().capacity() * sizeof(OfxMol::SphereInstance);
+
+                report.add("resolution " + ofToString(RESOLUTIONS[r]) + (coarse ? " coarseAtomsMesh: " : " atomsMesh: ")
+                           + ms(formerTime) + " " + mb(meshBytes(former.mesh)) + " -> "
+                           + ms(currentTime) + " " + mb(meshBytes(current.mesh))
+                           + ", instances " + mb(instancesBytes) + ", meshes " + compare(former.mesh, current.mesh));
+            }
+        }
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol.h"
+
+#include <fstream>
+#include <sys/stat.h>
+#if defined(TARGET_OSX)
+#include <malloc/malloc.h>
+#elif defined(TARGET_LINUX)
+#include <malloc.h>
+#endif
+
+// Helpers shared by the benchmarks (Bench*.h)
+namespace Benchmark
+{
+    //! Runs of each timed task, the best one is reported
+    const int RUNS = 5;
+
+    //! Lines of the report, logged and saved to a file
+    class Report
+    {
+    public:
+        void section(const std::string &title)
+        {
+            add("");
+            add("## " + title);
+        }
+
+        void add(const std::string &line)
+        {
+            ofLogNotice("Benchmarks") << line;
+            lines.push_back(line);
+        }
+
+        bool save(const std::string &path) const
+        {
+            std::ofstream file(path.c_str());
+            for (size_t i=0; i<lines.size(); i++) file << lines[i] << "\n";
+            return file.good();
+        }
+
+    private:
+        std::vector<std::string> lines;
+    };
+
+    //! Best time in ms of RUNS calls to task(), task being a function object
+    template<class Task>
+    double bestOf(Task &task, int runs = RUNS)
+    {
+        double best = 0;
+        for (int i=0; i<runs; i++)
+        {
+            unsigned long long start = ofGetElapsedTimeMicros();
+            task();
+            double ms = (ofGetElapsedTimeMicros() - start) / 1000.0;
+            if (i == 0 || ms < best) best = ms;
+        }
+        return best;
+    }
+
+    inline std::string ms(double value)
+    {
+        return ofToString(value, 2) + " ms";
+    }
+
+    inline std::string mb(double bytes)
+    {
+        return ofToString(bytes / (1024 * 1024), 2) + " MB";
+    }
+
+    //! Bytes allocated on the heap, 0 where it can not be measured
+    inline size_t heapBytes()
+    {
+#if defined(TARGET_OSX)
+        return mstats().bytes_used;
+#elif defined(TARGET_LINUX) && defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        struct mallinfo2 info = mallinfo2();
+        return info.uordblks + info.hblkhd;
+#elif defined(TARGET_LINUX)
+        struct mallinfo info = mallinfo();
+        return (size_t)(unsigned int) info.uordblks + (size_t)(unsigned int) info.hblkhd;
+#else
+        return 0;
+#endif
+    }
+
+    inline size_t fileSize(const std::string &path)
+    {
+        struct stat st;
+        return ::stat(path.c_str(), &st) == 0 ? st.st_size : 0;
+    }
+
+    //! Write copies of the ATOM and HETATM records of source in a grid, spacing angstroms apart.
+    //! Each copy gets its own chain (or its residues are renumbered), so that no two atoms share
+    //! a chain, residue and name. The file is kept between runs (up to 124 copies of a single chain file).
+    inline std::string tiledPdb(const std::string &source, int copies, float spacing = 100.0f)
+    {
+        static const char CHAINS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+        const int NB_CHAINS = sizeof(CHAINS) - 1;
+
+        std::string path = source.substr(0, source.rfind('.')) + "x" + ofToString(copies) + ".pdb";
+        if (fileSize(path) > 0) return path;
+
+        std::vector<std::string> records;
+        std::ifstream in(source.c_str());
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.size() >= 54 && (line.compare(0, 6, "ATOM  ") == 0 || line.compare(0, 6, "HETATM") == 0))
+                records.push_back(line);
+        }
+
+        int side = 1;
+        while (side * side * side < copies) side++;
+
+        std::ofstream out(path.c_str());
+        char field[16];
+        int serial = 0;
+        for (int k=0; k<copies; k++)
+        {
+            float offset[3] = {spacing * (k % side), spacing * ((k / side) % side), spacing * (k / (side * side))};
+            for (size_t i=0; i<records.size(); i++)
+            {
+                std::string record = records[i];
+                snprintf(field, sizeof(field), "%5d", serial++ % 99999 + 1);
+                record.replace(6, 5, field);
+                record[21] = CHAINS[k % NB_CHAINS];
+                snprintf(field, sizeof(field), "%4d", ofToInt(record.substr(22, 4)) + 4000 * (k / NB_CHAINS));
+                record.replace(22, 4, field);
+                for (int c=0; c<3; c++)
+                {
+                    snprintf(field, sizeof(field), "%8.3f", ofToFloat(record.substr(30 + 8*c, 8)) + offset[c]);
+                    record.replace(30 + 8*c, 8, field);
+                }
+                out << record << "\n";
+            }
+        }
+        out << "END\n";
+        return path;
+    }
+
+    //! Copy of a PDB file where every other ATOM or HETATM record is partially occupied (0.40 or 0.60)
+    inline std::string partiallyOccupiedPdb(const std::string &source)
+    {
+        std::string path = source.substr(0, source.rfind('.')) + "_partial.pdb";
+        if (fileSize(path) > 0) return path;
+
+        std::ifstream in(source.c_str());
+        std::ofstream out(path.c_str());
+        std::string line;
+        size_t n = 0;
+        while (std::getline(in, line))
+        {
+            if (line.size() >= 60 && (line.compare(0, 6, "ATOM  ") == 0 || line.compare(0, 6, "HETATM") == 0) && n++ % 2 == 1)
+            {
+                line.replace(54, 6, n % 4 == 0 ? "  0.40" : "  0.60");
+            }
+            out << line << "\n";
+        }
+        return path;
+    }
+}
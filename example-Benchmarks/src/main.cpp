@@ -0,0 +1,14 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "ofApp.h"
+
+//========================================================================
+int main( ){
+	// the benchmarks need no window
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, 1024,768, OF_WINDOW);
+
+	// runs the benchmarks in setup, then exits
+	ofRunApp(new ofApp());
+
+}
@@ -0,0 +1,29 @@
+#include "ofApp.h"
+#include "BenchCache.h"
+#include "BenchOccupancy.h"
+#include "BenchFlatSystem.h"
+#include "BenchMeshBuilder.h"
+#include "BenchSphereMeshes.h"
+#include "BenchClassifier.h"
+
+//--------------------------------------------------------------
+void ofApp::setup()
+{
+    Benchmark::Report report;
+    report.add("# ofxMol benchmarks");
+    
+    // 2WY4 (1340 atoms) and 75 copies of it (100500 atoms)
+    std::vector<std::string> paths;
+    paths.push_back(ofToDataPath("2WY4.pdb"));
+    paths.push_back(Benchmark::tiledPdb(paths[0], 75));
+    
+    Benchmark::benchCache(report, paths);
+    Benchmark::benchOccupancy(report, paths[1]);
+    Benchmark::benchFlatSystem(report, paths[1]);
+    Benchmark::benchMeshBuilder(report, paths[1]);
+    Benchmark::benchSphereMeshes(report, paths[0]);
+    Benchmark::benchClassifier(report, paths[1]);
+    
+    report.save(ofToDataPath("benchmarks.txt"));
+    ofExit();
+}
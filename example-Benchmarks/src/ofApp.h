@@ -0,0 +1,12 @@
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol.h"
+
+// Runs the benchmarks, logs them and saves them to bin/data/benchmarks.txt
+class ofApp : public ofBaseApp
+{
+    
+public:
+    void setup();
+};
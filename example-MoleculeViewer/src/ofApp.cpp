@@ -45,22 +45,47 @@ void ofApp::setup()
     pointLightRight.setDiffuseColor( ofFloatColor(.35, .35, .85) );
     pointLightRight.setSpecularColor( ofFloatColor(1.f, 1.f, 1.f));
 
-    loadMolecule(pdbFiles[currentFile]);
+    std::vector<std::string> paths;
+    for (std::vector<ofFile>::iterator fit=pdbFiles.begin(); fit!=pdbFiles.end(); ++fit)
+    {
+        paths.push_back(fit->path());
+    }
+    prefetcher.setMeshes(8, 1.0f, 16);
+    prefetcher.setup(paths, OfxMol::ADVANCED, 1);
+    loadMolecule(currentFile);
 }
 
 //--------------------------------------------------------------
 void ofApp::update()
 {
     ofSetWindowTitle(ofToString(pdbFiles[currentFile].getFileName()));
+    
+    // swap the meshes once the current file is ready
+    if (!molecule || molecule->path != pdbFiles[currentFile].path())
+    {
+        ofPtr<OfxMol::PrefetchedSystem> ready = prefetcher.get(currentFile);
+        if (ready)
+        {
+            molecule = ready;
+            applyColorScheme();
+        }
+    }
 }
 
-void ofApp::loadMolecule(ofFile file)
+void ofApp::loadMolecule(int i)
 {
-    system.setup(file.path(), OfxMol::ADVANCED);
-    cAtmMesh = system.getModel(0).coarseAtomsMesh(8);
-    atoms = system.getModel(0).atomsMesh(1.0f);
-    atomsCloud = system.getModel(0).atomsPointCloud();
-    backbone = system.getModel(0).backbonePoly();
+    prefetcher.setCurrent(i);
+}
+
+// only the colors of the point cloud change, the meshes are not rebuilt
+void ofApp::applyColorScheme()
+{
+    if (molecule && molecule->system.number_of_models() > 0)
+    {
+        OfxMol::Model &model = molecule->system.getModel(0);
+        colorScheme.apply(model);
+        molecule->atomsPointCloud.getColors() = model.arrays().color;
+    }
 }
 
 //--------------------------------------------------------------
@@ -83,26 +108,26 @@ void ofApp::draw()
     ofPushMatrix();
     ofTranslate(0.0f, 0.0f,0.0f);
     
-    if (bCoarseAtomsMesh)
+    if (molecule && bCoarseAtomsMesh)
     {
-        cAtmMesh.draw();
+        molecule->coarseAtomsMesh.draw();
     }
     
-    if (bAtomsPointCloud)
+    if (molecule && bAtomsPointCloud)
     {
         glPointSize(24.0);
-        atomsCloud.drawVertices();
+        molecule->atomsPointCloud.drawVertices();
     }
     
-    if (bAtoms)
+    if (molecule && bAtoms)
     {
-        atoms.draw();
+        molecule->atomsMesh.draw();
     }
     
-    if (bBackbone)
+    if (molecule && bBackbone)
     {
         glLineWidth(4.0f);
-        backbone.draw();
+        molecule->backbone.draw();
     }
     
     ofPopMatrix();
@@ -126,6 +151,7 @@ void ofApp::draw()
         msg += "atoms point cloud [2] : " + ofToString(bAtomsPointCloud ? "YES" : "NO") + "\n";
         msg += "atoms spheres [3] : " + ofToString(bAtoms ? "YES" : "NO") + "\n";
         msg += "backbone [4] : " + ofToString(bBackbone ? "YES" : "NO") + "\n";
+        msg += "point cloud colors [5] : " + colorScheme.getName() + "\n";
         msg += "\n\nLEFT MOUSE BUTTON DRAG:\nStart dragging INSIDE the yellow circle -> camera XY rotation .\nStart dragging OUTSIDE the yellow circle -> camera Z rotation (roll).\n\n";
         msg += "LEFT MOUSE BUTTON DRAG + TRANSLATION KEY (" + ofToString(cam.getTranslationKey()) + ") PRESSED\n";
         msg += "OR MIDDLE MOUSE BUTTON (if available):\n";
@@ -134,6 +160,13 @@ void ofApp::draw()
         msg += "move over Z axis (dolly)";
     }
     
+    if (!molecule || molecule->path != pdbFiles[currentFile].path())
+    {
+        msg += "\n\nLoading " + pdbFiles[currentFile].getFileName() + "...";
+    }
+    msg += "\n\nprefetch: " + ofToString(prefetcher.getHits()) + " hits, " + ofToString(prefetcher.getMisses()) + " misses, ";
+    msg += ofToString(prefetcher.getUsedBytes() / (1024 * 1024)) + " MB";
+    
     msg += "\n\nfps: " + ofToString(ofGetFrameRate(), 2);
     ofDrawBitmapStringHighlight(msg, 10, 20);
 
@@ -189,6 +222,10 @@ void ofApp::keyPressed(int key)
         case '4':
             bBackbone ^=true;
             break;
+        case '5':
+            colorScheme = OfxMol::ColorScheme(OfxMol::ColorScheme::Type((colorScheme.getType() + 1) % (OfxMol::ColorScheme::UNIFORM + 1)));
+            applyColorScheme();
+            break;
             
         case OF_KEY_LEFT:
             currentFile--;
@@ -196,7 +233,7 @@ void ofApp::keyPressed(int key)
             {
                 currentFile = 0;
             }
-            loadMolecule(pdbFiles[currentFile]);
+            loadMolecule(currentFile);
             break;
         case OF_KEY_RIGHT:
             currentFile++;
@@ -204,7 +241,7 @@ void ofApp::keyPressed(int key)
             {
                 currentFile = pdbFiles.size()-1;
             }
-            loadMolecule(pdbFiles[currentFile]);
+            loadMolecule(currentFile);
             break;
     }
 }
@@ -24,7 +24,8 @@ public:
     void gotMessage(ofMessage msg);
     void drawInteractionArea();
     
-    void loadMolecule(ofFile file);
+    void loadMolecule(int i);
+    void applyColorScheme();
     
 protected:
     bool bShowHelp;
@@ -38,11 +39,10 @@ protected:
     ofLight pointLightRight;
     ofMaterial material;
 
-    OfxMol::System system;
-    ofMesh cAtmMesh;
-    ofMesh atomsCloud;
-    ofMesh atoms;
-    ofPolyline backbone;
+    // the previous and next files are loaded in background
+    OfxMol::SystemPrefetcher prefetcher;
+    ofPtr<OfxMol::PrefetchedSystem> molecule;
+    OfxMol::ColorScheme colorScheme;
     
     ofDirectory dataDir;
     std::vector<ofFile> pdbFiles;
@@ -38,11 +38,14 @@
 
 #include<boost/lexical_cast.hpp>
 #include <boost/algorithm/string.hpp>
-#include <boost/format.hpp>
 #include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
 #include <iostream>
 #include <typeinfo>
 #include <ESBTL/constants.h>
+#include <ESBTL/line_span.h>
 
 
 
@@ -57,10 +60,104 @@
       }\
     }\
     return PDB::extract_field<TYPE>(line,FROM,TO,DEF,#FNAME,Mandatory_fields::FNAME); \
+  }\
+  TYPE get_##FNAME(const Line_span& line) const { \
+    if (line.length() < TO){\
+      if (! Mandatory_fields::FNAME) return TYPE(DEF);\
+      else{\
+          std::cerr << "Fatal error: Cannot extract field \'" << #FNAME << "\' in \n";\
+          std::cerr << "<|" << line << "|>\n";\
+          exit (EXIT_FAILURE);\
+      }\
+    }\
+    return PDB::extract_field<TYPE>(line,FROM,TO,DEF,#FNAME,Mandatory_fields::FNAME); \
+  }
+
+#define RECOVER_PARSED_FIELD(FNAME,TYPE) \
+  TYPE get_##FNAME(const PDB::Parsed_line& line) const { \
+    if (line.is_parsed(PDB::Parsed_line::FNAME##_field)) return line.FNAME; \
+    return get_##FNAME(line.span()); \
+  }
+
+#define FORWARD_FIELD(FNAME,TYPE) \
+  TYPE get_##FNAME(const PDB::Parsed_line& line) const { \
+    return get_##FNAME(line.span()); \
   }
   
 
 namespace ESBTL{
+  
+/** \cond */
+namespace internal{
+  
+  //formatting of the fields of a PDB line, with the output of printf
+  
+  //%<width>d
+  inline void append_integer(std::string& out,int value,int width){
+    char digits[16];
+    int n=0;
+    unsigned int u=value<0 ? 0u-static_cast<unsigned int>(value) : static_cast<unsigned int>(value);
+    do{
+      digits[n++]=static_cast<char>('0'+u%10);
+      u/=10;
+    }while(u!=0);
+    int length=n+(value<0?1:0);
+    if (length<width) out.append(width-length,' ');
+    if (value<0) out+='-';
+    while (n!=0) out+=digits[--n];
+  }
+  
+  //%<width>s
+  inline void append_string(std::string& out,const std::string& value,int width){
+    std::size_t length=strlen(value.c_str());
+    if (length<static_cast<std::size_t>(width)) out.append(width-length,' ');
+    out.append(value.c_str(),length);
+  }
+  
+  inline void append_string(std::string& out,const Name& value,int width){
+    std::size_t length=value.size();
+    if (length<static_cast<std::size_t>(width)) out.append(width-length,' ');
+    for (std::size_t i=0;i!=length;++i) out+=value[i];
+  }
+  
+  //%<width>.<precision>f, with precision<=3
+  inline void append_fixed(std::string& out,double value,int width,int precision){
+    static const double scales[]={1.,10.,100.,1000.};
+    double scaled=std::fabs(value)*scales[precision];
+    double integral=std::floor(scaled);
+    double fraction=scaled-integral;
+    //the exact binary value decides of the rounding: let printf handle values close to a tie
+    //(and very large or non finite values)
+    if ( !(std::fabs(value)<1e6) || std::fabs(fraction-0.5)<1e-6 ){
+      char tmp[512];
+      int n=snprintf(tmp,sizeof(tmp),"%*.*f",width,precision,value);
+      out.append(tmp,n);
+      return;
+    }
+    unsigned long rounded=static_cast<unsigned long>(integral)+(fraction>0.5?1:0);
+    
+    char digits[32];
+    int n=0;
+    for (int i=0;i<precision;++i){
+      digits[n++]=static_cast<char>('0'+rounded%10);
+      rounded/=10;
+    }
+    if (precision!=0) digits[n++]='.';
+    do{
+      digits[n++]=static_cast<char>('0'+rounded%10);
+      rounded/=10;
+    }while(rounded!=0);
+    //like printf, -0.000 for negative values rounded to zero
+    bool negative=value<0 || (value==0 && 1./value<0);
+    int length=n+(negative?1:0);
+    if (length<width) out.append(width-length,' ');
+    if (negative) out+='-';
+    while (n!=0) out+=digits[--n];
+  }
+  
+} //namespace internal
+/** \endcond */
+  
   namespace PDB{
   /** Enumeration of the type of a line read in a PDB file.*/
   enum Record_type{ATOM=0,HETATM,MODEL,ENDMDL,TER,END,ANISOU,CONECT,MASTER,UNKNOWN};
@@ -89,8 +186,161 @@ namespace ESBTL{
         exit (EXIT_FAILURE);
       }
   }
+  
+  //names are built from the characters of the field: a stream would stop at the
+  //inner spaces of names such as "C 1"
+  template<>
+  inline Name extract_field<Name>(const std::string& line,unsigned from, unsigned to,Name default_value,const char* name,bool is_mandatory){
+    const char* begin=line.data()+from;
+    const char* end=line.data()+ (line.length()<to+1?line.length():to+1);
+    internal::trim_span(begin,end);
+    if (begin==end){
+      if (!is_mandatory)
+        return default_value;
+      std::cerr << "Fatal error: field \'"<< name << "\' is empty in \n";
+      std::cerr  << "<|" << line << "|>\n";
+      exit (EXIT_FAILURE);
+    }
+    Name value;
+    if (!internal::parse_field(begin,end,value)){
+      std::cerr << "Fatal error: Cannot convert \'"<< std::string(begin,end) << "\' to a name in line\n";
+      std::cerr  << "<|" << line << "|>\n";
+      exit (EXIT_FAILURE);
+    }
+    return value;
+  }
+  
+  //version working in place on a line that is not copied: the field is
+  //converted using hand-written parsers, and only the unusual cases
+  //(exponent, malformed field...) go through the std::string version above.
+  template<class T>
+  T extract_field(const Line_span& line,unsigned from, unsigned to,T default_value,const char* name,bool is_mandatory=false){
+    const char* begin=line.begin()+from;
+    const char* end=line.begin()+ (line.length()<to+1?line.length():to+1);
+    internal::trim_span(begin,end);
+    if (begin==end){
+      if (!is_mandatory)
+        return default_value;
+    }
+    else{
+      T value;
+      if (internal::parse_field(begin,end,value))
+        return value;
+    }
+    return extract_field<T>(line.str(),from,to,default_value,name,is_mandatory);
+  }
+  
+  //same as extract_field, but never fails: returns false if the field cannot be
+  //converted with the hand-written parsers (or is missing or empty).
+  template<class T>
+  bool try_extract_field(const Line_span& line,unsigned from, unsigned to,T& value){
+    if (line.length() < to) return false;
+    const char* begin=line.begin()+from;
+    const char* end=line.begin()+ (line.length()<to+1?line.length():to+1);
+    internal::trim_span(begin,end);
+    return begin!=end && internal::parse_field(begin,end,value);
+  }
+  
+  inline Record_type record_type_of(const char* line,std::size_t length){
+    Record_type type=UNKNOWN;
+    if (internal::line_starts_with(line,length,"ATOM",4))    type=ATOM;
+    if (internal::line_starts_with(line,length,"HETATM",6))  type=HETATM;
+    if (internal::line_starts_with(line,length,"MODEL",5))   type=MODEL;
+    if (internal::line_starts_with(line,length,"ENDMDL",6))  type=ENDMDL;
+    if (internal::line_starts_with(line,length,"TER",3))     type=TER;
+    if (internal::line_starts_with(line,length,"END",3))     type=END;
+    if (internal::line_starts_with(line,length,"ANISOU",6))  type=ANISOU;
+    if (internal::line_starts_with(line,length,"CONECT",6))  type=CONECT;
+    if (internal::line_starts_with(line,length,"MASTER",6))  type=MASTER;
+    return type;
+  }
   /** \endcond */
   
+  /**
+    * A line of a PDB file whose numerical fields have been converted in advance
+    * (by a worker thread of ESBTL::Parallel_line_reader for example).
+    * ESBTL::PDB::Line_format accepts such a line in place of a \c std::string: converted fields
+    * are returned directly, other fields are extracted from the line.
+    * Conversion never fails: a field that is missing or malformed is simply not marked as parsed,
+    * and ESBTL::PDB::Line_format reports the error (or uses the default value) when the field is queried.
+    * The columns used are those of ESBTL::PDB::Line_format.
+    */
+  class Parsed_line{
+    Line_span span_;
+    unsigned parsed_;
+  public:
+    enum Field{
+      atom_serial_number_field=1,
+      alternate_location_field=2,
+      chain_identifier_field=4,
+      residue_sequence_number_field=8,
+      insertion_code_field=16,
+      x_field=32,
+      y_field=64,
+      z_field=128,
+      occupancy_field=256,
+      temperature_factor_field=512,
+      model_number_field=1024,
+      atom_name_field=2048,
+      residue_name_field=4096,
+      element_field=8192
+    };
+    
+    Record_type type;
+    int atom_serial_number;
+    char alternate_location;
+    char chain_identifier;
+    char insertion_code;
+    int residue_sequence_number;
+    double x,y,z;
+    double occupancy;
+    double temperature_factor;
+    int model_number;
+    Name atom_name;
+    Name residue_name;
+    Name element;
+    
+    Parsed_line(const Line_span& line):span_(line),parsed_(0),type(record_type_of(line.data(),line.length())){
+      if (type==ATOM || type==HETATM){
+        parse(6,10,atom_serial_number,atom_serial_number_field);
+        parse(12,15,atom_name,atom_name_field);
+        parse(16,16,alternate_location,alternate_location_field);
+        parse(17,19,residue_name,residue_name_field);
+        parse(21,21,chain_identifier,chain_identifier_field);
+        parse(22,25,residue_sequence_number,residue_sequence_number_field);
+        parse(26,26,insertion_code,insertion_code_field);
+        parse(30,37,x,x_field);
+        parse(38,45,y,y_field);
+        parse(46,53,z,z_field);
+        parse(54,59,occupancy,occupancy_field);
+        parse(60,65,temperature_factor,temperature_factor_field);
+        parse(76,77,element,element_field);
+      }
+      else
+        if (type==MODEL)
+          parse(10,13,model_number,model_number_field);
+    }
+    
+    /** Copy of a line with the converted fields of \c other, \c line being a copy of the line of \c other.*/
+    Parsed_line(const Parsed_line& other,const Line_span& line){
+      *this=other;
+      span_=line;
+    }
+    
+    const Line_span& span() const {return span_;}
+    bool is_parsed(Field f) const {return (parsed_ & f)!=0;}
+    
+  private:
+    template <class T>
+    void parse(unsigned from,unsigned to,T& value,Field f){
+      if (try_extract_field(span_,from,to,value)) parsed_|=f;
+    }
+  };
+  
+  inline std::ostream& operator<<(std::ostream& os,const Parsed_line& line){
+    return os << line.span();
+  }
+  
   /** Default class to specify to ESBTL::PDB::Line_format which PDB fields of a coordinate line are mandatory.*/
   struct Mandatory_fields_default{
     static const bool record_name=true;
@@ -120,6 +370,10 @@ namespace ESBTL{
   class Line_format{
   private:  
     PDB::Record_type type;
+    
+    void init(const char* line,std::size_t length){
+      type=PDB::record_type_of(line,length);
+    }
 
   public:
     //Easy to do with a MACRO
@@ -127,27 +381,30 @@ namespace ESBTL{
       *\param line is a line of a PDB file.
       */
     Line_format(const std::string& line){
-      type=PDB::UNKNOWN;
-      if (strncmp(line.c_str(),"ATOM",4)==0)    type=PDB::ATOM;
-      if (strncmp(line.c_str(),"HETATM",6)==0)  type=PDB::HETATM;
-      if (strncmp(line.c_str(),"MODEL",5)==0)   type=PDB::MODEL;
-      if (strncmp(line.c_str(),"ENDMDL",6)==0)  type=PDB::ENDMDL;
-      if (strncmp(line.c_str(),"TER",3)==0)     type=PDB::TER;
-      if (strncmp(line.c_str(),"END",3)==0)     type=PDB::END;
-      if (strncmp(line.c_str(),"ANISOU",6)==0)  type=PDB::ANISOU;
-      if (strncmp(line.c_str(),"CONECT",6)==0)  type=PDB::CONECT;
-      if (strncmp(line.c_str(),"MASTER",6)==0)  type=PDB::MASTER;
+      init(line.c_str(),line.length());
     }
     
+    /** Constructor.
+      *\param line is a line of a PDB file that is not copied (read from a memory-mapped file for example).
+      */
+    Line_format(const Line_span& line){
+      init(line.data(),line.length());
+    }
+    
+    /** Constructor.
+      *\param line is a line of a PDB file whose numerical fields are already converted.
+      */
+    Line_format(const PDB::Parsed_line& line):type(line.type){}
+    
     /** Indicates whether the line read is a coordinate line of an hetero-atom.*/
     bool is_hetatm() const {return (type==PDB::HETATM);}
     
     //ATOM and HETATM fields
     RECOVER_FIELD(record_name,std::string,0,5," ")
     RECOVER_FIELD(atom_serial_number,int,6,10,-1)
-    RECOVER_FIELD(atom_name,std::string,12,15," ")
+    RECOVER_FIELD(atom_name,Name,12,15," ")
     RECOVER_FIELD(alternate_location,char,16,16,' ')
-    RECOVER_FIELD(residue_name,std::string,17,19," ")
+    RECOVER_FIELD(residue_name,Name,17,19," ")
     RECOVER_FIELD(chain_identifier,char,21,21,' ')
     RECOVER_FIELD(residue_sequence_number,int,22,25,-1)
     RECOVER_FIELD(insertion_code,char,26,26,' ')
@@ -156,12 +413,30 @@ namespace ESBTL{
     RECOVER_FIELD(z,double,46,53,NO_FLOAT)
     RECOVER_FIELD(occupancy,double,54,59,NO_FLOAT)
     RECOVER_FIELD(temperature_factor,double,60,65,NO_FLOAT)
-    RECOVER_FIELD(element,std::string,76,77," ")
+    RECOVER_FIELD(element,Name,76,77," ")
     /** extract the field charge as a string. */
     RECOVER_FIELD(charge_str,std::string,78,79," ")
     
+    //pre-converted fields of a PDB::Parsed_line
+    FORWARD_FIELD(record_name,std::string)
+    RECOVER_PARSED_FIELD(atom_serial_number,int)
+    RECOVER_PARSED_FIELD(atom_name,Name)
+    RECOVER_PARSED_FIELD(alternate_location,char)
+    RECOVER_PARSED_FIELD(residue_name,Name)
+    RECOVER_PARSED_FIELD(chain_identifier,char)
+    RECOVER_PARSED_FIELD(residue_sequence_number,int)
+    RECOVER_PARSED_FIELD(insertion_code,char)
+    RECOVER_PARSED_FIELD(x,double)
+    RECOVER_PARSED_FIELD(y,double)
+    RECOVER_PARSED_FIELD(z,double)
+    RECOVER_PARSED_FIELD(occupancy,double)
+    RECOVER_PARSED_FIELD(temperature_factor,double)
+    RECOVER_PARSED_FIELD(element,Name)
+    FORWARD_FIELD(charge_str,std::string)
+    
     /** extract the field charge as an integer. */
-    int get_charge(const std::string& line) const {
+    template <class Line>
+    int get_charge(const Line& line) const {
       std::string charge_str=get_charge_str(line);
       if (charge_str==" ")
         return NO_CHARGE;
@@ -177,14 +452,12 @@ namespace ESBTL{
             }
           }
         }
-        try{
-          return ch*boost::lexical_cast<int>(charge_str[0]);
-        }
-        catch(boost::bad_lexical_cast &){
+        if (charge_str[0]<'0' || charge_str[0]>'9'){
           std::cerr << "Fatal error: Cannot convert \'"<< charge_str[0] << "\' to " << typeid(int).name() << " in line\n";
           std::cerr  << "<|" << line << "|>\n";
           exit (EXIT_FAILURE);          
         }
+        return ch*(charge_str[0]-'0');
       }
     }
     
@@ -193,6 +466,7 @@ namespace ESBTL{
     
     //MODEL fields
     RECOVER_FIELD(model_number,int,10,13,-1)
+    RECOVER_PARSED_FIELD(model_number,int)
     
     
     PDB::Record_type record_type() const{
@@ -202,80 +476,112 @@ namespace ESBTL{
   };  
   
 
+  /** Appends the identification fields of an atom (serial number to insertion code) to a string.*/
+  template<class PDB_Atom>
+  void
+  append_atom_pdb_reduced_format(std::string& out,const PDB_Atom& atom)
+  {
+    internal::append_integer(out,atom.atom_serial_number(),5);
+    out+=' ';
+    internal::append_string(out,atom.atom_name(),4);
+    out+=atom.alternate_location();
+    internal::append_string(out,atom.residue_name(),3);
+    out+=' ';
+    out+=atom.chain_identifier();
+    internal::append_integer(out,atom.residue_sequence_number(),4);
+    out+=atom.insertion_code();
+  }
+  
+  /** Appends the PDB line of an atom (without end of line) to a string.
+    * Unlike get_atom_pdb_format, no memory is allocated once the capacity of the string is large enough.
+    */
+  template<class PDB_Atom>
+  void
+  append_atom_pdb_format(std::string& out,const PDB_Atom& atom)
+  {
+    out.append( !atom.is_hetatm() ? "ATOM  ":"HETATM" ,6);
+    append_atom_pdb_reduced_format(out,atom);
+    out.append(3,' ');
+    internal::append_fixed(out,atom.x(),8,3);
+    internal::append_fixed(out,atom.y(),8,3);
+    internal::append_fixed(out,atom.z(),8,3);
+    internal::append_fixed(out,atom.occupancy(),6,2);
+    internal::append_fixed(out,atom.temperature_factor(),6,2);
+    out.append(10,' ');
+    internal::append_string(out,atom.element(),2);
+    if (atom.charge()==NO_CHARGE) out.append(2,' ');
+    else{
+      //"% 2i"
+      if (atom.charge()>=0) out+=' ';
+      internal::append_integer(out,atom.charge(),1);
+    }
+  }
+  
   template<class PDB_Atom>
   std::string 
   get_atom_pdb_format(const PDB_Atom& atom)
   {
-    std::stringstream buf(std::stringstream::out);
-    buf << ( !atom.is_hetatm() ? "ATOM  ":"HETATM" );
-    buf <<  boost::format("%5d %4s%c%3s %c%4d%c   %8.3f%8.3f%8.3f%6.2f%6.2f          %2s")
-            % atom.atom_serial_number()
-            % atom.atom_name().c_str()
-            % atom.alternate_location()
-            % atom.residue_name().c_str()
-            % atom.chain_identifier()
-            % atom.residue_sequence_number()
-            % atom.insertion_code()
-            % atom.x()
-            % atom.y()
-            % atom.z()
-            % atom.occupancy()
-            % atom.temperature_factor()
-            % atom.element().c_str();
-    if (atom.charge()==NO_CHARGE)   buf << "  ";
-    else buf << boost::format("% 2i") % atom.charge();
-    return buf.str();
+    std::string buf;
+    buf.reserve(80);
+    append_atom_pdb_format(buf,atom);
+    return buf;
   }
 
   template<class PDB_Atom>
   std::string 
   get_atom_pdb_reduced_format(const PDB_Atom& atom)
   {
-    std::stringstream buf(std::stringstream::out);
-    buf <<  boost::format("%5d %4s%c%3s %c%4d%c")
-            % atom.atom_serial_number()
-            % atom.atom_name().c_str()
-            % atom.alternate_location()
-            % atom.residue_name().c_str()
-            % atom.chain_identifier()
-            % atom.residue_sequence_number()
-            % atom.insertion_code();
-    return buf.str();
+    std::string buf;
+    buf.reserve(27);
+    append_atom_pdb_reduced_format(buf,atom);
+    return buf;
   }
   
 } //namespace PDB
 
+/** \cond */
+namespace internal{
+  inline std::string line_to_string(const PDB::Parsed_line& line){return line.span().str();}
+  inline const Line_span& line_to_span(const PDB::Parsed_line& line){return line.span();}
+  
+  //numerical fields of a line, converted once
+  inline PDB::Parsed_line to_parsed_line(const PDB::Parsed_line& line){return line;}
+  inline PDB::Parsed_line to_parsed_line(const Line_span& line){return PDB::Parsed_line(line);}
+  inline PDB::Parsed_line to_parsed_line(const std::string& line){return PDB::Parsed_line(line_to_span(line));}
+}
+/** \endcond */
+
 //global access functions
-  template <class Mandatory_fields>
-  bool get_is_hetatm(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.is_hetatm(p.second);}
-  template <class Mandatory_fields>
-  int get_atom_serial_number(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_atom_serial_number(p.second) ;}
-  template <class Mandatory_fields>
-  std::string get_atom_name(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_atom_name(p.second) ;}
-  template <class Mandatory_fields>
-  char get_alternate_location(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_alternate_location(p.second) ;}
-  template <class Mandatory_fields>
-  double get_occupancy(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_occupancy(p.second) ;}
-  template <class Mandatory_fields>
-  double get_temperature_factor(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_temperature_factor(p.second) ;}
-  template <class Mandatory_fields>
-  std::string get_element(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_element(p.second) ;}
-  template <class Mandatory_fields>
-  int get_charge(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_charge(p.second) ;}
-  template <class Mandatory_fields>
-  char get_chain_identifier(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_chain_identifier(p.second) ;}
-  template <class Mandatory_fields>
-  std::string get_residue_name(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_residue_name(p.second) ;}
-  template <class Mandatory_fields>
-  int get_residue_sequence_number(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_residue_sequence_number(p.second) ;}
-  template <class Mandatory_fields>
-  char get_insertion_code(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_insertion_code(p.second) ;}
-  template <class Mandatory_fields>
-  char get_x(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_x(p.second) ;}
-  template <class Mandatory_fields>
-  char get_y(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_y(p.second) ;}
-  template <class Mandatory_fields>
-  char get_z(const std::pair<PDB::Line_format<Mandatory_fields>,std::string>& p) {return p.first.get_z(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  bool get_is_hetatm(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.is_hetatm(p.second);}
+  template <class Mandatory_fields,class Line>
+  int get_atom_serial_number(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_atom_serial_number(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  Name get_atom_name(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_atom_name(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_alternate_location(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_alternate_location(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  double get_occupancy(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_occupancy(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  double get_temperature_factor(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_temperature_factor(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  Name get_element(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_element(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  int get_charge(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_charge(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_chain_identifier(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_chain_identifier(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  Name get_residue_name(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_residue_name(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  int get_residue_sequence_number(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_residue_sequence_number(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_insertion_code(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_insertion_code(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_x(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_x(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_y(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_y(p.second) ;}
+  template <class Mandatory_fields,class Line>
+  char get_z(const std::pair<PDB::Line_format<Mandatory_fields>,Line>& p) {return p.first.get_z(p.second) ;}
 } //namespace ESBTL
 
 #endif //ESBTL_PDB_H
@@ -40,10 +40,81 @@
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <ESBTL/name.h>
+#include <ESBTL/internal/perfect_hash_table.h>
 
 
 namespace ESBTL{
 
+/**
+  * The key identifying an atom type by its residue name and its atom name,
+  * used by the property classes of atoms.
+  * Both names are packed in a single integer, so that a key is built and hashed without memory allocation.
+  */
+class Atom_type_key{
+  boost::uint64_t id_;
+public:
+  Atom_type_key():id_(0){}
+  Atom_type_key(const Name& residue_name,const Name& atom_name):
+    id_( (static_cast<boost::uint64_t>(residue_name.id()) << 32) | atom_name.id() ){}
+  
+  Name residue_name() const {return Name::from_id(static_cast<boost::uint32_t>(id_ >> 32));}
+  Name atom_name() const {return Name::from_id(static_cast<boost::uint32_t>(id_));}
+  boost::uint64_t id() const {return id_;}
+};
+
+inline bool operator==(const Atom_type_key& k1,const Atom_type_key& k2){return k1.id()==k2.id();}
+inline bool operator!=(const Atom_type_key& k1,const Atom_type_key& k2){return k1.id()!=k2.id();}
+inline std::size_t hash_value(const Atom_type_key& k){return static_cast<std::size_t>(k.id() ^ (k.id() >> 29));}
+inline std::ostream& operator<<(std::ostream& os,const Atom_type_key& k){
+  return os << k.residue_name() << " " << k.atom_name();
+}
+
+/** \cond */
+namespace internal{
+
+//Index used by ESBTL::Generic_classifier to find the property of a key, once its dictionary is filled.
+//By default, the dictionary itself is searched.
+template <class Key_type>
+struct Property_index{
+  template <class Dictionary>
+  void build(const Dictionary&){}
+  
+  template <class Dictionary>
+  bool find(const Dictionary& dict,const Key_type& key,unsigned& index) const{
+    typename Dictionary::const_iterator it=dict.find(key);
+    if ( it==dict.end() ) return false;
+    index=it->second;
+    return true;
+  }
+};
+
+//Keys packing names in an integer are searched in a perfect hash table built from the dictionary.
+template <class Key_type>
+struct Integral_property_index{
+  template <class Dictionary>
+  void build(const Dictionary& dict){
+    std::vector<Perfect_hash_table::Entry> entries;
+    entries.reserve(dict.size());
+    for (typename Dictionary::const_iterator it=dict.begin();it!=dict.end();++it)
+      entries.push_back( Perfect_hash_table::Entry(it->first.id(),it->second) );
+    table_.build(entries);
+  }
+  
+  template <class Dictionary>
+  bool find(const Dictionary&,const Key_type& key,unsigned& index) const{
+    return table_.find(key.id(),index);
+  }
+private:
+  Perfect_hash_table table_;
+};
+
+template <> struct Property_index<Atom_type_key>:public Integral_property_index<Atom_type_key>{};
+template <> struct Property_index<Name>:public Integral_property_index<Name>{};
+
+} //namespace internal
+/** \endcond */
+
 /**
   * \defgroup prop_classif Property class
   * Concept of Property class to be given to ESBTL::Generic_classifier
@@ -101,7 +172,7 @@ public:
   /** The type on which the queries are made, */
   typedef Atom                  Query_type;
   /** The type of the hash key*/
-  typedef std::string           Key_type;
+  typedef Atom_type_key         Key_type;
   /** The number type of the property stored, here the radius.*/
   typedef NT                    Value_type;
   
@@ -146,9 +217,9 @@ public:
    * Function defining a unique identifier of an atom type.
    * @param atom is an atom.
    */
-  static std::string make_key(const Atom& atom)
+  static Key_type make_key(const Atom& atom)
   {
-    return atom.residue_name()+atom.atom_name();
+    return Key_type(atom.residue_name(),atom.atom_name());
   }
 
  /**
@@ -161,12 +232,12 @@ public:
   template <class Dictionary>
   static 
   unsigned add_classification(std::stringstream& ss,Dictionary& dict){
-    std::string resname,atmname;
+    Name resname,atmname;
     ss >> resname;
     ss >> atmname;
     unsigned prop;
     ss >> prop;
-    dict[resname+atmname]=prop;
+    dict[Key_type(resname,atmname)]=prop;
     return prop;
   }
   
@@ -221,7 +292,7 @@ private:
 public:
   
   typedef Atom                  Query_type;
-  typedef std::string           Key_type;
+  typedef Atom_type_key         Key_type;
   
 
   Name_and_radius_of_atom(const std::string& name_,const NT& radius_,const unsigned& index_):name(name_),index(index_),radius(radius_)
@@ -244,9 +315,9 @@ public:
     /** \endcond */
   }
   
-  static std::string make_key(const Atom& atom)
+  static Key_type make_key(const Atom& atom)
   {
-    return atom.residue_name()+atom.atom_name();
+    return Key_type(atom.residue_name(),atom.atom_name());
   }
   
   static
@@ -312,6 +383,8 @@ public:
 /**
   * An object that help to associate properties to objects.
   * This can be used for example to to associate a radius or a color to an (pseudo-)atom type.
+  * Once the properties are loaded, keys made of names (ESBTL::Atom_type_key, ESBTL::Name) are
+  * searched in a perfect hash table without memory allocation; other keys are searched in the dictionary.
   * \tparam Properties_ must follow the concept of \ref prop_classif.
   */
 template<class Properties_>
@@ -328,6 +401,7 @@ private:
   Internal_map_type hmap_;
   Internal_vector_type properties_;
   unsigned max_index_;
+  internal::Property_index<Key_type> index_;
   
 public:
   
@@ -337,6 +411,7 @@ public:
   Generic_classifier(){
     max_index_=Properties_::default_loader(hmap_,properties_);
     assert(max_index_==properties_.size());
+    index_.build(hmap_);
   }
   
   /** Constructor that uses a file to complete the default properties. Not yet implemented */
@@ -475,7 +550,7 @@ public:
     }
     
     max_index_=i;
-    
+    index_.build(hmap_);
   }
   
   /** Returns a property given its index
@@ -490,15 +565,31 @@ public:
     * \param query is the object a property is looking for in the dictionary.
     */
   const Properties& get_properties(const Query_type& query) const{
-    typename Internal_map_type::const_iterator it=hmap_.find( Properties_::make_key(query) );
-    if ( it==hmap_.end() ){
+    return properties_[get_index(query)];
+  }
+  
+  /** Returns the index of the property associated to a Query_type object.
+    * Storing this index instead of the property lets objects share a single classifier.
+    * \param query is the object a property is looking for in the dictionary.
+    */
+  unsigned get_index(const Query_type& query) const{
+    unsigned index;
+    if ( !index_.find(hmap_,Properties_::make_key(query),index) ){
       if (Properties::index_of_default()!=-1)
-        return properties_[Properties::index_of_default()];
+        return Properties::index_of_default();
       std::cerr << "Fatal error: Could not find an entry for " << Properties_::make_key(query);
       std::cerr << " and no default have been defined.\n";
       exit( EXIT_FAILURE );
     }
-    return properties_[it->second];
+    return index;
+  }
+  
+  /** Returns a classifier filled with the default properties, built on first call and
+    * shared by the whole process. It must not be first called concurrently from several threads.
+    */
+  static const Generic_classifier& shared(){
+    static const Generic_classifier classifier;
+    return classifier;
   }
   
   /** returns the number of properties.*/
@@ -32,6 +32,7 @@
 
 
 #include <set>
+#include <ESBTL/name.h>
 
 #ifndef ESBTL_ATOM_SELECTORS_H
 #define ESBTL_ATOM_SELECTORS_H
@@ -56,14 +57,15 @@ namespace ESBTL{
   * \ingroup atomsel
   */
 struct Select_by_resname{
-  std::string name;
+  Name name;
+  bool matches_nothing; //the name given is longer than any name
   /** Default constructor */
-  Select_by_resname(){}; //needed by selected_atom_iterator::end and default constructor
+  Select_by_resname():matches_nothing(false){}; //needed by selected_atom_iterator::end and default constructor
   /**
     * Constructor.
-    * @param str is the name of the residues to be selected.
+    * @param str is the name of the residues to be selected (none is selected if it has more than Name::max_size characters).
     */
-  Select_by_resname(const std::string& str):name(str){}
+  Select_by_resname(const std::string& str):name(str.size()>Name::max_size?Name():Name(str)),matches_nothing(str.size()>Name::max_size){}
   /**
     * Checks if an atoms match a criteria.
     * @tparam Atom must represent an atom, a global function ESBTL::get_residue_name taking an element of this type must exits.
@@ -71,7 +73,7 @@ struct Select_by_resname{
     */
   template <class Atom>
   bool operator()(const Atom& atom) const {
-    return get_residue_name(atom)==name;
+    return !matches_nothing && Name(get_residue_name(atom))==name;
   }
 };
 
@@ -80,15 +82,16 @@ struct Select_by_resname{
   * \ingroup atomsel
   */
 struct Select_by_atmname{
-  std::string name;
+  Name name;
+  bool matches_nothing; //the name given is longer than any name
   /** Default constructor */
-  Select_by_atmname(){}; //needed by selected_atom_iterator::end and default constructor
+  Select_by_atmname():matches_nothing(false){}; //needed by selected_atom_iterator::end and default constructor
 
   /**
     * Constructor.
-    * @param str is the name of the atoms to be selected.
+    * @param str is the name of the atoms to be selected (none is selected if it has more than Name::max_size characters).
     */
-  Select_by_atmname(const std::string& str):name(str){}
+  Select_by_atmname(const std::string& str):name(str.size()>Name::max_size?Name():Name(str)),matches_nothing(str.size()>Name::max_size){}
     
   /**
     * Checks if an atoms match a criteria.
@@ -97,7 +100,7 @@ struct Select_by_atmname{
     */
   template <class Atom>
   bool operator()(const Atom& atom) const {
-    return get_atom_name(atom)==name;
+    return !matches_nothing && Name(get_atom_name(atom))==name;
   }
 };
 
@@ -105,14 +108,15 @@ struct Select_by_atmname{
   * \ingroup atomsel
   */
 struct Select_by_element{
-  std::string name;
+  Name name;
+  bool matches_nothing; //the name given is longer than any name
 /** Default constructor */
-  Select_by_element(){}; //needed by selected_atom_iterator::end and default constructor
+  Select_by_element():matches_nothing(false){}; //needed by selected_atom_iterator::end and default constructor
   /**
     * Constructor.
-    * @param str is the chemical name of the atoms to be selected.
+    * @param str is the chemical name of the atoms to be selected (none is selected if it has more than Name::max_size characters).
     */
-  Select_by_element(const std::string& str):name(str){}
+  Select_by_element(const std::string& str):name(str.size()>Name::max_size?Name():Name(str)),matches_nothing(str.size()>Name::max_size){}
   /**
     * Checks if an atoms match a criteria.
     * @tparam Atom must represent an atom, a global function ESBTL::get_element taking an element of this type must exits.
@@ -120,7 +124,7 @@ struct Select_by_element{
     */
   template <class Atom>
   bool operator()(const Atom& atom) const {
-    return get_element(atom)==name;
+    return !matches_nothing && Name(get_element(atom))==name;
   }
 };
 
@@ -35,9 +35,24 @@
 #ifndef ESBTL_BUILDER_H
 #define ESBTL_BUILDER_H
 #include <iostream>
+#include <vector>
 
 namespace ESBTL {
 
+/**
+ * Upper bounds on the size of a system to be built from a file, given by a counting pass over its lines
+ * (see ESBTL::Line_reader::count_lines).
+ */
+struct System_size{
+  System_size():nb_models(0),nb_chains(0),nb_residues(0),nb_atoms(0){}
+  /** Number of models of the system.*/
+  unsigned nb_models;
+  /** Largest numbers of chains, residues and atoms of a model of the system.*/
+  unsigned nb_chains;
+  unsigned nb_residues;
+  unsigned nb_atoms;
+};
+
 /**
  * Class responsible for building a system.
  * @tparam System is a system as ESBTL::Molecular_system.
@@ -73,10 +88,20 @@ public:
     for (unsigned i=0;i<max_systems;++i) systems_.push_back(System(i+1));
   }
   
+  /**
+   * Reserves the storage of the models of each system, before the lines are read.
+   * @param sizes gives the size of system i+1 at index i, as computed by ESBTL::Line_reader::count_lines.
+   * Only models storing their atoms in arrays (ESBTL::Flat_model) use it.
+   */
+  void reserve(const std::vector<System_size>& sizes){
+    for (unsigned i=0;i<sizes.size() && i<systems_.size();++i)
+      systems_[i].reserve_models(sizes[i].nb_chains,sizes[i].nb_residues,sizes[i].nb_atoms);
+  }
+  
 //doxygen should not read this
 /// \cond   
-  template<class Line_format>
-  void print_line(const Line_format& line_format,const std::string& line){
+  template<class Line_format,class Line>
+  void print_line(const Line_format& line_format,const Line& line){
     std::cout << "[" << line_format.get_record_name(line) << "]" ;
     std::cout << "[" << line_format.get_atom_serial_number(line) << "]" ;
     std::cout << "[" << line_format.get_atom_name(line) << "]" ;
@@ -98,12 +123,13 @@ public:
   /**
    * Extract information from a line in a PDB file and add them to a system.
    * @tparam Line_format is a class providing functions to extract fields from a line of a PDB file (ESBTL::PDB::Line_format for example.).
+   * @tparam Line is the type of the line (\c std::string or ESBTL::Line_span).
    * @param line_format provides the functions to extract the fields.
    * @param line is a line of a PDB file.
    * @param system_info is the number of the system described by this line.
    */
-  template<class Line_format>
-  void interpret_line(const Line_format& line_format,const std::string& line,int system_info){
+  template<class Line_format,class Line>
+  void interpret_line(const Line_format& line_format,const Line& line,int system_info){
     if (system_info==RMK){
       if (line_format.record_type()==PDB::MODEL)
         current_model=line_format.get_model_number(line);
@@ -124,8 +150,10 @@ public:
    * @param altloc indicate the alternate location identification used for systems.
    */
   void create_systems(char altloc){
-    for (typename System_container::iterator it=systems_.begin();it!=systems_.end();++it)
+    for (typename System_container::iterator it=systems_.begin();it!=systems_.end();++it){
       it->set_altloc(altloc);
+      it->finalize();
+    }
   }
   
 };
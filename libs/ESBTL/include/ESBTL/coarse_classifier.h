@@ -54,7 +54,7 @@ private:
   NT radius_;
 public:
   typedef Coarse_atom           Query_type;
-  typedef std::string           Key_type;
+  typedef Name                  Key_type;
   typedef NT                    Value_type;
   
 
@@ -71,7 +71,7 @@ public:
   }
   
   /** The name of the residue is used as key */
-  static std::string make_key(const Coarse_atom& atom)
+  static Key_type make_key(const Coarse_atom& atom)
   {
     return atom.residue().residue_name();
   }
@@ -105,26 +105,44 @@ struct Color_of_atom{
     * \return a string color (red corresponds to "1,0,0")
     */
   std::string operator() (const Atom& atm) const{
-    std::string name=atm.residue().residue_name();
-    if ( name == "ALA" || name == "CYS" || name == "GLY" ||
-          name == "PRO" || name == "SER" || name == "THR" )
-      return std::string("1,1,0"); // yellow: normal
-    
-    if ( name == "VAL" || name == "LEU" || name == "ILE" ||
-           name == "MET" || name == "MSE" || name == "PHE" ||
-           name == "TYR" || name == "TRP" )
-        return std::string("0,0.80,0");// green: hydrophobic
-    
-    if ( name == "HIS" || name == "LYS" || name == "ARG")
-      return std::string("0,0,0.93");//blue: positive charge
-    
-    if ( name == "ASN" || name == "GLN" )
-      return std::string("0.54,0.04,0.31 ");//purple: +/- charge
-    
-    if ( name == "GLU" || name == "ASP" )
-        return std::string("0.77,0,0 ");//red: negative charge
-    return std::string("0.5,0.5,0.5 ");//unknown residue
-  }    
+    return color_of_residue(atm.residue().residue_name());
+  }
+  
+  /** returns the color associated to the residue named \c name, as for its atoms.*/
+  static std::string color_of_residue(const Name& name){
+    static const char* const colors[]={"1,1,0","0,0.80,0","0,0,0.93","0.54,0.04,0.31 ","0.77,0,0 ","0.5,0.5,0.5 "};
+    return std::string(colors[residue_class(name)]);
+  }
+  
+  /** returns the color associated to the residue named \c name, as red, green and blue
+    * components in [0,1] (the values of the string returned by color_of_residue).
+    */
+  static const float* rgb_of_residue(const Name& name){
+    static const float colors[][3]={{1,1,0},{0,0.80f,0},{0,0,0.93f},{0.54f,0.04f,0.31f},{0.77f,0,0},{0.5f,0.5f,0.5f}};
+    return colors[residue_class(name)];
+  }
+  
+  /** returns the index of the color of the residue named \c name,
+    * in the order of the list above (5 for any other residue).
+    */
+  static unsigned residue_class(const Name& name){
+    switch(name.id()){
+      case Name_id<'A','L','A'>::value: case Name_id<'C','Y','S'>::value: case Name_id<'G','L','Y'>::value:
+      case Name_id<'P','R','O'>::value: case Name_id<'S','E','R'>::value: case Name_id<'T','H','R'>::value:
+        return 0; // yellow: normal
+      case Name_id<'V','A','L'>::value: case Name_id<'L','E','U'>::value: case Name_id<'I','L','E'>::value:
+      case Name_id<'M','E','T'>::value: case Name_id<'M','S','E'>::value: case Name_id<'P','H','E'>::value:
+      case Name_id<'T','Y','R'>::value: case Name_id<'T','R','P'>::value:
+        return 1;// green: hydrophobic
+      case Name_id<'H','I','S'>::value: case Name_id<'L','Y','S'>::value: case Name_id<'A','R','G'>::value:
+        return 2;//blue: positive charge
+      case Name_id<'A','S','N'>::value: case Name_id<'G','L','N'>::value:
+        return 3;//purple: +/- charge
+      case Name_id<'G','L','U'>::value: case Name_id<'A','S','P'>::value:
+        return 4;//red: negative charge
+    }
+    return 5;//unknown residue
+  }
 };
 
 /** 
@@ -145,7 +163,7 @@ public:
   
   
   //~ typedef std::pair<unsigned,unsigned> Key_type;
-  typedef std::string Key_type;
+  typedef Name Key_type;
   typedef Atom Query_type;
 
   Color_of_residues(const std::string& color):color_(color){}
@@ -186,7 +204,7 @@ public:
   
   static Key_type make_key(const Query_type& atom)
   {
-    return get_residue_name(atom);
+    return Name(get_residue_name(atom));
   }
 };
 
@@ -94,6 +94,7 @@ public:
     FT Xbb[4]={0,0,0,0};
     FT Xsc[4]={0,0,0,0};
     unsigned tot_res=0;
+    //backbone atoms first and then side chain atoms, so that the atoms of each coarse atom are added in a row
     for(typename Residue::Atoms_const_iterator
         at_it=res.atoms_begin();
         at_it!=res.atoms_end();
@@ -104,13 +105,21 @@ public:
         bb.add(*at_it);
         update_coordinates(Xbb,*at_it);
       }
-      else{
-        sc.add(*at_it);
-        update_coordinates(Xsc,*at_it);
-      }
     }
     if (tot_res==0)
       return 0;
+    if (Xbb[3]!=tot_res){
+      for(typename Residue::Atoms_const_iterator
+          at_it=res.atoms_begin();
+          at_it!=res.atoms_end();
+          ++at_it)
+      {
+        if ( !is_backbone(*at_it) ){
+          sc.add(*at_it);
+          update_coordinates(Xsc,*at_it);
+        }
+      }
+    }
     unsigned ret=0;
     if (Xbb[3]!=0){ //to handle case of a ligand for example.
       static_cast<Point_3&>(bb)=Point_3(Xbb[0]/Xbb[3],Xbb[1]/Xbb[3],Xbb[2]/Xbb[3]);
@@ -171,7 +180,6 @@ public:
   int operator()(const Residue& res,Output_iterator out) const {
     Coarse_atom c_atm(0,res);
     FT X_c_atm[4]={0,0,0,0};
-    std::list<const Atom*> candidate_list;
     for(typename Residue::Atoms_const_iterator
         at_it=res.atoms_begin();
         at_it!=res.atoms_end();
@@ -180,23 +188,23 @@ public:
       if ( is_side_chain_or_CA(*at_it) ){
         c_atm.add(*at_it);
         update_coordinates(X_c_atm,*at_it);
-        candidate_list.push_back( &(*at_it) );
       }
     }
     assert(X_c_atm[3]!=0);
     Atom barycenter=Atom(X_c_atm[0]/X_c_atm[3],X_c_atm[1]/X_c_atm[3],X_c_atm[2]/X_c_atm[3]);
     FT min_dist=std::numeric_limits<FT>::max();
     
-    typename std::list<const Atom*>::iterator min_it=candidate_list.end();
-    for (typename std::list<const Atom*>::iterator it=candidate_list.begin();it!=candidate_list.end();++it){
-      FT curr_dist=squared_distance(barycenter,*(*it));
+    //the candidates are the atoms of the coarse atom
+    const Atom* closest=NULL;
+    for (unsigned i=0;i<c_atm.number_of_atoms();++i){
+      FT curr_dist=squared_distance(barycenter,c_atm.atom(i));
       if (curr_dist < min_dist){
-        min_it=it;
+        closest=&c_atm.atom(i);
         min_dist=curr_dist;
       }
     }
-    assert(min_it!=candidate_list.end());
-    static_cast<typename Coarse_atom::Point_3&>(c_atm)=static_cast<const typename Atom::Point_3&>(*(*min_it));
+    assert(closest!=NULL);
+    static_cast<typename Coarse_atom::Point_3&>(c_atm)=static_cast<const typename Atom::Point_3&>(*closest);
 
         
     *out++=c_atm;
@@ -35,10 +35,33 @@
 #ifndef ESBTL_COARSE_GRAIN_H
 #define ESBTL_COARSE_GRAIN_H
 
+#include <vector>
+#include <algorithm>
 #include <ESBTL/molecular_system.h>
 
 namespace ESBTL{
 
+/** \cond */
+namespace internal{
+
+//appends an element to the range [first,first+n) of a vector, copying the range at the end of the vector
+//if it is not already there, and returns the new beginning of the range
+template <class T>
+unsigned append_to_range(std::vector<T>& v,unsigned first,unsigned n,const T& t){
+  if (first+n!=v.size() || n==0){
+    unsigned new_first=v.size();
+    //no reallocation while the range is copied
+    if (v.capacity() < new_first+n+1) v.reserve((std::max)(2*v.capacity(),static_cast<std::size_t>(new_first+n+1)));
+    for (unsigned i=0;i<n;++i) v.push_back(v[first+i]);
+    first=new_first;
+  }
+  v.push_back(t);
+  return first;
+}
+
+} //namespace internal
+/** \endcond */
+
 /** A coarse-grain atom type 
   * \tparam Atom is the base atom class that the coarse atom represent.
   * \tparam Point is a point type with coordinates const access methods x(), y() and z().
@@ -46,29 +69,50 @@ namespace ESBTL{
 template <class Atom,class Point>
 class Coarse_atom: public Point{
   typedef typename Atom::System::Residue Residue;
-  //list of atoms that contributes to the coarse atom
-  std::list<const Atom*> atoms_;
+  //atoms that contribute to the coarse atom: a range of the coarse atom members stored by the residue
+  unsigned first_atom_;
+  unsigned number_of_atoms_;
   unsigned index_;
   const Residue* residue_;
   
 public:
   typedef Point Point_3;
 
-  /** Add atom to the set of atom represented.*/
-  void add(const Atom& atom){atoms_.push_back(&atom);}
+  /** Add atom to the set of atom represented. The atoms of the coarse atoms of a residue are stored
+    * contiguously by the residue: adding them one coarse atom after the other avoids copying them.
+    */
+  void add(const Atom& atom){
+    assert(residue_!=NULL);
+    first_atom_=residue_->add_coarse_atom_member(first_atom_,number_of_atoms_,atom);
+    ++number_of_atoms_;
+  }
   
-  Coarse_atom(const Point_3& p,unsigned i,const Residue& res):Point_3(p),index_(i),residue_(&res){}
-  Coarse_atom(unsigned i,const Residue& res):Point_3(),index_(i),residue_(&res){}
+  /** Number of atoms represented.*/
+  unsigned number_of_atoms() const {return number_of_atoms_;}
+  /** The i-th atom represented, in the order they were added.*/
+  const Atom& atom(unsigned i) const {
+    assert(i<number_of_atoms_);
+    return residue_->coarse_atom_member(first_atom_+i);
+  }
+  
+  Coarse_atom(const Point_3& p,unsigned i,const Residue& res):Point_3(p),first_atom_(0),number_of_atoms_(0),index_(i),residue_(&res){}
+  Coarse_atom(unsigned i,const Residue& res):Point_3(),first_atom_(0),number_of_atoms_(0),index_(i),residue_(&res){}
     
-  Coarse_atom():Point_3(),index_(0),residue_(NULL){}
-  Coarse_atom(float x,float y,float z):Point_3(x,y,z),index_(0),residue_(NULL){}    
+  Coarse_atom():Point_3(),first_atom_(0),number_of_atoms_(0),index_(0),residue_(NULL){}
+  Coarse_atom(float x,float y,float z):Point_3(x,y,z),first_atom_(0),number_of_atoms_(0),index_(0),residue_(NULL){}    
   
   const Residue& residue() const {return *residue_;}
+  /** Changes the residue the coarse atom belongs to (used by layouts that move residues in memory, see ESBTL::Flat_model).*/
+  void set_residue(const Residue& res) {residue_=&res;}
   
   unsigned index() const {return index_;}
 };
 
 /** A coarse-grain residue type 
+  * The atoms of the coarse atoms of a residue are stored by the residue, and each coarse atom refers to a range of them.
+  * In this map-based layout, atoms are the nodes of the map of their residue: there is no array of the atoms of a model
+  * to store indices into, so members are pointers, kept with the residue like its atoms (one vector per residue, reserved
+  * to its number of atoms). ESBTL::Flat_model, whose atoms are in an array, keeps a single vector of indices per model instead.
   * \tparam Residue is a base residue class.
   * \tparam Chain is a chain type.
   * \tparam Coarse_atom_ is the Coarse-grain atom type used.
@@ -76,16 +120,21 @@ public:
 template <class Residue,class Chain,class Coarse_atom_>
 class Coarse_residue:public Residue{
   std::vector<Coarse_atom_> coarse_atoms_container;
+  //atoms of the coarse atoms, each coarse atom refers to a range of it.
+  //Coarse creators get a const residue, hence mutable: creating the coarse atoms of a residue writes it, so it must
+  //not run concurrently with another creation or with reads of the coarse atoms of the same residue.
+  //Once created, the coarse atoms can be read from several threads.
+  mutable std::vector<const typename Residue::Atom*> coarse_atom_members_;
   typedef Coarse_residue<Residue,Chain,Coarse_atom_> Self;
 public:
   typedef std::vector<Coarse_atom_> Coarse_atom_container;
   typedef Coarse_atom_ Coarse_atom;
   typedef typename Residue::Atom  Atom;
 
-  template<class Line_format>
-  Coarse_residue(const Line_format& line_format, const std::string& line,const Chain& ch):
+  template<class Line_format,class Line>
+  Coarse_residue(const Line_format& line_format, const Line& line,const Chain& ch):
     Residue(line_format,line,ch){}
-  Coarse_residue(const std::string& resname,int index,char insc,const Chain& ch):
+  Coarse_residue(const Name& resname,int index,char insc,const Chain& ch):
     Residue(resname,index,insc,ch){}
 
       
@@ -96,6 +145,7 @@ public:
     */      
   template <class Coarse_creator>
   int create_coarse_atoms(const Coarse_creator& creator){
+    if (coarse_atom_members_.empty()) coarse_atom_members_.reserve(this->number_of_atoms());
     return creator(*this,std::back_inserter(coarse_atoms_container));
   }
 
@@ -112,6 +162,17 @@ public:
     return coarse_atoms_container[i];
   }
   
+//doxygen should not read this
+/// \cond
+  //appends an atom to the range [first,first+n) of coarse atom members, moving the range at the end if needed,
+  //and returns the new beginning of the range
+  unsigned add_coarse_atom_member(unsigned first,unsigned n,const Atom& atom) const {
+    return internal::append_to_range(coarse_atom_members_,first,n,&atom);
+  }
+  
+  const Atom& coarse_atom_member(unsigned i) const {return *coarse_atom_members_[i];}
+/// \endcond
+  
   //TODO find another way to to this except a simple copy from the base class
   //iterators
   //---------
@@ -166,7 +227,7 @@ public:
   * Other coarse grain atoms will use an increasing number starting from this value.
   */
 template<class Input_iterator,class System>
-void insert_coarse_atoms(Input_iterator first,Input_iterator last,System& system,int modelid=1,char chainid='Z',std::string resname="SOL",int starting_res_index=1){
+void insert_coarse_atoms(Input_iterator first,Input_iterator last,System& system,int modelid=1,char chainid='Z',Name resname="SOL",int starting_res_index=1){
   typename System::Model& model=system.get_or_create_model(modelid);
   typename System::Chain& chain=model.get_or_create_chain(chainid);
   int res_index=starting_res_index-1;
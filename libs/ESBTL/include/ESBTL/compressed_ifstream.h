@@ -40,6 +40,13 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filter/zlib.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <ESBTL/line_span.h>
+#include <cstring>
 
 /** \cond */
 namespace ESBTL{
@@ -70,6 +77,241 @@ namespace ESBTL{
     }
   };
   
+  inline void push_decompressor(boost::iostreams::filtering_stream<boost::iostreams::input>& input,Reading_mode_tag<BZIP2>){
+    input.push(boost::iostreams::bzip2_decompressor());
+  }
+  
+  inline void push_decompressor(boost::iostreams::filtering_stream<boost::iostreams::input>& input,Reading_mode_tag<GZIP>){
+    input.push(boost::iostreams::gzip_decompressor());
+  }
+  
+  inline double seconds_since(const boost::posix_time::ptime& start){
+    return (boost::posix_time::microsec_clock::universal_time()-start).total_microseconds()*1e-6;
+  }
+  
 } } //ESBTL::internal
 /** \endcond */
+
+namespace ESBTL{
+
+/**
+  * Throughput of the two stages of a ESBTL::Decompression_pipeline.
+  * Times do not include the time a stage spends waiting for the other one.
+  */
+struct Decompression_statistics{
+  std::size_t compressed_bytes;
+  std::size_t decompressed_bytes;
+  double decompression_seconds;
+  double parsing_seconds;
+  
+  Decompression_statistics():compressed_bytes(0),decompressed_bytes(0),decompression_seconds(0),parsing_seconds(0){}
+  
+  /** Decompressed megabytes produced per second by the decompression stage.*/
+  double decompression_throughput() const {return decompression_seconds==0?0:decompressed_bytes/decompression_seconds*1e-6;}
+  /** Decompressed megabytes consumed per second by the parsing stage.*/
+  double parsing_throughput() const {return parsing_seconds==0?0:decompressed_bytes/parsing_seconds*1e-6;}
+};
+
+inline std::ostream& operator<<(std::ostream& out,const Decompression_statistics& stats){
+  out << "decompression " << stats.decompression_throughput() << " MB/s, parsing " << stats.parsing_throughput() << " MB/s"
+      << " (" << stats.compressed_bytes*1e-6 << " MB compressed, " << stats.decompressed_bytes*1e-6 << " MB decompressed)";
+  return out;
+}
+
+/**
+  * Reads the lines of a compressed file with two threads: a decompressor thread fills a bounded ring of
+  * buffers while the calling thread takes lines from them (using next_line). Lines are given as ESBTL::Line_span
+  * that remain valid until the next call to next_line.
+  * Using this class requires the boost_iostreams and boost_thread libraries.
+  * \tparam mode is the compression algorithm, ESBTL::GZIP or ESBTL::BZIP2.
+  */
+template <Reading_mode mode>
+class Decompression_pipeline{
+  struct Buffer{
+    std::vector<char> data;
+    std::size_t size;
+    bool full;
+    Buffer():size(0),full(false){}
+  };
+  
+  std::ifstream file_;
+  boost::iostreams::filtering_stream<boost::iostreams::input> input_;
+  std::vector<Buffer> ring_;
+  std::size_t buffer_size_;
+  boost::scoped_ptr<boost::thread> thread_;
+  boost::mutex mutex_;
+  boost::condition_variable buffer_changed_;
+  bool finished_;
+  bool stop_;
+  bool failed_;
+  
+  //consumer side
+  std::size_t current_;
+  bool has_buffer_;
+  const char* pos_;
+  const char* end_;
+  std::string carry_;
+  std::string line_;
+  boost::posix_time::ptime start_;
+  double waiting_seconds_;
+  Decompression_statistics stats_;
+  
+  Decompression_pipeline(const Decompression_pipeline&);
+  Decompression_pipeline& operator=(const Decompression_pipeline&);
+  
+  void decompress(){
+    std::size_t i=0;
+    while (true){
+      Buffer& buffer=ring_[i];
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        while (buffer.full && !stop_)
+          buffer_changed_.wait(lock);
+        if (stop_) return;
+      }
+      
+      boost::posix_time::ptime start=boost::posix_time::microsec_clock::universal_time();
+      bool failed=false;
+      std::size_t size=0;
+      try{
+        input_.read(&buffer.data[0],buffer.data.size());
+        size=static_cast<std::size_t>(input_.gcount());
+        failed=input_.bad();
+      }
+      catch(const std::exception&){
+        failed=true;
+      }
+      bool last=failed || size<buffer.data.size();
+      
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        stats_.decompression_seconds+=internal::seconds_since(start);
+        stats_.decompressed_bytes+=size;
+        buffer.size=size;
+        buffer.full=!failed;
+        failed_=failed;
+        finished_=last;
+      }
+      buffer_changed_.notify_all();
+      if (last) return;
+      i=(i+1)%ring_.size();
+    }
+  }
+  
+  //release the current buffer and wait for the next one. Returns false at the end of the file.
+  bool next_buffer(){
+    boost::mutex::scoped_lock lock(mutex_);
+    if (has_buffer_){
+      ring_[current_].full=false;
+      current_=(current_+1)%ring_.size();
+      has_buffer_=false;
+      buffer_changed_.notify_all();
+    }
+    boost::posix_time::ptime start=boost::posix_time::microsec_clock::universal_time();
+    while (!ring_[current_].full && !finished_)
+      buffer_changed_.wait(lock);
+    waiting_seconds_+=internal::seconds_since(start);
+    if (!ring_[current_].full){
+      stats_.parsing_seconds=internal::seconds_since(start_)-waiting_seconds_;
+      return false;
+    }
+    has_buffer_=true;
+    pos_=&ring_[current_].data[0];
+    end_=pos_+ring_[current_].size;
+    return true;
+  }
+  
+public:
+  /** Constructor.
+    * \param nb_buffers is the number of buffers in the ring.
+    * \param buffer_size is the size in bytes of each buffer.
+    */
+  Decompression_pipeline(std::size_t nb_buffers=4,std::size_t buffer_size=1<<22):
+    ring_(nb_buffers<2?2:nb_buffers),buffer_size_(buffer_size==0?1:buffer_size),finished_(false),stop_(false),failed_(false),
+    current_(0),has_buffer_(false),pos_(NULL),end_(NULL),waiting_seconds_(0){}
+  
+  ~Decompression_pipeline(){close();}
+  
+  /** Opens a file and starts the decompressor thread. Returns false if the file cannot be opened.*/
+  bool open(const std::string& filename){
+    close();
+    file_.open(filename.c_str(),std::ios_base::binary);
+    if (!file_) return false;
+    file_.seekg(0,std::ios_base::end);
+    stats_=Decompression_statistics();
+    stats_.compressed_bytes=static_cast<std::size_t>(file_.tellg());
+    file_.seekg(0,std::ios_base::beg);
+    
+    internal::push_decompressor(input_,internal::Reading_mode_tag<mode>());
+    input_.push(file_);
+    
+    for (typename std::vector<Buffer>::iterator it=ring_.begin();it!=ring_.end();++it){
+      it->data.resize(buffer_size_);
+      it->full=false;
+    }
+    finished_=stop_=failed_=has_buffer_=false;
+    current_=0;
+    carry_.clear();
+    waiting_seconds_=0;
+    start_=boost::posix_time::microsec_clock::universal_time();
+    thread_.reset(new boost::thread(&Decompression_pipeline::decompress,this));
+    return true;
+  }
+  
+  /** Stops the decompressor thread and closes the file.*/
+  void close(){
+    if (thread_){
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        stop_=true;
+      }
+      buffer_changed_.notify_all();
+      thread_->join();
+      thread_.reset();
+    }
+    input_.reset();
+    if (file_.is_open()) file_.close();
+    file_.clear();
+  }
+  
+  /** Gives the next line of the file (without its end of line character). Returns false at the end of the file.*/
+  bool next_line(Line_span& line){
+    while (true){
+      if (has_buffer_){
+        const char* eol=static_cast<const char*>( memchr(pos_,'\n',end_-pos_) );
+        if (eol!=NULL){
+          if (carry_.empty())
+            line=Line_span(pos_,eol);
+          else{
+            //the line started in the previous buffer
+            carry_.append(pos_,eol);
+            line_.swap(carry_);
+            carry_.clear();
+            line=Line_span(line_.data(),line_.size());
+          }
+          pos_=eol+1;
+          return true;
+        }
+        carry_.append(pos_,end_);
+      }
+      if (!next_buffer()){
+        if (carry_.empty()) return false;
+        //last line without end of line character
+        line_.swap(carry_);
+        carry_.clear();
+        line=Line_span(line_.data(),line_.size());
+        return true;
+      }
+    }
+  }
+  
+  /** Returns true if an error occured during the decompression.*/
+  bool failed() const {return failed_;}
+  
+  /** Statistics of the stages, complete once next_line returned false.*/
+  const Decompression_statistics& statistics() const {return stats_;}
+};
+
+} //namespace ESBTL
+
 #endif //ESBTL_COMPRESSED_IFSTREAM_H
@@ -111,12 +111,17 @@
 #include <ESBTL/line_reader.h>
 #include <ESBTL/occupancy_handlers.h>
 #include <ESBTL/coarse_grain.h>
+#include <ESBTL/flat_system.h>
 
 namespace ESBTL {
   /** A default declaration of an all-atom system.*/
   typedef Molecular_system<Default_system_items,Point_3 > Default_system;
   /** A default declaration of an all-atom and coarse grain system.*/
   typedef Molecular_system<System_items_with_coarse_grain,Point_3 > Default_system_with_coarse_grain;
+  /** An all-atom system whose models are stored in contiguous arrays (see ESBTL::Flat_model).*/
+  typedef Molecular_system<Flat_system_items,Point_3 > Flat_system;
+  /** An all-atom and coarse grain system whose models are stored in contiguous arrays (see ESBTL::Flat_model).*/
+  typedef Molecular_system<Flat_system_items_with_coarse_grain,Point_3 > Flat_system_with_coarse_grain;
 } //namespace ESBTL
 
 #endif //ESBTL_DEFAULT_H
@@ -0,0 +1,910 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+#ifndef ESBTL_FLAT_SYSTEM_H
+#define ESBTL_FLAT_SYSTEM_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <cassert>
+#include <boost/unordered_map.hpp>
+#include <ESBTL/molecular_system.h>
+#include <ESBTL/coarse_grain.h>
+
+namespace ESBTL{
+
+template <class System,class Coarse_atom_>
+class Flat_model;
+template <class System,class Coarse_atom_>
+class Flat_chain;
+template <class System,class Coarse_atom_>
+class Flat_residue;
+
+/** \cond */
+namespace internal{
+
+//coarse atom type of a flat system without coarse grain (only an empty container of it exists)
+struct No_coarse_atom{
+  template <class Residue>
+  void set_residue(const Residue&){}
+};
+
+//output iterator giving the coarse atoms made by a coarse creator to their residue
+template <class Residue>
+class Flat_coarse_atom_inserter{
+  Residue* residue_;
+public:
+  typedef std::output_iterator_tag  iterator_category;
+  typedef void                      value_type;
+  typedef void                      difference_type;
+  typedef void                      pointer;
+  typedef void                      reference;
+
+  explicit Flat_coarse_atom_inserter(Residue& res):residue_(&res){}
+  Flat_coarse_atom_inserter& operator=(const typename Residue::Coarse_atom& atom){
+    residue_->insert_coarse_atom(atom);
+    return *this;
+  }
+  Flat_coarse_atom_inserter& operator*(){return *this;}
+  Flat_coarse_atom_inserter& operator++(){return *this;}
+  Flat_coarse_atom_inserter operator++(int){return *this;}
+};
+
+//order of chains in std::map<char,Chain>
+template <class Chain_container>
+struct Less_flat_chain{
+  const Chain_container& chains;
+  Less_flat_chain(const Chain_container& c):chains(c){}
+  bool operator()(unsigned i,unsigned j) const {
+    return chains[i].chain_identifier() < chains[j].chain_identifier();
+  }
+};
+
+//order of residues of a model in std::map<std::pair<int,char>,Residue>, chain after chain
+template <class Residue_container>
+struct Less_flat_residue{
+  const Residue_container& residues;
+  const std::vector<unsigned>& chain_rank;
+  Less_flat_residue(const Residue_container& r,const std::vector<unsigned>& c):residues(r),chain_rank(c){}
+  bool operator()(unsigned i,unsigned j) const {
+    unsigned ci=chain_rank[residues[i].chain_index()];
+    unsigned cj=chain_rank[residues[j].chain_index()];
+    if (ci!=cj) return ci<cj;
+    return residues[i].key() < residues[j].key();
+  }
+};
+
+//order of atoms of a model in std::map<unsigned,Atom>, residue after residue
+template <class Atom_container>
+struct Less_flat_atom{
+  const Atom_container& atoms;
+  const std::vector<unsigned>& residue_of_atom;
+  const std::vector<unsigned>& residue_rank;
+  Less_flat_atom(const Atom_container& a,const std::vector<unsigned>& ra,const std::vector<unsigned>& rr):
+    atoms(a),residue_of_atom(ra),residue_rank(rr){}
+  bool operator()(unsigned i,unsigned j) const {
+    unsigned ri=residue_rank[residue_of_atom[i]];
+    unsigned rj=residue_rank[residue_of_atom[j]];
+    if (ri!=rj) return ri<rj;
+    return static_cast<unsigned>(atoms[i].atom_serial_number()) < static_cast<unsigned>(atoms[j].atom_serial_number());
+  }
+};
+
+template <class Residue>
+struct Less_residue_key{
+  bool operator()(const Residue& res,const std::pair<int,char>& key) const {return res.key() < key;}
+};
+
+template <class Atom>
+struct Less_atom_serial_number{
+  bool operator()(const Atom& atom,unsigned sn) const {return static_cast<unsigned>(atom.atom_serial_number()) < sn;}
+};
+
+} //namespace internal
+/** \endcond */
+
+/** A class representing a model whose chains, residues, atoms (and coarse grain atoms) are stored
+  * in contiguous arrays owned by the model. A chain refers to a range of residues and a residue to a range
+  * of atoms (and of coarse grain atoms) of these arrays.
+  * Each model has its own arrays: the models themselves are still stored by ESBTL::Molecular_system in a std::map,
+  * so a system of n models holds n sets of arrays rather than a single arena.
+  *
+  * Ranges follow the order of the map-based layout (chains sorted by identifier, residues by sequence number
+  * and insertion code, atoms by serial number), so that iterators visit the hierarchy in the same order as
+  * ESBTL::Molecular_model. When lines come in that order (which is the case of most files) the arrays
+  * are only appended to. Otherwise, they are reordered once by finalize(), which the builder calls
+  * after the last line. As with a std::vector, references to chains, residues and atoms are invalidated
+  * when new ones are created.
+  * \tparam System_ is a system (like ESBTL::Molecular_system for example).
+  * \tparam Coarse_atom_ is the coarse grain atom type, internal::No_coarse_atom if there is none.
+  */
+template <class System_,class Coarse_atom_>
+class Flat_model{
+public:
+  typedef System_                                  System;
+  typedef typename System::Chain                   Chain;
+  typedef typename System::Residue                 Residue;
+  typedef typename System::Atom                    Atom;
+  typedef Coarse_atom_                             Coarse_atom;
+  typedef std::vector<Chain>                       Chain_container;
+  typedef std::vector<Residue>                     Residue_container;
+  typedef std::vector<Atom>                        Atom_container;
+  typedef std::vector<Coarse_atom_>                Coarse_atom_container;
+private:
+  typedef Flat_model<System_,Coarse_atom_>         Self;
+  typedef std::pair<unsigned,std::pair<int,char> > Residue_key;
+
+  friend class Flat_chain<System_,Coarse_atom_>;
+  friend class Flat_residue<System_,Coarse_atom_>;
+
+  const System& system_;
+  Chain_container chain_container_;
+  Residue_container residue_container_;
+  Atom_container atom_container_;
+  Coarse_atom_container coarse_atom_container_;
+  //atoms of the coarse atoms (indices in atom_container_), each coarse atom refers to a range of it
+  std::vector<unsigned> coarse_atom_member_container_;
+  int chain_index_[256];
+  int last_coarse_residue_;
+  //false when the arrays are not in the order of the map-based layout, until finalize is called
+  bool is_sorted_;
+  //only used while not sorted: residue of each atom and residue lookup
+  std::vector<unsigned> residue_of_atom_;
+  boost::unordered_map<Residue_key,unsigned> residue_index_;
+  //built by finalize
+  Model_index index_;
+  
+  
+public:
+  const System& system() const {return system_;}
+  
+  Flat_model(int nbm,const System& sys):system_(sys),last_coarse_residue_(-1),is_sorted_(true),model_number_(nbm){
+    std::fill(chain_index_,chain_index_+256,-1);
+  }
+  
+  /** Copy constructor. The chains, residues and atoms of the copy refer to the copy. */
+  Flat_model(const Flat_model& other):
+    system_(other.system_),
+    chain_container_(other.chain_container_),
+    residue_container_(other.residue_container_),
+    atom_container_(other.atom_container_),
+    coarse_atom_container_(other.coarse_atom_container_),
+    coarse_atom_member_container_(other.coarse_atom_member_container_),
+    last_coarse_residue_(other.last_coarse_residue_),
+    is_sorted_(other.is_sorted_),
+    residue_of_atom_(other.residue_of_atom_),
+    residue_index_(other.residue_index_),
+    index_(other.index_),
+    model_number_(other.model_number_)
+  {
+    std::copy(other.chain_index_,other.chain_index_+256,chain_index_);
+    for (typename Chain_container::iterator it=chain_container_.begin();it!=chain_container_.end();++it)
+      it->model_=this;
+    for (typename Residue_container::iterator it=residue_container_.begin();it!=residue_container_.end();++it)
+      it->model_=this;
+    rebind_atoms();
+  }
+
+  template <class Line_format,class Line>
+  Chain& get_or_create_chain(const Line_format& line_format,const Line& line){
+    return get_or_create_chain(line_format.get_chain_identifier(line));
+  }
+  
+  Chain& get_or_create_chain(char id){
+    int& index=chain_index_[static_cast<unsigned char>(id)];
+    if (index==-1){
+      if (!chain_container_.empty() && !(chain_container_.back().chain_identifier() < id))
+        unsort();
+      index=chain_container_.size();
+      chain_container_.push_back(Chain(id,*this,residue_container_.size()));
+    }
+    return chain_container_[index];
+  }
+
+  const Chain& get_chain(char id) const {
+    int index=chain_index_[static_cast<unsigned char>(id)];
+    assert (index!=-1);
+    return chain_container_[index];
+  }
+
+  const Residue& get_residue(char ch_id,int ressn,char insc=' ') const {
+    return get_chain(ch_id).get_residue(ressn,insc);
+  }
+  
+  const Atom& get_atom(char ch_id,int ressn,char insc,unsigned atom_sn) const {
+    return get_chain(ch_id).get_residue(ressn,insc).get_atom(atom_sn);
+  }
+  
+  size_t number_of_chains() const {
+    return chain_container_.size();
+  }
+  
+  /** Reserves the arrays of the model, so that they are only appended to while the lines are read.*/
+  void reserve(unsigned nb_chains,unsigned nb_residues,unsigned nb_atoms){
+    chain_container_.reserve(nb_chains);
+    residue_container_.reserve(nb_residues);
+    atom_container_.reserve(nb_atoms);
+  }
+  
+  size_t number_of_residues() const {
+    return residue_container_.size();
+  }
+
+  size_t number_of_atoms() const {
+    return atom_container_.size();
+  }
+  
+  /** Puts the arrays in the order of the map-based layout if lines did not come in that order,
+    * and builds the index of the model. The builder calls it once all lines are read. It must be called
+    * before using a model whose chains, residues or atoms were created by hand out of order.
+    */
+  void finalize(){
+    if (is_sorted_){
+      index_.build(*this);
+      return;
+    }
+    const unsigned nb_chains=chain_container_.size();
+    const unsigned nb_residues=residue_container_.size();
+    const unsigned nb_atoms=atom_container_.size();
+    
+    std::vector<unsigned> chain_order(nb_chains),chain_rank(nb_chains);
+    for (unsigned i=0;i<nb_chains;++i) chain_order[i]=i;
+    std::sort(chain_order.begin(),chain_order.end(),internal::Less_flat_chain<Chain_container>(chain_container_));
+    for (unsigned i=0;i<nb_chains;++i) chain_rank[chain_order[i]]=i;
+    
+    std::vector<unsigned> residue_order(nb_residues),residue_rank(nb_residues);
+    for (unsigned i=0;i<nb_residues;++i) residue_order[i]=i;
+    std::sort(residue_order.begin(),residue_order.end(),internal::Less_flat_residue<Residue_container>(residue_container_,chain_rank));
+    for (unsigned i=0;i<nb_residues;++i) residue_rank[residue_order[i]]=i;
+    
+    //stable, so that the first of two atoms with the same serial number is kept as in the map-based layout
+    std::vector<unsigned> atom_order(nb_atoms);
+    for (unsigned i=0;i<nb_atoms;++i) atom_order[i]=i;
+    std::stable_sort(atom_order.begin(),atom_order.end(),internal::Less_flat_atom<Atom_container>(atom_container_,residue_of_atom_,residue_rank));
+    
+    Chain_container chains;
+    chains.reserve(nb_chains);
+    for (unsigned i=0;i<nb_chains;++i){
+      chains.push_back(chain_container_[chain_order[i]]);
+      chains.back().number_of_residues_=0;
+      chain_index_[static_cast<unsigned char>(chains.back().chain_identifier())]=i;
+    }
+    
+    Residue_container residues;
+    Coarse_atom_container coarse_atoms;
+    residues.reserve(nb_residues);
+    coarse_atoms.reserve(coarse_atom_container_.size());
+    last_coarse_residue_=-1;
+    for (unsigned i=0;i<nb_residues;++i){
+      residues.push_back(residue_container_[residue_order[i]]);
+      Residue& res=residues.back();
+      res.chain_index_=chain_rank[res.chain_index_];
+      Chain& chain=chains[res.chain_index_];
+      if (chain.number_of_residues_++==0) chain.first_residue_=i;
+      res.number_of_atoms_=0;
+      typename Coarse_atom_container::const_iterator first=coarse_atom_container_.begin()+res.first_coarse_atom_;
+      res.first_coarse_atom_=coarse_atoms.size();
+      coarse_atoms.insert(coarse_atoms.end(),first,first+res.number_of_coarse_atoms_);
+      if (res.number_of_coarse_atoms_!=0) last_coarse_residue_=i;
+    }
+    
+    Atom_container atoms;
+    std::vector<unsigned> atom_rank(coarse_atom_member_container_.empty()?0:nb_atoms);
+    atoms.reserve(nb_atoms);
+    for (unsigned i=0;i<nb_atoms;++i){
+      const Atom& atom=atom_container_[atom_order[i]];
+      Residue& res=residues[residue_rank[residue_of_atom_[atom_order[i]]]];
+      if (res.number_of_atoms_!=0 && atoms.back().atom_serial_number()==atom.atom_serial_number()){
+        assert(!"Two atoms with same serial numbers.");
+        if (!atom_rank.empty()) atom_rank[atom_order[i]]=atoms.size()-1;
+        continue;
+      }
+      if (res.number_of_atoms_++==0) res.first_atom_=atoms.size();
+      if (!atom_rank.empty()) atom_rank[atom_order[i]]=atoms.size();
+      atoms.push_back(atom);
+    }
+    for (std::vector<unsigned>::iterator it=coarse_atom_member_container_.begin();it!=coarse_atom_member_container_.end();++it)
+      *it=atom_rank[*it];
+    
+    //empty ranges start where the next non-empty one does, so that appending keeps the arrays sorted
+    unsigned next=nb_residues;
+    for (unsigned i=nb_chains;i--!=0;){
+      if (chains[i].number_of_residues_==0) chains[i].first_residue_=next;
+      else next=chains[i].first_residue_;
+    }
+    next=atoms.size();
+    for (unsigned i=nb_residues;i--!=0;){
+      if (residues[i].number_of_atoms_==0) residues[i].first_atom_=next;
+      else next=residues[i].first_atom_;
+    }
+    
+    chain_container_.swap(chains);
+    residue_container_.swap(residues);
+    atom_container_.swap(atoms);
+    coarse_atom_container_.swap(coarse_atoms);
+    std::vector<unsigned>().swap(residue_of_atom_);
+    boost::unordered_map<Residue_key,unsigned>().swap(residue_index_);
+    is_sorted_=true;
+    rebind_atoms();
+    index_.build(*this);
+  }
+  
+  /** Index of the atoms and residues built by finalize(), ranks are positions in the arrays of the model.*/
+  const Model_index& index() const {return index_;}
+  
+  /** Returns the atom with serial number sn in constant time, NULL if there is none (see ESBTL::Model_index).*/
+  const Atom* find_atom_by_serial_number(unsigned sn) const {
+    int rank=index_.find_atom(sn);
+    return rank==-1?NULL:&atom_container_[rank];
+  }
+  
+  /** Returns a residue in constant time, NULL if there is none (see ESBTL::Model_index).*/
+  const Residue* find_residue_by_key(char ch_id,int ressn,char insc=' ') const {
+    int rank=index_.find_residue(ch_id,ressn,insc);
+    return rank==-1?NULL:&residue_container_[rank];
+  }
+
+  //iterators
+  //---------
+  //functions needed by generic iterator in iterators.h 
+  static const Chain& dereference (typename Chain_container::const_iterator it) {return *it;}
+  static Chain& dereference (typename Chain_container::iterator it) {return *it;}
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Chains_iterator_from_model<Self,true>  Chains_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef internal::Chains_iterator_from_model<Self,false> Chains_iterator;
+  
+  /** \ingroup grp_iters*/
+  Chains_iterator chains_begin() {return Chains_iterator(chain_container_.begin());}
+  /** \ingroup grp_iters*/
+  Chains_iterator chains_end()   {return Chains_iterator(chain_container_.end());}
+
+  /** \ingroup grp_iters*/
+  Chains_const_iterator chains_begin() const {return Chains_const_iterator(chain_container_.begin());}
+  /** \ingroup grp_iters*/
+  Chains_const_iterator chains_end()   const {return Chains_const_iterator(chain_container_.end());}  
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Residues_iterator_from_model<Self,true>  Residues_const_iterator;
+  /** \ingroup grp_iters*/  
+  typedef internal::Residues_iterator_from_model<Self,false> Residues_iterator;
+
+  /** \ingroup grp_iters*/  
+  Residues_iterator residues_begin() {return Residues_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Residues_iterator residues_end()   {return Residues_iterator(*this,true);}
+
+  /** \ingroup grp_iters*/
+  Residues_const_iterator residues_begin() const {return Residues_const_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Residues_const_iterator residues_end()   const {return Residues_const_iterator(*this,true);}  
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_model<Self,true>  Atoms_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_model<Self,false> Atoms_iterator;
+  
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_begin() {return Atoms_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_end()   {return Atoms_iterator(*this,true);}
+
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_begin() const {return Atoms_const_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_end()   const {return Atoms_const_iterator(*this,true);}
+  //---------
+  
+  DECLARE_AND_ACCESS(model_number,int)
+
+private:
+  //new items will be appended in any order, finalize sorts them
+  void unsort(){
+    if (!is_sorted_) return;
+    is_sorted_=false;
+    residue_of_atom_.resize(atom_container_.size());
+    for (unsigned r=0;r<residue_container_.size();++r){
+      const Residue& res=residue_container_[r];
+      std::fill(residue_of_atom_.begin()+res.first_atom_,residue_of_atom_.begin()+res.first_atom_+res.number_of_atoms_,r);
+      residue_index_[Residue_key(res.chain_index_,res.key())]=r;
+    }
+  }
+  
+  unsigned chain_index(const Chain& chain) const {return &chain-&chain_container_[0];}
+  unsigned residue_index(const Residue& res) const {return &res-&residue_container_[0];}
+  
+  //index of the residue of chain with the given key, -1 if there is none
+  int find_residue(const Chain& chain,const std::pair<int,char>& key) const {
+    if (is_sorted_){
+      typename Residue_container::const_iterator begin=residue_container_.begin()+chain.first_residue_;
+      typename Residue_container::const_iterator end=begin+chain.number_of_residues_;
+      typename Residue_container::const_iterator it=std::lower_bound(begin,end,key,internal::Less_residue_key<Residue>());
+      if (it!=end && it->key()==key) return it-residue_container_.begin();
+      return -1;
+    }
+    typename boost::unordered_map<Residue_key,unsigned>::const_iterator it=residue_index_.find(Residue_key(chain_index(chain),key));
+    return it==residue_index_.end()?-1:static_cast<int>(it->second);
+  }
+  
+  //index of the residue of chain with the given key, -1 if it must be appended
+  int lookup_residue(const Chain& chain,const std::pair<int,char>& key){
+    unsigned c=chain_index(chain);
+    //same residue as the previous line
+    if (!residue_container_.empty()){
+      const Residue& last=residue_container_.back();
+      if (last.chain_index_==c && last.key()==key) return residue_container_.size()-1;
+    }
+    int index=find_residue(chain,key);
+    if (index==-1 && is_sorted_){
+      bool is_last_chain= c+1==chain_container_.size();
+      if (!is_last_chain || (chain.number_of_residues_!=0 && key < residue_container_.back().key()))
+        unsort();
+    }
+    return index;
+  }
+  
+  Residue& append_residue(const Chain& chain,const Name& resname,const std::pair<int,char>& key){
+    unsigned c=chain_index(chain);
+    const Residue* data=residue_container_.empty()?NULL:&residue_container_[0];
+    residue_container_.push_back(Residue(resname,key.first,key.second,*this,c,atom_container_.size()));
+    if (data!=NULL && data!=&residue_container_[0]) rebind_atoms();
+    unsigned r=residue_container_.size()-1;
+    if (is_sorted_) ++chain_container_[c].number_of_residues_;
+    else residue_index_[Residue_key(c,key)]=r;
+    return residue_container_[r];
+  }
+  
+  template<class Line_format,class Line>
+  void add_atom(Residue& res,const Line_format& line_format,const Line& line){
+    unsigned sn=line_format.get_atom_serial_number(line);
+    unsigned r=residue_index(res);
+    if (is_sorted_){
+      if (r+1==residue_container_.size() &&
+          (res.number_of_atoms_==0 || static_cast<unsigned>(atom_container_.back().atom_serial_number()) < sn))
+      {
+        atom_container_.push_back(Atom(line_format,line,res));
+        ++res.number_of_atoms_;
+        return;
+      }
+      if (res.find_atom(sn)!=-1){
+        assert(!"Two atoms with same serial numbers.");
+        return;
+      }
+      //serial numbers not increasing inside the last residue: only its atoms are shifted
+      if (r+1==residue_container_.size()){
+        typename Atom_container::iterator begin=atom_container_.begin()+res.first_atom_;
+        typename Atom_container::iterator end=begin+res.number_of_atoms_;
+        atom_container_.insert(std::lower_bound(begin,end,sn,internal::Less_atom_serial_number<Atom>()),Atom(line_format,line,res));
+        ++res.number_of_atoms_;
+        return;
+      }
+      unsort();
+    }
+    atom_container_.push_back(Atom(line_format,line,res));
+    residue_of_atom_.push_back(r);
+    ++res.number_of_atoms_;
+  }
+  
+  //coarse grain atoms are kept in residue order whatever the order they are created in
+  void insert_coarse_atom(Residue& res,const Coarse_atom& atom){
+    int r=residue_index(res);
+    unsigned pos=coarse_atom_container_.size();
+    if (res.number_of_coarse_atoms_!=0)
+      pos=res.first_coarse_atom_+res.number_of_coarse_atoms_;
+    else{
+      for (int k=r+1;k<=last_coarse_residue_;++k)
+        if (residue_container_[k].number_of_coarse_atoms_!=0){
+          pos=residue_container_[k].first_coarse_atom_;
+          break;
+        }
+      res.first_coarse_atom_=pos;
+    }
+    if (pos==coarse_atom_container_.size())
+      coarse_atom_container_.push_back(atom);
+    else{
+      coarse_atom_container_.insert(coarse_atom_container_.begin()+pos,atom);
+      for (int k=r+1;k<=last_coarse_residue_;++k)
+        if (residue_container_[k].number_of_coarse_atoms_!=0)
+          ++residue_container_[k].first_coarse_atom_;
+    }
+    coarse_atom_container_[pos].set_residue(res);
+    ++res.number_of_coarse_atoms_;
+    if (r>last_coarse_residue_) last_coarse_residue_=r;
+  }
+  
+  unsigned add_coarse_atom_member(unsigned first,unsigned n,const Atom& atom){
+    if (coarse_atom_member_container_.empty()) coarse_atom_member_container_.reserve(atom_container_.size());
+    return internal::append_to_range(coarse_atom_member_container_,first,n,static_cast<unsigned>(&atom-&atom_container_[0]));
+  }
+  
+  //makes atoms and coarse grain atoms point to their residue
+  void rebind_atoms(){
+    for (unsigned r=0;r<residue_container_.size();++r){
+      const Residue& res=residue_container_[r];
+      if (is_sorted_)
+        for (unsigned i=res.first_atom_;i<res.first_atom_+res.number_of_atoms_;++i)
+          atom_container_[i].set_residue(res);
+      for (unsigned i=res.first_coarse_atom_;i<res.first_coarse_atom_+res.number_of_coarse_atoms_;++i)
+        coarse_atom_container_[i].set_residue(res);
+    }
+    if (!is_sorted_)
+      for (unsigned i=0;i<atom_container_.size();++i)
+        atom_container_[i].set_residue(residue_container_[residue_of_atom_[i]]);
+  }
+};
+
+
+/** A class representing a chain of a ESBTL::Flat_model: a range of its residues.
+  * \tparam System is a system (like ESBTL::Molecular_system for example).
+  * \tparam Coarse_atom_ is the coarse grain atom type of the model.
+  */
+template<class System,class Coarse_atom_>
+class Flat_chain{
+public:
+  typedef typename System::Residue                  Residue;
+  typedef typename System::Atom                     Atom;
+  typedef std::vector<Residue>                      Residue_container;
+  typedef typename System::Model                    Model;
+private:
+  typedef Flat_chain<System,Coarse_atom_>           Self;
+  friend class Flat_model<System,Coarse_atom_>;
+  friend class Flat_residue<System,Coarse_atom_>;
+  
+  Model* model_;
+  unsigned first_residue_;
+  unsigned number_of_residues_;
+public:
+  Flat_chain(char id,Model& mod,unsigned first_residue):
+    model_(&mod),first_residue_(first_residue),number_of_residues_(0),chain_identifier_(id){}
+  
+  const Model& model() const {return *model_;}
+
+  template<class Line_format,class Line>
+  Residue& get_or_create_residue(const Line_format& line_format,const Line& line){
+    std::pair<int,char> key(line_format.get_residue_sequence_number(line),line_format.get_insertion_code(line));
+    int index=model_->lookup_residue(*this,key);
+    if (index!=-1) return model_->residue_container_[index];
+    return model_->append_residue(*this,line_format.get_residue_name(line),key);
+  }
+  
+  Residue& get_or_create_residue(const Name& resname,int ressn,char insc){
+    std::pair<int,char> key(ressn,insc);
+    int index=model_->lookup_residue(*this,key);
+    if (index!=-1) return model_->residue_container_[index];
+    return model_->append_residue(*this,resname,key);
+  }
+  
+  const Residue& get_residue(int ressn,char insc=' ') const {
+    int index=model_->find_residue(*this,std::make_pair(ressn,insc));
+    assert (index!=-1);
+    return model_->residue_container_[index];
+  }
+  
+  const Atom& get_atom(int ressn,char insc,unsigned atom_sn) const {
+    return get_residue(ressn,insc).get_atom(atom_sn);
+  }
+  
+  size_t number_of_residues() const {
+    return number_of_residues_;
+  }
+
+  size_t number_of_atoms() const {
+    if (number_of_residues_==0) return 0;
+    const Residue& first=model_->residue_container_[first_residue_];
+    const Residue& last=model_->residue_container_[first_residue_+number_of_residues_-1];
+    return last.first_atom_+last.number_of_atoms_-first.first_atom_;
+  }
+  
+  //iterators
+  //---------
+  //functions needed by generic iterator in iterators.h 
+  static const Residue& dereference (typename Residue_container::const_iterator it) {return *it;}
+  static Residue& dereference (typename Residue_container::iterator it) {return *it;}
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Residues_iterator_from_chain<Self,true>  Residues_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef internal::Residues_iterator_from_chain<Self,false> Residues_iterator;
+  
+  /** \ingroup grp_iters*/
+  Residues_iterator residues_begin() {return Residues_iterator(model_->residue_container_.begin()+first_residue_);}
+  /** \ingroup grp_iters*/
+  Residues_iterator residues_end()   {return Residues_iterator(model_->residue_container_.begin()+first_residue_+number_of_residues_);}  
+
+  /** \ingroup grp_iters*/
+  Residues_const_iterator residues_begin() const {return Residues_const_iterator(residues().begin()+first_residue_);}
+  /** \ingroup grp_iters*/
+  Residues_const_iterator residues_end()   const {return Residues_const_iterator(residues().begin()+first_residue_+number_of_residues_);}
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_chain<Self,true>  Atoms_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_chain<Self,false> Atoms_iterator;
+  
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_begin() {return Atoms_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_end()   {return Atoms_iterator(*this,true);}  
+
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_begin() const {return Atoms_const_iterator(*this);}
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_end()   const {return Atoms_const_iterator(*this,true);}  
+  //-------
+  
+  DECLARE_AND_ACCESS(chain_identifier,char)
+  
+private:
+  const Residue_container& residues() const {return model_->residue_container_;}
+};
+
+
+/** A class representing a residue of a ESBTL::Flat_model: a range of its atoms and a range of its coarse grain atoms.
+  * Coarse grain functions are those of ESBTL::Coarse_residue and can only be used if Coarse_atom_ is a coarse grain atom type.
+  * \tparam System is a system (like ESBTL::Molecular_system for example).
+  * \tparam Coarse_atom_ is the coarse grain atom type of the model.
+  */
+template<class System,class Coarse_atom_>
+class Flat_residue{
+public:
+  typedef typename System::Atom          Atom;
+  typedef typename System::Chain         Chain;
+  typedef typename System::Model         Model;
+  typedef std::vector<Atom>              Atom_container;
+  typedef Coarse_atom_                   Coarse_atom;
+  typedef std::vector<Coarse_atom_>      Coarse_atom_container;
+private:
+  typedef Flat_residue<System,Coarse_atom_>      Self;
+  friend class Flat_model<System,Coarse_atom_>;
+  friend class Flat_chain<System,Coarse_atom_>;
+  friend class internal::Flat_coarse_atom_inserter<Self>;
+  
+  Model* model_;
+  unsigned chain_index_;
+  unsigned first_atom_;
+  unsigned number_of_atoms_;
+  unsigned first_coarse_atom_;
+  unsigned number_of_coarse_atoms_;
+public:
+  Flat_residue(const Name& resname,int index,char insc,Model& mod,unsigned chain_index,unsigned first_atom):
+    model_(&mod),chain_index_(chain_index),first_atom_(first_atom),number_of_atoms_(0),
+    first_coarse_atom_(0),number_of_coarse_atoms_(0),
+    residue_name_(resname),residue_sequence_number_(index),insertion_code_(insc){}
+
+  const Chain& chain() const {return model_->chain_container_[chain_index_];}
+  char chain_identifier() const {return chain().chain_identifier();}
+  /** Index of the chain of this residue in its model. */
+  unsigned chain_index() const {return chain_index_;}
+  /** Key of this residue in its chain (as in the map-based layout). */
+  std::pair<int,char> key() const {return std::make_pair(residue_sequence_number_,insertion_code_);}
+  
+  template<class Line_format,class Line>    
+  void add_atom(const Line_format& line_format, const Line& line){
+    model_->add_atom(*this,line_format,line);
+  }
+
+  size_t number_of_atoms() const {
+    return number_of_atoms_;
+  }
+  
+  const Atom& get_atom(unsigned sn) const {
+    int index=find_atom(sn);
+    assert(index!=-1);
+    return model_->atom_container_[index];
+  }
+  
+  /**
+    * Method to insert the coarse grain atoms into that residue,
+    * using a coarse grain atom creator.
+    * \tparam A coarse grain atom creator model of the concept of \ref coarse_creator.
+    */      
+  template <class Coarse_creator>
+  int create_coarse_atoms(const Coarse_creator& creator){
+    return creator(*this,internal::Flat_coarse_atom_inserter<Self>(*this));
+  }
+
+  /**
+    * Method to insert a coarse grain atoms using a point.
+    * \param pt is the coordinates of the pseudo-atom to be added.
+    * \param i is the index of the pseudo-atom (when a residue is modeled by several).
+    */        
+  void add_coarse_atom(const typename Atom::Point_3& pt,unsigned i=0){
+    insert_coarse_atom(Coarse_atom(pt,i,*this));
+  }
+  
+  const Coarse_atom get_coarse_atom(unsigned i) const {
+    return model_->coarse_atom_container_[first_coarse_atom_+i];
+  }
+  
+//doxygen should not read this
+/// \cond
+  //coarse atom members are stored by the model: as for Coarse_residue, creating coarse atoms through a const residue
+  //writes them, and must not run concurrently with another creation or with reads of coarse atoms of the same model
+  unsigned add_coarse_atom_member(unsigned first,unsigned n,const Atom& atom) const {
+    return model_->add_coarse_atom_member(first,n,atom);
+  }
+  
+  const Atom& coarse_atom_member(unsigned i) const {
+    return model_->atom_container_[model_->coarse_atom_member_container_[i]];
+  }
+/// \endcond
+  
+  //iterators
+  //---------
+  //functions needed by generic iterator in iterators.h 
+  static const Atom& dereference (typename Atom_container::const_iterator it) {return *it;}
+  static Atom& dereference (typename Atom_container::iterator it) {return *it;}
+  static const Coarse_atom& dereference(typename Coarse_atom_container::const_iterator it){ return *it;}
+  static Coarse_atom& dereference(typename Coarse_atom_container::iterator it){ return *it;}
+  
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_residue<Self,true>  Atoms_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef internal::Atoms_iterator_from_residue<Self,false> Atoms_iterator;
+  
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_begin() {return Atoms_iterator(atoms_first(),atoms_first()+number_of_atoms_);}
+  /** \ingroup grp_iters*/
+  Atoms_iterator atoms_end()   {return Atoms_iterator(atoms_first()+number_of_atoms_);}  
+
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_begin() const {return Atoms_const_iterator(atoms_first(),atoms_first()+number_of_atoms_);}
+  /** \ingroup grp_iters*/
+  Atoms_const_iterator atoms_end()   const {return Atoms_const_iterator(atoms_first()+number_of_atoms_);}
+  
+  /** \ingroup grp_iters*/
+  typedef typename Coarse_atom_container::const_iterator Coarse_atom_const_iterator;
+  /** \ingroup grp_iters*/
+  typedef typename Coarse_atom_container::iterator Coarse_atom_iterator;
+  /** \ingroup grp_iters*/
+  Coarse_atom_const_iterator coarse_atoms_begin() const {return coarse_atoms_first();}
+  /** \ingroup grp_iters*/
+  Coarse_atom_const_iterator coarse_atoms_end()   const {return coarse_atoms_first()+number_of_coarse_atoms_;}
+  /** \ingroup grp_iters*/
+  Coarse_atom_iterator coarse_atoms_begin() {return coarse_atoms_first();}
+  /** \ingroup grp_iters*/
+  Coarse_atom_iterator coarse_atoms_end()   {return coarse_atoms_first()+number_of_coarse_atoms_;}
+  //-------  
+  
+  DECLARE_AND_ACCESS(residue_name,Name)
+  DECLARE_AND_ACCESS(residue_sequence_number,int)
+  DECLARE_AND_ACCESS(insertion_code,char)
+  
+private:
+  typename Atom_container::iterator atoms_first() {return model_->atom_container_.begin()+first_atom_;}
+  typename Atom_container::const_iterator atoms_first() const {
+    const Atom_container& atoms=model_->atom_container_;
+    return atoms.begin()+first_atom_;
+  }
+  typename Coarse_atom_container::iterator coarse_atoms_first() {return model_->coarse_atom_container_.begin()+first_coarse_atom_;}
+  typename Coarse_atom_container::const_iterator coarse_atoms_first() const {
+    const Coarse_atom_container& coarse_atoms=model_->coarse_atom_container_;
+    return coarse_atoms.begin()+first_coarse_atom_;
+  }
+  
+  void insert_coarse_atom(const Coarse_atom& atom){
+    model_->insert_coarse_atom(*this,atom);
+  }
+  
+  //index of the atom with serial number sn, -1 if there is none
+  int find_atom(unsigned sn) const {
+    const Atom_container& atoms=model_->atom_container_;
+    typename Atom_container::const_iterator begin=atoms.begin()+first_atom_;
+    typename Atom_container::const_iterator end=begin+number_of_atoms_;
+    typename Atom_container::const_iterator it=std::lower_bound(begin,end,sn,internal::Less_atom_serial_number<Atom>());
+    if (it!=end && static_cast<unsigned>(it->atom_serial_number())==sn) return it-atoms.begin();
+    return -1;
+  }
+};
+
+
+/** An all-atom system items gathering wrappers
+  * that define a model, chain, residue and atom type from the types
+  * Flat_model, Flat_chain, Flat_residue and Molecular_atom respectively.
+  * The chains, residues and atoms of each model are stored in contiguous arrays instead of the maps of Default_system_items.
+  */
+struct Flat_system_items{
+  template <class System,class Point>
+  struct Model_wrapper{
+    typedef Flat_model<System,internal::No_coarse_atom>     Type;
+  };
+  
+  template <class System,class Point>
+  struct Chain_wrapper{
+    typedef Flat_chain<System,internal::No_coarse_atom>     Type;
+  };
+  
+  template <class System,class Point>
+  struct Residue_wrapper{
+    typedef Flat_residue<System,internal::No_coarse_atom>   Type;
+  };
+  
+  template <class System,class Point>
+  struct Atom_wrapper{
+    typedef Molecular_atom<System,Point>  Type;
+  };  
+};
+
+/** An all-atom and coarse-grain system items gathering wrappers
+  * that define a model, chain, residue and atom type from the types
+  * Flat_model, Flat_chain, Flat_residue and Molecular_atom respectively, with ESBTL::Coarse_atom as coarse grain atoms.
+  * The chains, residues and atoms of each model are stored in contiguous arrays instead of the maps of System_items_with_coarse_grain.
+  */
+struct Flat_system_items_with_coarse_grain{
+  template <class System,class Point_3>
+  class Model_wrapper{
+    typedef Coarse_atom<Molecular_atom<System,Point_3>,Point_3> Coarse;
+  public:
+    typedef Flat_model<System,Coarse>       Type;
+  };
+  
+  template <class System,class Point_3>
+  class Chain_wrapper{
+    typedef Coarse_atom<Molecular_atom<System,Point_3>,Point_3> Coarse;
+  public:
+    typedef Flat_chain<System,Coarse>       Type;
+  };
+  
+  template <class System,class Point_3>
+  struct Atom_wrapper{
+    typedef Molecular_atom<System,Point_3>  Type;
+  };  
+  
+  template <class System,class Point_3>
+  class Residue_wrapper{
+    typedef Coarse_atom<Molecular_atom<System,Point_3>,Point_3> Coarse;
+  public:
+    typedef Flat_residue<System,Coarse>     Type;
+  };
+};
+
+
+//global access functions
+//for chains
+  template <class System,class Coarse_atom_>
+  char get_chain_identifier(const Flat_chain<System,Coarse_atom_>& c) {return c.chain_identifier();}
+//for residues
+  template <class System,class Coarse_atom_>
+  const Name& get_residue_name(const Flat_residue<System,Coarse_atom_>& r) {return r.residue_name();}
+  template <class System,class Coarse_atom_>
+  int get_residue_sequence_number(const Flat_residue<System,Coarse_atom_>& r) {return r.residue_sequence_number();}
+  template <class System,class Coarse_atom_>
+  char get_insertion_code(const Flat_residue<System,Coarse_atom_>& r) {return r.insertion_code();}
+
+}// namespace ESBTL
+
+#endif //ESBTL_FLAT_SYSTEM_H
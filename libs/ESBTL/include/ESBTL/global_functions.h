@@ -36,6 +36,7 @@
 #define ESBTL_GLOBAL_FUNCTIONS_H
 
 #include <fstream>
+#include <ESBTL/name.h>
 
 namespace ESBTL {
 
@@ -52,12 +53,16 @@ template <class Atom>
 bool is_backbone(const Atom& atom){
   if (get_is_hetatm(atom))
     return false;
-  std::string atomname=get_atom_name(atom);
-  return atomname=="N"   ||
-         atomname=="CA"  ||
-         atomname=="C"   ||
-         atomname=="O"   ||
-         atomname=="OXT";
+  switch( Name(get_atom_name(atom)).id() ){
+    case Name_id<'N'>::value:
+    case Name_id<'C','A'>::value:
+    case Name_id<'C'>::value:
+    case Name_id<'O'>::value:
+    case Name_id<'O','X','T'>::value:
+      return true;
+    default:
+      return false;
+  }
 }
 
 /**
@@ -72,7 +77,7 @@ template <class Atom>
 bool is_side_chain_or_CA(const Atom& atom){
   if (atom.is_hetatm())
     return false;
-  return !is_backbone(atom) || get_atom_name(atom)=="CA";
+  return !is_backbone(atom) || Name(get_atom_name(atom)).id()==Name_id<'C','A'>::value;
 }
 
 /**
@@ -83,7 +88,7 @@ bool is_side_chain_or_CA(const Atom& atom){
   */
 template <class Atom>
 bool is_hydrogen(const Atom& atom){
-  return get_element(atom) == std::string("H");
+  return Name(get_element(atom)).id()==Name_id<'H'>::value;
 }
 
 /**
@@ -95,8 +100,14 @@ bool is_hydrogen(const Atom& atom){
   */
 template <class Atom>
 bool is_water(const Atom& atom){
-  std::string resname=get_residue_name(atom);
-  return resname=="HOH" || resname=="SOL" || resname=="WAT";
+  switch( Name(get_residue_name(atom)).id() ){
+    case Name_id<'H','O','H'>::value:
+    case Name_id<'S','O','L'>::value:
+    case Name_id<'W','A','T'>::value:
+      return true;
+    default:
+      return false;
+  }
 }
 
 
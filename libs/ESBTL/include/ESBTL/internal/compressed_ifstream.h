@@ -37,20 +37,57 @@
 
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define ESBTL_NO_MMAP
+#endif
+
+#ifndef ESBTL_NO_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
 
 namespace ESBTL{
 /** Modes available to read a PDB file:
   * - ASCII stands for a non-compressed standard text file.
   * - BZIP2 stands for a compressed file using bzip2 algorithm (see http://www.bzip.org/).
   * - GZIP stands for a compressed file using gzip algorithm (see http://www.gzip.org/). 
+  * - MMAP stands for a non-compressed standard text file that is memory-mapped: lines are
+  *   given to the line selector and to the builder as ESBTL::Line_span, without being copied.
+  *   On platforms without mmap (or if ESBTL_NO_MMAP is defined), the file is read at once in memory.
+  * - AUTO stands for a file whose encoding is detected from its first bytes (see ESBTL::detect_reading_mode).
   */
-enum Reading_mode {ASCII,BZIP2,GZIP};
+enum Reading_mode {ASCII,BZIP2,GZIP,MMAP,AUTO};
+
+/** Returns the encoding of a file, using the magic bytes of gzip and bzip2 files.
+  * \param filename is the name of the file.
+  * \param uncompressed is the mode returned if the file is not compressed (or cannot be read).
+  */
+inline Reading_mode detect_reading_mode(const std::string& filename,Reading_mode uncompressed=MMAP){
+  std::ifstream input(filename.c_str(),std::ios_base::binary);
+  unsigned char magic[3]={0,0,0};
+  input.read(reinterpret_cast<char*>(magic),3);
+  if (input.gcount()>=2 && magic[0]==0x1f && magic[1]==0x8b) return GZIP;
+  if (input.gcount()==3 && magic[0]=='B' && magic[1]=='Z' && magic[2]=='h') return BZIP2;
+  return uncompressed;
+}
+
+//defined in <ESBTL/compressed_ifstream.h>
+template <Reading_mode mode>
+class Decompression_pipeline;
 }//namespace ESBTL
 
 namespace ESBTL{
 /** \cond */
 namespace internal{
   
+  template <Reading_mode mode>
+  struct Reading_mode_tag{};
+  
   template <Reading_mode mode>
   class Ifstream_compress;
 
@@ -60,6 +97,72 @@ namespace internal{
     public:
     std::ifstream& get(std::ifstream& input) const {return input;}
   };
+  
+  //read-only view of the whole content of a file
+  class Mapped_file{
+    const char* data_;
+    std::size_t size_;
+    #ifdef ESBTL_NO_MMAP
+    std::vector<char> buffer_;
+    #endif
+    
+    Mapped_file(const Mapped_file&);
+    Mapped_file& operator=(const Mapped_file&);
+  public:
+    Mapped_file():data_(NULL),size_(0){}
+    ~Mapped_file(){close();}
+    
+    bool open(const std::string& filename){
+      close();
+      #ifndef ESBTL_NO_MMAP
+      int fd=::open(filename.c_str(),O_RDONLY);
+      if (fd==-1) return false;
+      struct stat st;
+      if (fstat(fd,&st)==-1){
+        ::close(fd);
+        return false;
+      }
+      size_=static_cast<std::size_t>(st.st_size);
+      if (size_!=0){
+        void* addr=mmap(NULL,size_,PROT_READ,MAP_PRIVATE,fd,0);
+        if (addr==MAP_FAILED){
+          ::close(fd);
+          size_=0;
+          return false;
+        }
+        madvise(addr,size_,MADV_SEQUENTIAL);
+        data_=static_cast<const char*>(addr);
+      }
+      //the mapping remains valid after the file descriptor is closed
+      ::close(fd);
+      return true;
+      #else
+      std::ifstream input(filename.c_str(),std::ios_base::binary);
+      if (!input) return false;
+      input.seekg(0,std::ios_base::end);
+      buffer_.resize(static_cast<std::size_t>(input.tellg()));
+      input.seekg(0,std::ios_base::beg);
+      if (!buffer_.empty()) input.read(&buffer_[0],buffer_.size());
+      size_=buffer_.size();
+      data_=buffer_.empty()?NULL:&buffer_[0];
+      return true;
+      #endif
+    }
+    
+    void close(){
+      #ifndef ESBTL_NO_MMAP
+      if (data_!=NULL)
+        munmap(const_cast<char*>(data_),size_);
+      #else
+      std::vector<char>().swap(buffer_);
+      #endif
+      data_=NULL;
+      size_=0;
+    }
+    
+    const char* data() const {return data_;}
+    std::size_t size() const {return size_;}
+  };
 
 } //namespace internal
 /** \endcond */
@@ -0,0 +1,191 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+#ifndef ESBTL_INTERNAL_PERFECT_HASH_TABLE_H
+#define ESBTL_INTERNAL_PERFECT_HASH_TABLE_H
+
+#include <boost/cstdint.hpp>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <iostream>
+#include <cstdlib>
+#include <cassert>
+
+namespace ESBTL{
+namespace internal{
+
+/**
+  * A read-only table mapping integer keys to unsigned values, built once from a set of entries.
+  * It uses a hash-and-displace scheme: the high bits of the hash of a key select a bucket,
+  * whose displacement moves the low bits of the hash to a slot holding no other key.
+  * A lookup is thus one hash, two loads and a comparison, without probing nor memory allocation.
+  */
+class Perfect_hash_table{
+public:
+  typedef std::pair<boost::uint64_t,unsigned> Entry;
+
+  Perfect_hash_table():seed_(0),bucket_shift_(63),mask_(1),slots_(2),displacements_(2,0){}
+
+  /** Builds the table from entries with distinct keys (the program exits otherwise). */
+  void build(const std::vector<Entry>& entries){
+    //two entries with the same key can never be placed, whatever the seed
+    std::vector<boost::uint64_t> keys(entries.size());
+    for (std::size_t i=0;i!=entries.size();++i) keys[i]=entries[i].first;
+    std::sort(keys.begin(),keys.end());
+    std::vector<boost::uint64_t>::const_iterator duplicate=std::adjacent_find(keys.begin(),keys.end());
+    if (duplicate!=keys.end()){
+      std::cerr << "Fatal error: key " << *duplicate << " is given twice to a perfect hash table.\n";
+      exit(EXIT_FAILURE);
+    }
+    
+    std::size_t nb_slots=2;
+    while (nb_slots < entries.size()+entries.size()/4) nb_slots*=2;
+    unsigned bucket_bits=1;
+    while ( (std::size_t(1) << bucket_bits) < entries.size()/2 ) ++bucket_bits;
+    
+    //a seed rarely fails (two keys of a bucket with the same low bits), the table is enlarged if several fail.
+    for (boost::uint64_t seed=0;!try_build(entries,seed,nb_slots,bucket_bits);++seed){
+      if (seed+1==max_seeds){
+        std::cerr << "Fatal error: no perfect hash table found for " << entries.size() << " keys after " << max_seeds << " seeds.\n";
+        exit(EXIT_FAILURE);
+      }
+      if (seed%8==7) nb_slots*=2;
+    }
+  }
+
+  /** Finds the value of key, returns false if key is not in the table.*/
+  bool find(boost::uint64_t key,unsigned& value) const {
+    boost::uint64_t h=hash(key);
+    const Slot& s=slots_[slot(h,displacements_[h >> bucket_shift_])];
+    value=s.value;
+    return s.used && s.key==key;
+  }
+
+private:
+  //the table is 2^(max_seeds/8) times larger than needed when the last seed is tried
+  static const unsigned max_seeds=64;
+  
+  //the finalizer of MurmurHash3
+  boost::uint64_t hash(boost::uint64_t key) const {
+    key^=seed_;
+    key^=key >> 33;
+    key*=UINT64_C(0xff51afd7ed558ccd);
+    key^=key >> 33;
+    key*=UINT64_C(0xc4ceb9fe1a85ec53);
+    key^=key >> 33;
+    return key;
+  }
+
+  bool try_build(const std::vector<Entry>& entries,boost::uint64_t seed,std::size_t nb_slots,unsigned bucket_bits){
+    seed_=seed;
+    bucket_shift_=64-bucket_bits;
+    mask_=nb_slots-1;
+    slots_.assign(nb_slots,Slot());
+    displacements_.assign(std::size_t(1) << bucket_bits,0);
+    
+    //entries grouped by bucket (counting sort): bucket b holds entries of by_bucket[first[b]] to by_bucket[first[b+1]-1]
+    std::vector<boost::uint64_t> hashes(entries.size());
+    std::vector<std::size_t> first(displacements_.size()+1,0);
+    for (std::size_t i=0;i!=entries.size();++i){
+      hashes[i]=hash(entries[i].first);
+      ++first[(hashes[i] >> bucket_shift_)+1];
+    }
+    std::size_t max_size=0;
+    for (std::size_t b=0;b!=displacements_.size();++b){
+      max_size=(std::max)(max_size,first[b+1]);
+      first[b+1]+=first[b];
+    }
+    std::vector<std::size_t> by_bucket(entries.size());
+    std::vector<std::size_t> next(first.begin(),first.end()-1);
+    for (std::size_t i=0;i!=entries.size();++i)
+      by_bucket[next[hashes[i] >> bucket_shift_]++]=i;
+    
+    //largest buckets are placed first, while the table is almost empty
+    for (std::size_t size=max_size;size!=0;--size)
+      for (std::size_t b=0;b!=displacements_.size();++b){
+        if (first[b+1]-first[b]!=size) continue;
+        boost::uint64_t d=0;
+        for (;d<=mask_;++d)
+          if (place(entries,hashes,&by_bucket[first[b]],size,d)) break;
+        if (d>mask_) return false;
+        displacements_[b]=d;
+      }
+    return true;
+  }
+  
+  //the low bits of the hash are moved by a multiple of the displacement, the factor being other bits of the hash,
+  //so that two keys of a bucket only get the same slot for all displacements if both parts of their hashes are equal
+  std::size_t slot(boost::uint64_t h,boost::uint64_t d) const {
+    return static_cast<std::size_t>( (h + d * ((h >> 32) | 1)) & mask_ );
+  }
+  
+  //places the entries of a bucket with displacement d, if all of them fall in free slots
+  bool place(const std::vector<Entry>& entries,const std::vector<boost::uint64_t>& hashes,
+             const std::size_t* bucket,std::size_t size,boost::uint64_t d)
+  {
+    std::size_t nb_placed=0;
+    for (;nb_placed!=size;++nb_placed){
+      std::size_t s=slot(hashes[bucket[nb_placed]],d);
+      if (slots_[s].used) break;
+      slots_[s].used=true;
+      slots_[s].key=entries[bucket[nb_placed]].first;
+      slots_[s].value=entries[bucket[nb_placed]].second;
+    }
+    if (nb_placed==size) return true;
+    while (nb_placed!=0){
+      --nb_placed;
+      slots_[slot(hashes[bucket[nb_placed]],d)].used=false;
+    }
+    return false;
+  }
+
+  //a key and its value are stored together, so that a lookup reads a single cache line
+  struct Slot{
+    Slot():key(0),value(0),used(false){}
+    boost::uint64_t key;
+    unsigned value;
+    bool used;
+  };
+
+  boost::uint64_t seed_;
+  unsigned bucket_shift_;
+  boost::uint64_t mask_;
+  std::vector<Slot> slots_;
+  std::vector<boost::uint64_t> displacements_;
+};
+
+} } //namespace ESBTL::internal
+
+#endif //ESBTL_INTERNAL_PERFECT_HASH_TABLE_H
@@ -35,9 +35,67 @@
 #ifndef ESBTL_LINE_READER_H
 #define ESBTL_LINE_READER_H
 
+#include <cstring>
+#include <vector>
+#include <algorithm>
 #include <ESBTL/internal/compressed_ifstream.h>
+#include <ESBTL/line_span.h>
+#include <ESBTL/occupancy_handlers.h>
+#include <ESBTL/builder.h>
 
 namespace ESBTL{
+
+/** \cond */
+namespace internal{
+
+//counts the chains, residues and atoms of the current model of a system, during ESBTL::Line_reader::count_lines
+class Model_line_counter{
+  bool has_model;
+  int model_number;
+  char chain_identifier;
+  int residue_sequence_number;
+  char insertion_code;
+  unsigned nb_chains;
+  unsigned nb_residues;
+  unsigned nb_atoms;
+public:
+  Model_line_counter():has_model(false),model_number(0),chain_identifier(' '),residue_sequence_number(0),insertion_code(' '),
+    nb_chains(0),nb_residues(0),nb_atoms(0){}
+  
+  template <class Line_format,class Line>
+  void add_line(const Line_format& line_format,const Line& line,int model,System_size& size){
+    char ch=line_format.get_chain_identifier(line);
+    int ressn=line_format.get_residue_sequence_number(line);
+    char insc=line_format.get_insertion_code(line);
+    if (!has_model || model!=model_number){
+      close(size);
+      has_model=true;
+      model_number=model;
+      ++size.nb_models;
+      nb_chains=nb_residues=nb_atoms=0;
+    }
+    if (nb_atoms==0 || ch!=chain_identifier){
+      ++nb_chains;
+      ++nb_residues;
+    }
+    else
+      if (ressn!=residue_sequence_number || insc!=insertion_code) ++nb_residues;
+    chain_identifier=ch;
+    residue_sequence_number=ressn;
+    insertion_code=insc;
+    ++nb_atoms;
+  }
+  
+  //updates the size of the system with the current model
+  void close(System_size& size) const {
+    size.nb_chains=(std::max)(size.nb_chains,nb_chains);
+    size.nb_residues=(std::max)(size.nb_residues,nb_residues);
+    size.nb_atoms=(std::max)(size.nb_atoms,nb_atoms);
+  }
+};
+
+} //namespace internal
+/** \endcond */
   
 /** 
   * Class responsible for reading the lines of a file and provide
@@ -51,6 +109,41 @@ class Line_reader{
   Line_selector& line_selector;
   Builder& builder;
 
+protected:
+  //handle one line of the file. Returns true if the line was given to the builder.
+  template <class Occupancy_handler,class Line>
+  bool read_line(const Line& line,Occupancy_handler& occupancy,char& default_altloc){
+    Line_format line_format(line);
+    
+    int system_index=line_selector.keep(line_format,line,occupancy);
+    
+    if (system_index!=DISCARD){
+      //TODO warning Put inside selector: we could think of a different policy
+      char altloc=line_format.get_alternate_location(line);
+      if (altloc!=' '){
+        if (default_altloc==' ')
+          default_altloc=altloc;
+        else
+          if (altloc!=default_altloc) return false;
+      }
+      
+      builder.interpret_line(line_format,line,system_index);
+      return true;
+    }
+    return false;
+  }
+  
+  template <class Occupancy_handler>
+  bool finalize(int nblines,Occupancy_handler& occupancy,char default_altloc){
+    nblines+=occupancy.finalize(builder);
+    builder.create_systems(default_altloc);
+    
+    #ifndef NDEBUG
+    std::cout << "(ESBTL-DEBUG) Lines read " << nblines << std::endl;    
+    #endif
+    return true;
+  }
+  
   template <class Occupancy_handler,class Ifstream>
   bool read_stream(Ifstream& input,Occupancy_handler occupancy,char default_altloc=char(' ')){
     int nblines=0;
@@ -60,39 +153,173 @@ class Line_reader{
       getline(input,line);
       if (line.empty()) continue;
       
-      
-      Line_format line_format(line);
-      
-      int system_index=line_selector.keep(line_format,line,occupancy);
-      
-      if (system_index!=DISCARD){
-        //TODO warning Put inside selector: we could think of a different policy
-        char altloc=line_format.get_alternate_location(line);
-        if (altloc!=' '){
-          if (default_altloc==' ')
-            default_altloc=altloc;
-          else
-            if (altloc!=default_altloc) continue;
-        }
-        
-        builder.interpret_line(line_format,line,system_index);
-        ++nblines;        
-      }
+      if (read_line(line,occupancy,default_altloc))
+        ++nblines;
     }
     
-    nblines+=occupancy.finalize(builder);
-    builder.create_systems(default_altloc);
+    return finalize(nblines,occupancy,default_altloc);
+  }
+  
+  template <Reading_mode mode,class Occupancy_handler>
+  bool read_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc,internal::Reading_mode_tag<mode>){
+    //binary flags prevent from interpretation of some symbols \r\n for example
+    std::ifstream input( filename.c_str(),std::ios_base::binary );
+
+    if (! input){
+      std::cerr << "Problem while trying to open file " << filename << ".\nPlease check that the file exists and that you have the right to read it."  << std::endl;
+      return false;   
+    }
+    
+    internal::Ifstream_compress<mode> stream;
+    return read_stream(stream.get(input),occupancy,default_altloc);
+  }
+  
+  template <class Occupancy_handler>
+  bool read_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc,internal::Reading_mode_tag<MMAP>){
+    internal::Mapped_file input;
+    
+    if (! input.open(filename) ){
+      std::cerr << "Problem while trying to open file " << filename << ".\nPlease check that the file exists and that you have the right to read it."  << std::endl;
+      return false;   
+    }
+    
+    return read_buffer(input.data(),input.data()+input.size(),occupancy,default_altloc);
+  }
+  
+  template <Reading_mode mode,class Occupancy_handler>
+  bool read_compressed_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc){
+    Decompression_pipeline<mode> input;
     
+    if (! input.open(filename) ){
+      std::cerr << "Problem while trying to open file " << filename << ".\nPlease check that the file exists and that you have the right to read it."  << std::endl;
+      return false;   
+    }
+    
+    bool res=read_lines(input,occupancy,default_altloc);
+    if (input.failed()){
+      std::cerr << "Problem while decompressing file " << filename << "." << std::endl;
+      return false;
+    }
     #ifndef NDEBUG
-    std::cout << "(ESBTL-DEBUG) Lines read " << nblines << std::endl;    
+    std::cout << "(ESBTL-DEBUG) " << input.statistics() << std::endl;
     #endif
-    return true;
+    return res;
+  }
+  
+  template <class Occupancy_handler>
+  bool read_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc,internal::Reading_mode_tag<GZIP>){
+    return read_compressed_file<GZIP>(filename,occupancy,default_altloc);
+  }
+  
+  template <class Occupancy_handler>
+  bool read_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc,internal::Reading_mode_tag<BZIP2>){
+    return read_compressed_file<BZIP2>(filename,occupancy,default_altloc);
+  }
+  
+  template <class Occupancy_handler>
+  bool read_file(const std::string& filename,Occupancy_handler occupancy,char default_altloc,internal::Reading_mode_tag<AUTO>){
+    switch (detect_reading_mode(filename)){
+      case GZIP:
+        return read_file(filename,occupancy,default_altloc,internal::Reading_mode_tag<GZIP>());
+      case BZIP2:
+        return read_file(filename,occupancy,default_altloc,internal::Reading_mode_tag<BZIP2>());
+      default:
+        return read_file(filename,occupancy,default_altloc,internal::Reading_mode_tag<MMAP>());
+    }
   }
   
 public:
   /** Constructor.*/
   Line_reader(Line_selector& line_selector, Builder& builder):line_selector(line_selector),builder(builder){}
   
+  /** Reads the lines given by a line source and give instruction to the builder to construct molecular system(s).
+    * \tparam Line_source must have a method <TT>bool next_line(ESBTL::Line_span&)</TT> returning false once all lines
+    * have been given (like ESBTL::Decompression_pipeline).
+    * The other parameters are the same as those of read.
+    */
+  template <class Line_source,class Occupancy_handler>
+  bool read_lines(Line_source& input,Occupancy_handler occupancy,char default_altloc=' '){
+    int nblines=0;
+    Line_span line;
+    
+    while ( input.next_line(line) ){
+      if (line.empty()) continue;
+      
+      if (read_line(line,occupancy,default_altloc))
+        ++nblines;
+    }
+    
+    return finalize(nblines,occupancy,default_altloc);
+  }
+  
+  /** Reads the lines of a buffer in memory (like a part of a memory-mapped file), without copying them.
+    * \param begin is the first character of the buffer.
+    * \param end is past the last character of the buffer.
+    * The other parameters are the same as those of read.
+    */
+  template <class Occupancy_handler>
+  bool read_buffer(const char* begin,const char* end,Occupancy_handler occupancy,char default_altloc=char(' ')){
+    int nblines=0;
+    
+    while (begin!=end){
+      const char* eol=static_cast<const char*>( memchr(begin,'\n',end-begin) );
+      if (eol==NULL) eol=end;
+      Line_span line(begin,eol);
+      begin=(eol==end)?end:eol+1;
+      if (line.empty()) continue;
+      
+      if (read_line(line,occupancy,default_altloc))
+        ++nblines;
+    }
+    
+    return finalize(nblines,occupancy,default_altloc);
+  }
+  
+  
+  /** Counts the lines of a buffer that read_buffer would give to each system, without building anything.
+    * \param begin is the first character of the buffer.
+    * \param end is past the last character of the buffer.
+    * \return the size of system i+1 at index i. Every change of chain or residue between consecutive lines
+    * of a model is counted, and lines are counted whatever their occupancy and alternate location, so that the
+    * sizes are upper bounds. The line selector is copied, its state is not modified.
+    *
+    * This pass is cheap compared to building the systems when the buffer is in memory (like a memory-mapped file).
+    * Giving its result to ESBTL::All_atom_system_builder::reserve before read_buffer lets the builder
+    * reserve the storage of the models up front.
+    */
+  std::vector<System_size> count_lines(const char* begin,const char* end) const {
+    Line_selector selector(line_selector);
+    Accept_all_occupancy_policy<Line_format> occupancy;
+    std::vector<System_size> sizes;
+    std::vector<internal::Model_line_counter> models;
+    int current_model=1;
+    
+    while (begin!=end){
+      const char* eol=static_cast<const char*>( memchr(begin,'\n',end-begin) );
+      if (eol==NULL) eol=end;
+      Line_span line(begin,eol);
+      begin=(eol==end)?end:eol+1;
+      if (line.empty()) continue;
+      
+      Line_format line_format(line);
+      int system_index=selector.keep(line_format,line,occupancy);
+      if (system_index==DISCARD) continue;
+      if (system_index==RMK){
+        if (line_format.record_type()==PDB::MODEL)
+          current_model=line_format.get_model_number(line);
+        continue;
+      }
+      if (sizes.size()<static_cast<unsigned>(system_index)){
+        sizes.resize(system_index);
+        models.resize(system_index);
+      }
+      models[system_index-1].add_line(line_format,line,current_model,sizes[system_index-1]);
+    }
+    
+    for (unsigned i=0;i<sizes.size();++i)
+      models[i].close(sizes[i]);
+    return sizes;
+  }
   
   //template parameter Occupancy_handler tells what to do with atoms with occupancy !=1 (when no altloc present)
   //TODO : think of the same think for altloc: when should have that the sum of the occupancy is 1 when considering these atoms!!!!!!
@@ -100,8 +327,10 @@ public:
   //occupancy is not const for the moment since it may be used as internal line storage
   /** Reads the line of a file and give instruction to the builder to construct molecular system(s).
     * \tparam mode indicate the encoding of the file to be read. 
-    * To read a compressed file, you must include the file <ESBTL/compressed_ifstream.h>,
-    * and the boost_iostreams headers and library must be installed on your system.
+    * To read a compressed file (or to use ESBTL::AUTO), you must include the file <ESBTL/compressed_ifstream.h>,
+    * and the boost_iostreams and boost_thread headers and libraries must be installed on your system.
+    * Compressed files are decompressed in a separate thread (see ESBTL::Decompression_pipeline).
+    * Use ESBTL::MMAP to read a large uncompressed file without copying its lines.
     * \tparam Occupancy_handler is an occupancy policy that must be a model of the concept \ref occpol.
     * \param filename is the name of the file to be read.
     * \param occupancy is the occupancy policy
@@ -113,16 +342,7 @@ public:
     */
   template <Reading_mode mode,class Occupancy_handler>
   bool read(const std::string& filename,Occupancy_handler occupancy,char default_altloc=' '){
-    //binary flags prevent from interpretation of some symbols \r\n for example
-    std::ifstream input( filename.c_str(),std::ios_base::binary );
-
-    if (! input){
-      std::cerr << "Problem while trying to open file " << filename << ".\nPlease check that the file exists and that you have the right to read it."  << std::endl;
-      return false;   
-    }
-    
-    internal::Ifstream_compress<mode> stream;
-    return read_stream(stream.get(input),occupancy,default_altloc);
+    return read_file(filename,occupancy,default_altloc,internal::Reading_mode_tag<mode>());
   }
 
   template <class Occupancy_handler>
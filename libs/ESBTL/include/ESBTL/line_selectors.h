@@ -48,8 +48,8 @@ namespace ESBTL{
     * struct Line_selector_concept{
     *   //returns the index (1...n) of the system in which that line matches: 
     *   // RMK stands for remark (including MODEL), while DISCARD indicate that the line should be discarded.
-    *   template <class Line_format,class Occupancy_handler>
-    *   int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy)
+    *   template <class Line_format,class Line,class Occupancy_handler>
+    *   int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy)
     *   { ... }
     * 
     *   unsigned max_nb_systems() const {return 1;}
@@ -57,6 +57,7 @@ namespace ESBTL{
     * \endcode
     *  In function \b keep the template parameters are:
     *  - \c Line_format is a helper class to read a molecular data file (such as ESBTL::PDB::Line_format).
+    *  - \c Line is the type of the line read (\c std::string or ESBTL::Line_span).
     *  - \c Occupancy_handler is a class following the concept of \ref occpol. To benefit from
     *  the occupancy policy, you should use the function Occupancy_handler::add_or_postpone(line_format,line,index_of_system)
     *  to return the index of the system the line must inserted in.
@@ -73,8 +74,8 @@ class PDB_line_selector{
   PDB_line_selector():discarded(0){}
   
   //return the system pattern that matches the line: 0 remark, 1...n coordinates, -1 to discard
-  template <class Line_format,class Occupancy_handler>
-  int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy){
+  template <class Line_format,class Line,class Occupancy_handler>
+  int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy){
     if (line_format.record_type()==PDB::ATOM || line_format.record_type()==PDB::HETATM)
       return occupancy.add_or_postpone(line_format,line,1);
     
@@ -97,8 +98,8 @@ class PDB_line_selector_two_systems{
   public:
   
   //return the system pattern that matches the line: 0 remark, 1...n coordinates, -1 to discard
-  template <class Line_format,class Occupancy_handler>
-  int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy){
+  template <class Line_format,class Line,class Occupancy_handler>
+  int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy){
     
     if (line_format.record_type()==PDB::ATOM || line_format.record_type()==PDB::HETATM){
       if (is_hydrogen(std::make_pair(line_format,line)) )  return DISCARD;
@@ -168,8 +169,8 @@ class PDB_line_selector_chain{
   
   
   //return the system pattern that matches the line: 0 remark, 1...n coordinates, -1 to discard
-  template <class Line_format,class Occupancy_handler>
-  int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy){
+  template <class Line_format,class Line,class Occupancy_handler>
+  int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy){
     if (line_format.record_type()==PDB::ATOM || line_format.record_type()==PDB::HETATM){
       
       System_indices::iterator it=system_index_map_.find(line_format.get_chain_identifier(line));
@@ -219,8 +220,8 @@ class PDB_line_selector_chain{
 #define GENERIC_LINE_SELECTOR_COMMON_PART \
   public: \
   \
-  template <class Line_format,class Occupancy_handler> \
-  int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy) const{ \
+  template <class Line_format,class Line,class Occupancy_handler> \
+  int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy) const{ \
   \
     if (line_format.record_type()==PDB::ATOM || line_format.record_type()==PDB::HETATM){ \
       int ret=operator()(std::make_pair(line_format,line)); \
@@ -249,8 +250,8 @@ public:
   Generic_line_selector(){};  
   Generic_line_selector(const T1& t1):t1_(t1){}
 protected:    
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -270,8 +271,8 @@ public:
   Generic_line_selector(const T1& t1,const T2& t2):t1_(t1),t2_(t2){}
 protected:    
   static const unsigned nb_system=2;  
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -293,8 +294,8 @@ public:
   Generic_line_selector(const T1& t1,const T2& t2,const T3& t3):t1_(t1),Generic_line_selector<T2,T3>(t2,t3){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3>::nb_system + 1;  
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -317,8 +318,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4>(t2,t3,t4){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -341,8 +342,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5>(t2,t3,t4,t5){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -365,8 +366,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5,T6>(t2,t3,t4,t5,t6){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5,T6>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -390,8 +391,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5,T6,T7>(t2,t3,t4,t5,t6,t7){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5,T6,T7>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -414,8 +415,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5,T6,T7,T8>(t2,t3,t4,t5,t6,t7,t8){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5,T6,T7,T8>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -438,8 +439,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5,T6,T7,T8,T9>(t2,t3,t4,t5,t6,t7,t8,t9){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5,T6,T7,T8,T9>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -471,8 +472,8 @@ public:
     t1_(t1),Generic_line_selector<T2,T3,T4,T5,T6,T7,T8,T9,T10>(t2,t3,t4,t5,t6,t7,t8,t9,t10){}
 protected:    
   static const unsigned nb_system=Generic_line_selector<T2,T3,T4,T5,T6,T7,T8,T9,T10>::nb_system + 1;
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const 
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const 
   {
     if (t1_(p))
       return 1;
@@ -500,8 +501,8 @@ struct Generic_line_selector_base<T0,T...>: public Generic_line_selector_base<T.
   Generic_line_selector_base(){}
   Generic_line_selector_base(const T0& t0,const T& ... ts):Generic_line_selector_base<T...>(ts...),t0_(t0){}
   
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const
   {
     if (t0_(p))
       return 1;
@@ -519,8 +520,8 @@ struct Generic_line_selector_base<T0>{
   Generic_line_selector_base() {}
   Generic_line_selector_base(const T0& t0):t0_(t0) {}
   
-  template <class Line_format>
-  int operator()(const std::pair<Line_format,std::string>& p) const {
+  template <class Line_format,class Line>
+  int operator()(const std::pair<Line_format,Line>& p) const {
     if (t0_(p))
       return 1;
     return -1;
@@ -538,8 +539,8 @@ class Generic_line_selector: public internal::Generic_line_selector_base<T ... >
   Generic_line_selector(const T& ... ts):internal::Generic_line_selector_base<T...>(ts...){}
   
   //return the system pattern that matches the line: 0 remark, 1...n coordinates, -1 to discard
-  template <class Line_format,class Occupancy_handler>
-  int keep(const Line_format& line_format,const std::string& line,Occupancy_handler& occupancy){
+  template <class Line_format,class Line,class Occupancy_handler>
+  int keep(const Line_format& line_format,const Line& line,Occupancy_handler& occupancy){
     
     if (line_format.record_type()==PDB::ATOM || line_format.record_type()==PDB::HETATM){
       int ret=internal::Generic_line_selector_base<T ... >::operator()(std::make_pair(line_format,line));
@@ -0,0 +1,174 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+
+#ifndef ESBTL_LINE_SPAN_H
+#define ESBTL_LINE_SPAN_H
+
+#include <string>
+#include <cstring>
+#include <iostream>
+#include <ESBTL/name.h>
+
+namespace ESBTL{
+
+/**
+  * A non-owning view on a line of a molecular data file.
+  * The characters are not copied: the memory pointed by the span must remain valid
+  * as long as the span is used (this is the case of a memory-mapped file for example, see ESBTL::MMAP).
+  * The functions of ESBTL::PDB::Line_format accept such a line in place of a \c std::string.
+  */
+class Line_span{
+  const char* data_;
+  std::size_t length_;
+public:
+  Line_span():data_(NULL),length_(0){}
+  Line_span(const char* data,std::size_t length):data_(data),length_(length){}
+  Line_span(const char* begin,const char* end):data_(begin),length_(end-begin){}
+  
+  const char* data() const {return data_;}
+  const char* begin() const {return data_;}
+  const char* end() const {return data_+length_;}
+  std::size_t length() const {return length_;}
+  std::size_t size() const {return length_;}
+  bool empty() const {return length_==0;}
+  char operator[](std::size_t i) const {return data_[i];}
+  
+  /** Returns a copy of the line as a \c std::string.*/
+  std::string str() const {return std::string(data_,length_);}
+};
+
+inline std::ostream& operator<<(std::ostream& os,const Line_span& line){
+  return os.write(line.data(),line.length());
+}
+
+/** \cond */
+namespace internal{
+  
+  //uniform access to the characters of a line whatever its type
+  inline const std::string& line_to_string(const std::string& line){return line;}
+  inline std::string line_to_string(const Line_span& line){return line.str();}
+  inline Line_span line_to_span(const std::string& line){return Line_span(line.data(),line.size());}
+  inline const Line_span& line_to_span(const Line_span& line){return line;}
+  
+  inline bool line_starts_with(const char* line,std::size_t length,const char* prefix,std::size_t n){
+    return length>=n && memcmp(line,prefix,n)==0;
+  }
+  
+  //same characters as those removed by boost::trim with the classic locale
+  inline bool is_blank(char c){
+    return c==' ' || c=='\t' || c=='\n' || c=='\r' || c=='\v' || c=='\f';
+  }
+  
+  inline void trim_span(const char*& begin,const char*& end){
+    while (begin!=end && is_blank(*begin)) ++begin;
+    while (end!=begin && is_blank(*(end-1))) --end;
+  }
+  
+  //Hand-written conversions of a trimmed, non-empty field.
+  //They return false when the field is not in the simple fixed-column form
+  //expected in a PDB file: the caller then falls back to boost::lexical_cast.
+  inline bool parse_field(const char* begin,const char* end,std::string& value){
+    value.assign(begin,end);
+    return true;
+  }
+  
+  inline bool parse_field(const char* begin,const char* end,Name& value){
+    if (static_cast<std::size_t>(end-begin)>Name::max_size) return false;
+    value=Name(begin,end);
+    return true;
+  }
+  
+  inline bool parse_field(const char* begin,const char* end,char& value){
+    if (end-begin!=1) return false;
+    value=*begin;
+    return true;
+  }
+  
+  inline bool parse_field(const char* begin,const char* end,int& value){
+    bool negative=false;
+    if (*begin=='-' || *begin=='+'){
+      negative=(*begin=='-');
+      ++begin;
+    }
+    //at most 9 digits to avoid overflow
+    if (begin==end || end-begin>9) return false;
+    int res=0;
+    for (;begin!=end;++begin){
+      unsigned d=static_cast<unsigned>(*begin-'0');
+      if (d>9) return false;
+      res=10*res+d;
+    }
+    value=negative?-res:res;
+    return true;
+  }
+  
+  inline bool parse_field(const char* begin,const char* end,double& value){
+    //exact powers of ten: mantissa/10^k is then correctly rounded, 
+    //as is the result of boost::lexical_cast.
+    static const double powers_of_ten[]={1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,
+                                         1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17};
+    bool negative=false;
+    if (*begin=='-' || *begin=='+'){
+      negative=(*begin=='-');
+      ++begin;
+    }
+    unsigned long long mantissa=0;
+    int nb_digits=0;
+    int nb_decimals=-1;
+    for (;begin!=end;++begin){
+      if (*begin=='.'){
+        if (nb_decimals!=-1) return false;
+        nb_decimals=0;
+        continue;
+      }
+      unsigned d=static_cast<unsigned>(*begin-'0');
+      if (d>9) return false;
+      //keep the mantissa exactly representable by a double
+      if (++nb_digits>15) return false;
+      mantissa=10*mantissa+d;
+      if (nb_decimals!=-1) ++nb_decimals;
+    }
+    if (nb_digits==0) return false;
+    double res=static_cast<double>(mantissa);
+    if (nb_decimals>0) res/=powers_of_ten[nb_decimals];
+    value=negative?-res:res;
+    return true;
+  }
+  
+} //namespace internal
+/** \endcond */
+
+} //namespace ESBTL
+
+#endif //ESBTL_LINE_SPAN_H
@@ -0,0 +1,192 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+
+#ifndef ESBTL_MODEL_INDEX_H
+#define ESBTL_MODEL_INDEX_H
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cassert>
+#include <boost/cstdint.hpp>
+#include <ESBTL/internal/perfect_hash_table.h>
+
+namespace ESBTL{
+
+/**
+  * An index giving in constant time the rank of an atom of a model from its serial number, and
+  * the rank of a residue from its chain identifier, sequence number and insertion code.
+  * Ranks follow the order of the atom and residue iterators of the model, so that the atoms of
+  * the residue of rank r are the atoms of ranks first_atom_of_residue(r) to
+  * first_atom_of_residue(r)+number_of_atoms_of_residue(r)-1.
+  *
+  * The finalize() function of the models builds their index, it must be called again if chains,
+  * residues or atoms are created afterwards. If several atoms have the same serial number (as in files
+  * having more than 99999 atoms), the first one is indexed, and likewise for residues.
+  * 
+  * Other containers can be indexed by calling add_residue() and add_atom() in the same order as
+  * the iterators of a model, and then build().
+  */
+class Model_index{
+  typedef internal::Perfect_hash_table::Entry Entry;
+public:
+  Model_index():first_serial_number_(0){first_atom_.push_back(0);}
+  
+  /** Builds the index of a model.*/
+  template <class Model>
+  void build(const Model& model){
+    clear();
+    atom_entries_.reserve(model.number_of_atoms());
+    residue_entries_.reserve(model.number_of_residues());
+    first_atom_.reserve(model.number_of_residues()+1);
+    for (typename Model::Residues_const_iterator it_res=model.residues_begin();it_res!=model.residues_end();++it_res){
+      add_residue(it_res->chain_identifier(),it_res->residue_sequence_number(),it_res->insertion_code());
+      for (typename Model::System::Residue::Atoms_const_iterator it_atm=it_res->atoms_begin();it_atm!=it_res->atoms_end();++it_atm)
+        add_atom(it_atm->atom_serial_number());
+    }
+    build();
+  }
+
+  /** Removes all residues and atoms.*/
+  void clear(){
+    first_serial_number_=0;
+    std::vector<int>().swap(atom_of_serial_number_);
+    atoms_=internal::Perfect_hash_table();
+    residues_=internal::Perfect_hash_table();
+    first_atom_.assign(1,0);
+    std::vector<Entry>().swap(atom_entries_);
+    std::vector<Entry>().swap(residue_entries_);
+  }
+
+  /** Starts a new residue, atoms added next belong to it.*/
+  void add_residue(char ch,int ressn,char insc){
+    residue_entries_.push_back(Entry(residue_key(ch,ressn,insc),number_of_residues()));
+    first_atom_.push_back(first_atom_.back());
+  }
+  
+  /** Adds an atom to the last residue.*/
+  void add_atom(unsigned sn){
+    assert(number_of_residues()!=0);
+    atom_entries_.push_back(Entry(sn,first_atom_.back()));
+    ++first_atom_.back();
+  }
+  
+  /** Builds the tables of the residues and atoms added since the last call to clear().*/
+  void build(){
+    boost::uint64_t min_sn=0,max_sn=0;
+    if (!atom_entries_.empty()){
+      min_sn=max_sn=atom_entries_[0].first;
+      for (std::vector<Entry>::const_iterator it=atom_entries_.begin();it!=atom_entries_.end();++it){
+        min_sn=(std::min)(min_sn,it->first);
+        max_sn=(std::max)(max_sn,it->first);
+      }
+    }
+    //serial numbers are usually dense: they index an array, unless it would be much larger than the number of atoms
+    if (!atom_entries_.empty() && max_sn-min_sn < 2*atom_entries_.size()){
+      first_serial_number_=static_cast<unsigned>(min_sn);
+      atom_of_serial_number_.assign(max_sn-min_sn+1,-1);
+      for (std::vector<Entry>::const_iterator it=atom_entries_.begin();it!=atom_entries_.end();++it){
+        int& rank=atom_of_serial_number_[it->first-min_sn];
+        if (rank==-1) rank=it->second;
+      }
+    }
+    else{
+      remove_duplicate_keys(atom_entries_);
+      atoms_.build(atom_entries_);
+    }
+    remove_duplicate_keys(residue_entries_);
+    residues_.build(residue_entries_);
+    std::vector<Entry>().swap(atom_entries_);
+    std::vector<Entry>().swap(residue_entries_);
+  }
+  
+  /** Returns the rank of the atom with serial number sn, -1 if there is none.*/
+  int find_atom(unsigned sn) const {
+    if (!atom_of_serial_number_.empty())
+      return sn-first_serial_number_ < atom_of_serial_number_.size() ? atom_of_serial_number_[sn-first_serial_number_] : -1;
+    unsigned rank;
+    return atoms_.find(sn,rank)?static_cast<int>(rank):-1;
+  }
+  
+  /** Returns the rank of a residue, -1 if there is none.*/
+  int find_residue(char ch,int ressn,char insc=' ') const {
+    unsigned rank;
+    return residues_.find(residue_key(ch,ressn,insc),rank)?static_cast<int>(rank):-1;
+  }
+  
+  unsigned first_atom_of_residue(unsigned r) const {return first_atom_[r];}
+  unsigned number_of_atoms_of_residue(unsigned r) const {return first_atom_[r+1]-first_atom_[r];}
+  
+  size_t number_of_residues() const {return first_atom_.size()-1;}
+  size_t number_of_atoms() const {return first_atom_.back();}
+
+private:
+  static boost::uint64_t residue_key(char ch,int ressn,char insc){
+    return (static_cast<boost::uint64_t>(static_cast<unsigned char>(ch)) << 40) |
+           (static_cast<boost::uint64_t>(static_cast<boost::uint32_t>(ressn)) << 8) |
+           static_cast<unsigned char>(insc);
+  }
+
+  struct Less_key{
+    bool operator()(const Entry& e1,const Entry& e2) const {return e1.first < e2.first;}
+  };
+  struct Same_key{
+    bool operator()(const Entry& e1,const Entry& e2) const {return e1.first == e2.first;}
+  };
+  
+  //keeps the first entry of each key
+  static void remove_duplicate_keys(std::vector<Entry>& entries){
+    for (std::size_t i=1;i<entries.size();++i)
+      if (!(entries[i-1].first < entries[i].first)){
+        std::stable_sort(entries.begin(),entries.end(),Less_key());
+        entries.erase(std::unique(entries.begin(),entries.end(),Same_key()),entries.end());
+        return;
+      }
+  }
+  
+  //rank of the atoms from their serial number minus the first one, or table of the atoms if it is empty
+  unsigned first_serial_number_;
+  std::vector<int> atom_of_serial_number_;
+  internal::Perfect_hash_table atoms_;
+  internal::Perfect_hash_table residues_;
+  //first atom of each residue, followed by the number of atoms
+  std::vector<unsigned> first_atom_;
+  //only used between clear and build
+  std::vector<Entry> atom_entries_;
+  std::vector<Entry> residue_entries_;
+};
+
+} //namespace ESBTL
+
+#endif //ESBTL_MODEL_INDEX_H
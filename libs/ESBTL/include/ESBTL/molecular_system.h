@@ -44,6 +44,8 @@
 #include <boost/tuple/tuple.hpp>
 #include <ESBTL/iterators.h>
 #include <ESBTL/constants.h>
+#include <ESBTL/name.h>
+#include <ESBTL/model_index.h>
 
 /** \defgroup grp_iters Iterators 
   * Iterators and functions offering iteration possibilities are gathered on this page.
@@ -51,6 +53,44 @@
 
 namespace ESBTL{
 
+/** \cond */
+namespace internal{
+
+//residue of the last line given to a system, with the key of the line. It is not copied with the system,
+//since it refers to a residue of the system copied.
+template <class Residue>
+struct Last_residue{
+  Last_residue():residue(NULL){}
+  Last_residue(const Last_residue&):residue(NULL){}
+  Last_residue& operator=(const Last_residue&){residue=NULL;return *this;}
+  
+  template<class Line_format,class Line>
+  bool matches(int model,const Line_format& line_format,const Line& line) const {
+    return residue!=NULL && model==model_number &&
+           line_format.get_chain_identifier(line)==chain_identifier &&
+           line_format.get_residue_sequence_number(line)==residue_sequence_number &&
+           line_format.get_insertion_code(line)==insertion_code;
+  }
+  
+  template<class Line_format,class Line>
+  void set(Residue& res,int model,const Line_format& line_format,const Line& line){
+    residue=&res;
+    model_number=model;
+    chain_identifier=line_format.get_chain_identifier(line);
+    residue_sequence_number=line_format.get_residue_sequence_number(line);
+    insertion_code=line_format.get_insertion_code(line);
+  }
+  
+  Residue* residue;
+  int model_number;
+  char chain_identifier;
+  int residue_sequence_number;
+  char insertion_code;
+};
+
+} //namespace internal
+/** \endcond */
+
 /** 
   * A class representing a molecular system.
   * \tparam Items is a class gathering wrapper defining model, chain , residue and atom types (see Default_system_items or System_items_with_coarse_grain for example).
@@ -86,14 +126,28 @@ public:
   Models_const_iterator models_end()   const {return Models_const_iterator(model_container_.end());  }
   //---------
   
-  Molecular_system(int index,std::string name="no_name"):name_(name),index_(index),alternate_location_(' '){}
-
-  template<class Line_format>
-  void interpret_line(const Line_format& line_format,const std::string& line,int current_model){
-    Model& model=get_or_create_model(current_model);
-    Chain& chain=model.get_or_create_chain(line_format,line);
-    Residue& residue=chain.get_or_create_residue(line_format,line);
-    residue.add_atom(line_format,line);
+  Molecular_system(int index,std::string name="no_name"):
+    name_(name),index_(index),alternate_location_(' '),
+    nb_chains_per_model_(0),nb_residues_per_model_(0),nb_atoms_per_model_(0){}
+
+  /** Adds the atom of a line. Consecutive lines of a residue (the usual case) skip the lookups
+    * of the model, chain and residue: the residue of the previous line is reused.
+    */
+  template<class Line_format,class Line>
+  void interpret_line(const Line_format& line_format,const Line& line,int current_model){
+    if (!last_residue_.matches(current_model,line_format,line)){
+      Model& model=get_or_create_model(current_model);
+      Chain& chain=model.get_or_create_chain(line_format,line);
+      last_residue_.set(chain.get_or_create_residue(line_format,line),current_model,line_format,line);
+    }
+    last_residue_.residue->add_atom(line_format,line);
+  }
+  
+  /** Sets the storage reserved by models created afterwards (see ESBTL::All_atom_system_builder::reserve).*/
+  void reserve_models(unsigned nb_chains,unsigned nb_residues,unsigned nb_atoms){
+    nb_chains_per_model_=nb_chains;
+    nb_residues_per_model_=nb_residues;
+    nb_atoms_per_model_=nb_atoms;
   }
 
   bool has_no_model() const{
@@ -110,6 +164,14 @@ public:
   
   void set_altloc(char c) {alternate_location_=c;}
   
+  /** Completes the models once all lines have been interpreted (called by the builder).*/
+  void finalize(){
+    //finalize may move residues
+    last_residue_=internal::Last_residue<Residue>();
+    for (typename Model_container::iterator it=model_container_.begin();it!=model_container_.end();++it)
+      it->second.finalize();
+  }
+  
   //member variables
   //DECLARE_AND_ACCESS(model_container,Model_container)
   DECLARE_AND_ACCESS(name,std::string)
@@ -121,6 +183,7 @@ public:
     typename Model_container::iterator itm=model_container_.find(i);
     if (itm==model_container_.end()){
       itm=model_container_.insert( std::make_pair(i,Model(i,*this)) ).first;
+      itm->second.reserve(nb_chains_per_model_,nb_residues_per_model_,nb_atoms_per_model_);
     }
     return itm->second;
   }
@@ -134,6 +197,10 @@ public:
   //Model_container& model_container(){return model_container_;}
 private:
   Model_container model_container_;
+  internal::Last_residue<Residue> last_residue_;
+  unsigned nb_chains_per_model_;
+  unsigned nb_residues_per_model_;
+  unsigned nb_atoms_per_model_;
 };
 
 /** A class representing a model.
@@ -150,13 +217,28 @@ private:
   typedef Molecular_model<System_>         Self;
   const System& system_;
   Chain_container chain_container_;
+  //built by finalize: index of the atoms and residues, and the atoms and residues of each rank
+  Model_index index_;
+  std::vector<const typename System::Atom*> atom_of_rank_;
+  std::vector<const typename System::Residue*> residue_of_rank_;
 public:
   const System& system() const {return system_;}
   
   Molecular_model(int nbm,const System& sys):system_(sys),model_number_(nbm){}
+  
+  /** Copy constructor. The tables of ranks of a finalized model are filled again, with the residues and atoms of the copy.*/
+  Molecular_model(const Molecular_model& other):
+    system_(other.system_),
+    chain_container_(other.chain_container_),
+    index_(other.index_),
+    model_number_(other.model_number_)
+  {
+    if (!other.residue_of_rank_.empty())
+      fill_ranks();
+  }
 
-  template <class Line_format>
-  Chain& get_or_create_chain(const Line_format& line_format,const std::string& line){
+  template <class Line_format,class Line>
+  Chain& get_or_create_chain(const Line_format& line_format,const Line& line){
     char ch=line_format.get_chain_identifier(line);
     typename Chain_container::iterator itch=chain_container_.find(ch);
     if (itch==chain_container_.end())
@@ -172,7 +254,7 @@ public:
   }
 
   const Chain& get_chain(char id) const {
-    typename Chain_container::iterator itch=chain_container_.find(id);
+    typename Chain_container::const_iterator itch=chain_container_.find(id);
     assert (itch!=chain_container_.end());
     return itch->second;    
   }
@@ -189,6 +271,58 @@ public:
     return chain_container_.size();
   }
   
+  /** Nothing to do: chains, residues and atoms are stored in maps (see ESBTL::Flat_model::reserve).*/
+  void reserve(unsigned /*nb_chains*/,unsigned /*nb_residues*/,unsigned /*nb_atoms*/){}
+  
+  /** Builds the index of the model (the maps are always sorted, see ESBTL::Flat_model::finalize).
+    * The builder calls it once all lines are read.
+    */
+  void finalize(){
+    //same as index_.build(*this), filling the tables of ranks in the same pass
+    index_.clear();
+    atom_of_rank_.clear();
+    residue_of_rank_.clear();
+    for (Residues_iterator it_res=residues_begin();it_res!=residues_end();++it_res){
+      index_.add_residue(it_res->chain_identifier(),it_res->residue_sequence_number(),it_res->insertion_code());
+      residue_of_rank_.push_back(&(*it_res));
+      for (typename System::Residue::Atoms_iterator it_atm=it_res->atoms_begin();it_atm!=it_res->atoms_end();++it_atm){
+        index_.add_atom(it_atm->atom_serial_number());
+        atom_of_rank_.push_back(&(*it_atm));
+      }
+    }
+    index_.build();
+  }
+  
+private:
+  //residues and atoms of each rank of the index, in the order of the iterators
+  void fill_ranks(){
+    atom_of_rank_.clear();
+    residue_of_rank_.clear();
+    atom_of_rank_.reserve(index_.number_of_atoms());
+    residue_of_rank_.reserve(index_.number_of_residues());
+    for (Residues_iterator it_res=residues_begin();it_res!=residues_end();++it_res){
+      residue_of_rank_.push_back(&(*it_res));
+      for (typename System::Residue::Atoms_iterator it_atm=it_res->atoms_begin();it_atm!=it_res->atoms_end();++it_atm)
+        atom_of_rank_.push_back(&(*it_atm));
+    }
+  }
+public:
+  
+  /** Index of the atoms and residues built by finalize(), ranks are those of the iterators of the model.*/
+  const Model_index& index() const {return index_;}
+  
+  /** Returns the atom with serial number sn in constant time, NULL if there is none (see ESBTL::Model_index).*/
+  const typename System::Atom* find_atom_by_serial_number(unsigned sn) const {
+    int rank=index_.find_atom(sn);
+    return rank==-1?NULL:atom_of_rank_[rank];
+  }
+  
+  /** Returns a residue in constant time, NULL if there is none (see ESBTL::Model_index).*/
+  const typename System::Residue* find_residue_by_key(char ch_id,int ressn,char insc=' ') const {
+    int rank=index_.find_residue(ch_id,ressn,insc);
+    return rank==-1?NULL:residue_of_rank_[rank];
+  }
+  
   size_t number_of_residues() const {
     size_t total=0;
     for (typename Chain_container::const_iterator it=chain_container_.begin();it!=chain_container_.end();++it)
@@ -278,8 +412,8 @@ private:
   Residue_container residue_container_;
 public:
   
-  template<class Line_format>  
-  Molecular_chain(const Line_format& line_format,const std::string& line, const Model& mod):
+  template<class Line_format,class Line>  
+  Molecular_chain(const Line_format& line_format,const Line& line, const Model& mod):
     model_(mod),
     chain_identifier_(line_format.get_chain_identifier(line)) {}
 
@@ -287,8 +421,8 @@ public:
       
   const Model& model() const {return model_;}
 
-  template<class Line_format>
-  Residue& get_or_create_residue(const Line_format& line_format,const std::string& line){
+  template<class Line_format,class Line>
+  Residue& get_or_create_residue(const Line_format& line_format,const Line& line){
     int ressn=line_format.get_residue_sequence_number(line);
     char insc=line_format.get_insertion_code(line);
     typename Residue_container::iterator it=residue_container_.find(std::make_pair(ressn,insc));
@@ -297,15 +431,15 @@ public:
     return it->second;
   }
   
-  Residue& get_or_create_residue(const std::string& resname,int ressn,char insc){
+  Residue& get_or_create_residue(const Name& resname,int ressn,char insc){
     typename Residue_container::iterator it=residue_container_.find(std::make_pair(ressn,insc));
     if (it==residue_container_.end())
       it=residue_container_.insert( std::make_pair(std::make_pair(ressn,insc),Residue(resname,ressn,insc,*this) ) ).first;
     return it->second;
   }
   
-  const Residue& get_residue(int ressn,char insc=' '){
-    typename Residue_container::iterator it=residue_container_.find(std::make_pair(ressn,insc));
+  const Residue& get_residue(int ressn,char insc=' ') const {
+    typename Residue_container::const_iterator it=residue_container_.find(std::make_pair(ressn,insc));
     assert (it!=residue_container_.end());
     return it->second;    
   }
@@ -383,22 +517,25 @@ public:
   const Chain& chain() const {return chain_;}
   char chain_identifier() const {return chain_.chain_identifier();}
   
-  template<class Line_format>
-  Molecular_residue(const Line_format& line_format, const std::string& line,const Chain& ch):
+  template<class Line_format,class Line>
+  Molecular_residue(const Line_format& line_format, const Line& line,const Chain& ch):
     chain_(ch),
     residue_name_(line_format.get_residue_name(line)),
     residue_sequence_number_(line_format.get_residue_sequence_number(line)),
     insertion_code_(line_format.get_insertion_code(line)){}
 
-  Molecular_residue(const std::string& resname,int index,char insc,const Chain& ch):
+  Molecular_residue(const Name& resname,int index,char insc,const Chain& ch):
     chain_(ch),residue_name_(resname),residue_sequence_number_(index),insertion_code_(insc){}
       
-  template<class Line_format>    
-  void add_atom(const Line_format& line_format, const std::string& line)
+  template<class Line_format,class Line>    
+  void add_atom(const Line_format& line_format, const Line& line)
   {
     unsigned sn=line_format.get_atom_serial_number(line);
-    assert (atom_container_.find(sn)==atom_container_.end() || !"Two atoms with same serial numbers.");
-    atom_container_.insert(std::make_pair(sn,Atom(line_format,line,*this)));
+    //serial numbers usually increase: the end is given as a hint, making the insertion constant time
+    std::size_t nb_atoms=atom_container_.size();
+    atom_container_.insert(atom_container_.end(),std::make_pair(sn,Atom(line_format,line,*this)));
+    assert (atom_container_.size()==nb_atoms+1 || !"Two atoms with same serial numbers.");
+    (void) nb_atoms;
   }
 
   size_t number_of_atoms() const {
@@ -433,7 +570,7 @@ public:
   Atoms_const_iterator atoms_end()   const {return Atoms_const_iterator(atom_container_.end());}
   //-------  
   
-  DECLARE_AND_ACCESS(residue_name,std::string)
+  DECLARE_AND_ACCESS(residue_name,Name)
   DECLARE_AND_ACCESS(residue_sequence_number,int)
   DECLARE_AND_ACCESS(insertion_code,char)
 };
@@ -454,8 +591,8 @@ private:
   const Residue* residue_;
 public:
   
-  template <class Line_format,class Residue_type>
-  Molecular_atom(const Line_format& line_format, const std::string& line,const Residue_type& res):
+  template <class Line_format,class Line,class Residue_type>
+  Molecular_atom(const Line_format& line_format, const Line& line,const Residue_type& res):
     Point(line_format.get_x(line),line_format.get_y(line),line_format.get_z(line)),
     residue_(static_cast<const Residue*>(&res)),
     is_hetatm_(line_format.is_hetatm()),
@@ -477,6 +614,9 @@ public:
   //TODO should use the number type of the Point 
   Molecular_atom(double x,double y,double z):Point(x,y,z),residue_(NULL){}
 
+  /** Changes the residue the atom belongs to (used by layouts that move residues in memory, see ESBTL::Flat_model).*/
+  void set_residue(const Residue& res) {residue_=&res;}
+  
   //System functions
   int system_index() const {return residue_->chain().model().system().index();};
   
@@ -484,18 +624,18 @@ public:
   char chain_identifier() const {return residue_->chain().chain_identifier();}
   //Residue functions
   const Residue& residue() const {return *residue_;}
-  const std::string& residue_name() const {return residue_->residue_name();}
+  const Name& residue_name() const {return residue_->residue_name();}
   int residue_sequence_number() const {return residue_->residue_sequence_number();}
   char insertion_code() const {return residue_->insertion_code();}
   
   //member variables
   DECLARE_AND_ACCESS(is_hetatm,bool)
   DECLARE_AND_ACCESS(atom_serial_number,int)
-  DECLARE_AND_ACCESS(atom_name,std::string)
+  DECLARE_AND_ACCESS(atom_name,Name)
   DECLARE_AND_ACCESS(alternate_location,char)
   DECLARE_AND_ACCESS(occupancy,double)
   DECLARE_AND_ACCESS(temperature_factor,double)
-  DECLARE_AND_ACCESS(element,std::string)
+  DECLARE_AND_ACCESS(element,Name)
   DECLARE_AND_ACCESS(charge,int)
 };
 
@@ -534,7 +674,7 @@ struct Default_system_items{
   char get_chain_identifier(const Molecular_chain<System>& c) {return c.chain_identifier();}
 //for residues
   template <class System>
-  const std::string& get_residue_name(const Molecular_residue<System>& r) {return r.residue_name();}
+  const Name& get_residue_name(const Molecular_residue<System>& r) {return r.residue_name();}
   template <class System>
   int get_residue_sequence_number(const Molecular_residue<System>& r) {return r.residue_sequence_number();}
   template <class System>
@@ -545,7 +685,7 @@ struct Default_system_items{
   template <class System,class Point>
   int get_atom_serial_number(const Molecular_atom<System,Point>& a) {return a.atom_serial_number() ;}
   template <class System,class Point>
-  const std::string& get_atom_name(const Molecular_atom<System,Point>& a) {return a.atom_name() ;}
+  const Name& get_atom_name(const Molecular_atom<System,Point>& a) {return a.atom_name() ;}
   template <class System,class Point>
   char get_alternate_location(const Molecular_atom<System,Point>& a) {return a.alternate_location() ;}
   template <class System,class Point>
@@ -553,13 +693,13 @@ struct Default_system_items{
   template <class System,class Point>
   double get_temperature_factor(const Molecular_atom<System,Point>& a) {return a.temperature_factor() ;}
   template <class System,class Point>
-  const std::string& get_element(const Molecular_atom<System,Point>& a) {return a.element() ;}
+  const Name& get_element(const Molecular_atom<System,Point>& a) {return a.element() ;}
   template <class System,class Point>
   int get_charge(const Molecular_atom<System,Point>& a) {return a.charge() ;}
   template <class System,class Point>
   char get_chain_identifier(const Molecular_atom<System,Point>& a) {return a.chain_identifier() ;}
   template <class System,class Point>
-  const std::string& get_residue_name(const Molecular_atom<System,Point>& a) {return a.residue_name() ;}
+  const Name& get_residue_name(const Molecular_atom<System,Point>& a) {return a.residue_name() ;}
   template <class System,class Point>
   int get_residue_sequence_number(const Molecular_atom<System,Point>& a) {return a.residue_sequence_number() ;}
   template <class System,class Point>
@@ -573,7 +713,7 @@ struct Default_system_items{
   
 //~ //function to insert a set water molecule in as a system
 //~ template<class Input_iterator,class System>
-//~ void insert_atoms(Input_iterator first,Input_iterator last,System& system,int modelid=1,char chainid='Z',std::string resname="HOH",int starting_res_index=1){
+//~ void insert_atoms(Input_iterator first,Input_iterator last,System& system,int modelid=1,char chainid='Z',Name resname="HOH",int starting_res_index=1){
   //~ typename System::Model& model=system.get_or_create_model(modelid);
   //~ typename System::Chain& chain=model.get_or_create_chain(chainid);
   //~ int res_index=starting_res_index-1;
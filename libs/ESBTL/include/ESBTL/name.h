@@ -0,0 +1,162 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+#ifndef ESBTL_NAME_H
+#define ESBTL_NAME_H
+
+#include <string>
+#include <cstring>
+#include <cstdlib>
+#include <iostream>
+#include <boost/cstdint.hpp>
+
+namespace ESBTL{
+
+/**
+  * A short name (atom name, residue name or element) stored in a fixed-width integer.
+  * Names of a PDB file have at most four characters: each character is stored in one byte
+  * of the identifier, so that two names are compared with a single integer comparison,
+  * and that storing a name never allocates memory.
+  * The identifier of a name does not depend on the order in which names are read and
+  * can be used from several threads without any synchronization.
+  * Names are ordered as the corresponding strings.
+  */
+class Name{
+  boost::uint32_t id_;
+  
+  void assign(const char* begin,const char* end){
+    //a longer name cannot be stored: it would be silently truncated
+    if (static_cast<std::size_t>(end-begin)>max_size){
+      std::cerr << "Fatal error: name <|" << std::string(begin,end) << "|> has more than " << max_size << " characters.\n";
+      exit(EXIT_FAILURE);
+    }
+    id_=0;
+    for (unsigned i=0;i!=max_size && begin!=end;++i,++begin)
+      id_|=static_cast<boost::uint32_t>(static_cast<unsigned char>(*begin)) << (8*(max_size-1-i));
+  }
+public:
+  /** Maximal number of characters of a name.*/
+  static const std::size_t max_size=4;
+  
+  /** Default constructor, the name is empty.*/
+  Name():id_(0){}
+  /** Constructor from a string, that must have at most max_size characters (the program exits otherwise).*/
+  Name(const char* str){assign(str,str+strlen(str));}
+  /** Constructor from a string, that must have at most max_size characters (the program exits otherwise).*/
+  Name(const std::string& str){assign(str.data(),str.data()+str.size());}
+  /** Constructor from the range of characters [begin,end), that must have at most max_size characters (the program exits otherwise).*/
+  Name(const char* begin,const char* end){assign(begin,end);}
+  
+  /** Returns the name with identifier \c id (as returned by id()).*/
+  static Name from_id(boost::uint32_t id){
+    Name name;
+    name.id_=id;
+    return name;
+  }
+  
+  /** Returns the integer identifying the name.*/
+  boost::uint32_t id() const {return id_;}
+  
+  /** Returns the number of characters of the name.*/
+  std::size_t size() const {
+    std::size_t n=0;
+    while (n!=max_size && (*this)[n]!='\0') ++n;
+    return n;
+  }
+  
+  bool empty() const {return id_==0;}
+  
+  char operator[](std::size_t i) const {
+    return static_cast<char>( (id_ >> (8*(max_size-1-i))) & 0xFF );
+  }
+  
+  /** Returns a copy of the name as a \c std::string.*/
+  std::string str() const {
+    char buffer[max_size];
+    std::size_t n=size();
+    for (std::size_t i=0;i!=n;++i) buffer[i]=(*this)[i];
+    return std::string(buffer,n);
+  }
+  
+  operator std::string() const {return str();}
+};
+
+/**
+  * The identifier of a name known at compile time, for example Name_id<'C','A'>::value
+  * is the identifier of the atom name \c CA. It can be used as a case label.
+  */
+template <char c0,char c1='\0',char c2='\0',char c3='\0'>
+struct Name_id{
+  static const boost::uint32_t value=
+    (static_cast<boost::uint32_t>(static_cast<unsigned char>(c0)) << 24) |
+    (static_cast<boost::uint32_t>(static_cast<unsigned char>(c1)) << 16) |
+    (static_cast<boost::uint32_t>(static_cast<unsigned char>(c2)) << 8)  |
+     static_cast<boost::uint32_t>(static_cast<unsigned char>(c3));
+};
+
+inline bool operator==(const Name& n1,const Name& n2){return n1.id()==n2.id();}
+inline bool operator!=(const Name& n1,const Name& n2){return n1.id()!=n2.id();}
+inline bool operator< (const Name& n1,const Name& n2){return n1.id()< n2.id();}
+
+//comparisons with strings: a string longer than a name is never equal to a name
+inline bool operator==(const Name& n,const std::string& s){return s.size()<=Name::max_size && n==Name(s);}
+inline bool operator==(const std::string& s,const Name& n){return n==s;}
+inline bool operator!=(const Name& n,const std::string& s){return !(n==s);}
+inline bool operator!=(const std::string& s,const Name& n){return !(n==s);}
+inline bool operator==(const Name& n,const char* s){return strlen(s)<=Name::max_size && n==Name(s);}
+inline bool operator==(const char* s,const Name& n){return n==s;}
+inline bool operator!=(const Name& n,const char* s){return !(n==s);}
+inline bool operator!=(const char* s,const Name& n){return !(n==s);}
+
+/** Hash function used by boost::unordered containers.*/
+inline std::size_t hash_value(const Name& n){return n.id();}
+
+inline std::ostream& operator<<(std::ostream& os,const Name& n){
+  for (std::size_t i=0,size=n.size();i!=size;++i) os.put(n[i]);
+  return os;
+}
+
+inline std::istream& operator>>(std::istream& is,Name& n){
+  std::string str;
+  if (is >> str){
+    if (str.size()>Name::max_size)
+      is.setstate(std::ios_base::failbit);
+    else
+      n=Name(str);
+  }
+  return is;
+}
+
+} //namespace ESBTL
+
+#endif //ESBTL_NAME_H
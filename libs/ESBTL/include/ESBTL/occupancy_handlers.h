@@ -36,7 +36,10 @@
 #define ESBTL_OCCUPANCY_HANDLERS_H
 
 #include <set>
+#include <vector>
 #include <iostream>
+#include <ESBTL/line_span.h>
+#include <ESBTL/PDB.h>
 
 namespace ESBTL{
 
@@ -50,9 +53,10 @@ namespace ESBTL{
    *   //check whether an atom can directly be added to a system. 
    *   //It returns -1 if not, and the number of the system otherwise.
    *   //Line_format must provide  similar functionalities to ESBTL::PDB::Line_format.
-   *   //line is a line of a molecular data file representing an atom.
+   *   //line is a line of a molecular data file representing an atom (a std::string or an ESBTL::Line_span).
    *   //system_index is the index of the system the line should be added (provided by the selector).
-   *   int add_or_postpone(const Line_format& line_format,const std::string& line,int system_index) const{ ... }
+   *   template <class Line>
+   *   int add_or_postpone(const Line_format& line_format,const Line& line,int system_index) const{ ... }
    *   
    *   //This function is called by the builder when the whole file have been read.
    *   //Potential atom that have not already been inserted can be. The integer returned is
@@ -69,7 +73,8 @@ namespace ESBTL{
     */
   template <class Line_format>
   struct No_occupancy_policy{
-    int add_or_postpone(const Line_format& line_format,const std::string& line,int system_index) const{
+    template <class Line>
+    int add_or_postpone(const Line_format& line_format,const Line& line,int system_index) const{
       double occupancy_value=line_format.get_occupancy(line);
       if (occupancy_value==1. || line_format.get_alternate_location(line)!=' ')
         return system_index;
@@ -89,7 +94,8 @@ namespace ESBTL{
     */  
   template <class Line_format>
   struct Accept_all_occupancy_policy{
-    int add_or_postpone(const Line_format& ,const std::string& ,int system_index) const {
+    template <class Line>
+    int add_or_postpone(const Line_format& ,const Line& ,int system_index) const {
       return system_index;
     }
     
@@ -103,7 +109,8 @@ namespace ESBTL{
     */  
   template <class Line_format>
   struct Accept_none_occupancy_policy{
-    int add_or_postpone(const Line_format& line_format,const std::string& line,int system_index) const {
+    template <class Line>
+    int add_or_postpone(const Line_format& line_format,const Line& line,int system_index) const {
       double occupancy_value=line_format.get_occupancy(line);
       if (occupancy_value==1. || line_format.get_alternate_location(line)!=' ')
         return system_index;      
@@ -120,24 +127,39 @@ namespace ESBTL{
     template <class Line_format,bool take_max>
     class Min_or_max_occupancy_policy{
     protected:
-      typedef std::map<double,std::pair<int,std::list<std::string> > > Info;
-      Info lines;
+      //A line with the current minimum or maximum occupancy: the characters of the lines are
+      //stored one after the other in a single buffer, and their numerical fields are converted
+      //once, so that finalize gives them to the builder without parsing them again.
+      struct Postponed_line{
+        std::size_t offset;
+        PDB::Parsed_line parsed;
+        Postponed_line(std::size_t offset,const PDB::Parsed_line& parsed):offset(offset),parsed(parsed){}
+      };
+      
+      std::string text;
+      std::vector<Postponed_line> lines;
+      int system_index_of_lines;
       double min_or_max_occupancy;
       
-      Min_or_max_occupancy_policy():min_or_max_occupancy(take_max?0.:1.){}
+      Min_or_max_occupancy_policy():system_index_of_lines(DISCARD),min_or_max_occupancy(take_max?0.:1.){}
       
-      void add_line(double occupancy_value,const std::string& line,int system_index){
-        typename Info::iterator it=lines.find(occupancy_value);
-        if (it==lines.end())
-          it=lines.insert(
-              std::make_pair(occupancy_value,
-                             std::make_pair(system_index,std::list<std::string>())) 
-          ).first;
-        it->second.second.push_back(line);
+      template <class Line>
+      void add_line(double occupancy_value,const Line& line,int system_index){
+        //lines with another occupancy can no longer be selected
+        if (lines.empty() || occupancy_value!=min_or_max_occupancy){
+          text.clear();
+          lines.clear();
+          //all the lines go to the system of the first one
+          system_index_of_lines=system_index;
+        }
+        const Line_span& span=internal::line_to_span(line);
+        lines.push_back(Postponed_line(text.size(),internal::to_parsed_line(line)));
+        text.append(span.data(),span.length());
       }
       
     public:
-      int add_or_postpone(const Line_format& line_format,const std::string& line,int system_index){
+      template <class Line>
+      int add_or_postpone(const Line_format& line_format,const Line& line,int system_index){
         double occupancy_value=line_format.get_occupancy(line);
         if (occupancy_value==1. || line_format.get_alternate_location(line)!=' ')
           return system_index;
@@ -163,12 +185,11 @@ namespace ESBTL{
           exit(EXIT_FAILURE);
         }
         int lines_added=0;
-        Info::const_iterator it=lines.find(min_or_max_occupancy);
-        for (std::list<std::string>::const_iterator cur=it->second.second.begin();
-             cur!=it->second.second.end(); ++cur)
-        {
+        for (std::size_t i=0;i<lines.size();++i){
+          std::size_t end=(i+1==lines.size())?text.size():lines[i+1].offset;
+          PDB::Parsed_line line(lines[i].parsed,Line_span(text.data()+lines[i].offset,end-lines[i].offset));
           ++lines_added;
-          builder.interpret_line(Line_format(*cur),*cur,it->second.first);
+          builder.interpret_line(Line_format(line),line,system_index_of_lines);
         }
         
         return lines_added;
@@ -225,7 +246,8 @@ namespace ESBTL{
       selected_atoms.insert(begin,end);
     }
   
-    int add_or_postpone(const Line_format& line_format,const std::string& line,int system_index) const {
+    template <class Line>
+    int add_or_postpone(const Line_format& line_format,const Line& line,int system_index) const {
       double occupancy_value=line_format.get_occupancy(line);
       if (occupancy_value==1. || line_format.get_alternate_location(line)!=' ')
         return system_index;
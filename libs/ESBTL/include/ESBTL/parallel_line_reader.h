@@ -0,0 +1,235 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+
+#ifndef ESBTL_PARALLEL_LINE_READER_H
+#define ESBTL_PARALLEL_LINE_READER_H
+
+#include <vector>
+#include <cstring>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <ESBTL/line_reader.h>
+
+namespace ESBTL{
+
+/** 
+  * Class reading the lines of a PDB file using several threads.
+  * The file is memory-mapped and split into chunks at line boundaries (at \c MODEL records
+  * when some are found close to the split point). Worker threads convert the numerical fields of the
+  * lines of each chunk into ESBTL::PDB::Parsed_line records, while the calling thread gives these records,
+  * in file order, to the line selector, the occupancy policy and the builder.
+  * The systems built are thus identical to those built by ESBTL::Line_reader (alternate location selection included),
+  * and line selectors, occupancy policies and builders do not need to be thread-safe.
+  * 
+  * Only the construction of the ESBTL::PDB::Parsed_line records is parallel: Line_reader::read_line (line selection,
+  * occupancy policy) and the builder run serially in the calling thread, which bounds the speedup of a read.
+  * With ESBTL::All_atom_system_builder, they take about half of the time of a read: whatever the number of threads,
+  * a read is at most about 1.3 times faster than with ESBTL::Line_reader in ESBTL::MMAP mode.
+  * Workers convert at most two chunks per worker ahead of the calling thread, which bounds the memory used by the records.
+  *
+  * Using this class requires the boost_thread library.
+  * \tparam Line_format is a helper class that can extract fields from a ESBTL::PDB::Parsed_line (like ESBTL::PDB::Line_format).
+  * \tparam Line_selector is a line selector object that must follow the concept of \ref linesel.
+  * \tparam Builder is a class able to build a molecular system (like ESBTL::All_atom_system_builder for example).
+  */
+template <class Line_format,class Line_selector,class Builder>
+class Parallel_line_reader: public Line_reader<Line_format,Line_selector,Builder>{
+  typedef Line_reader<Line_format,Line_selector,Builder> Base;
+  
+  struct Chunk{
+    const char* begin;
+    const char* end;
+    std::vector<PDB::Parsed_line> lines;
+    bool done;
+    Chunk(const char* b,const char* e):begin(b),end(e),done(false){}
+  };
+  
+  std::vector<Chunk> chunks_;
+  std::size_t next_chunk_;
+  //chunks given to the builder, and maximal number of chunks taken by workers but not given yet
+  std::size_t consumed_chunks_;
+  std::size_t max_pending_chunks_;
+  boost::mutex mutex_;
+  boost::condition_variable chunk_done_;
+  boost::condition_variable chunk_consumed_;
+  
+  //position of the first line starting at or after p
+  static const char* next_line(const char* p,const char* end){
+    if (p==end) return end;
+    const char* eol=static_cast<const char*>( memchr(p,'\n',end-p) );
+    return eol==NULL?end:eol+1;
+  }
+  
+  //a MODEL record starting in [p,limit), or NULL
+  static const char* next_model(const char* p,const char* limit,const char* end){
+    while (p<limit){
+      if (internal::line_starts_with(p,end-p,"MODEL",5)) return p;
+      p=next_line(p,end);
+    }
+    return NULL;
+  }
+  
+  void split(const char* begin,const char* end,std::size_t nb_chunks){
+    std::size_t chunk_size=(end-begin)/nb_chunks;
+    const char* first=begin;
+    for (std::size_t i=1;i<nb_chunks && first!=end;++i){
+      const char* target=begin+i*chunk_size;
+      if (target<=first) continue;
+      //the split point is at the beginning of a line
+      const char* last=next_line(target-1,end);
+      //prefer a MODEL record if one is close enough
+      const char* model=next_model(last,last+chunk_size/8<end?last+chunk_size/8:end,end);
+      if (model!=NULL) last=model;
+      chunks_.push_back(Chunk(first,last));
+      first=last;
+    }
+    if (first!=end)
+      chunks_.push_back(Chunk(first,end));
+  }
+  
+  static void parse_chunk(Chunk& chunk){
+    const char* begin=chunk.begin;
+    while (begin!=chunk.end){
+      const char* eol=static_cast<const char*>( memchr(begin,'\n',chunk.end-begin) );
+      if (eol==NULL) eol=chunk.end;
+      Line_span line(begin,eol);
+      begin=(eol==chunk.end)?chunk.end:eol+1;
+      if (line.empty()) continue;
+      chunk.lines.push_back(PDB::Parsed_line(line));
+    }
+  }
+  
+  void worker(){
+    while (true){
+      std::size_t i;
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        while (next_chunk_!=chunks_.size() && next_chunk_>=consumed_chunks_+max_pending_chunks_)
+          chunk_consumed_.wait(lock);
+        if (next_chunk_==chunks_.size()) return;
+        i=next_chunk_++;
+      }
+      Chunk& chunk=chunks_[i];
+      parse_chunk(chunk);
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        chunk.done=true;
+      }
+      chunk_done_.notify_all();
+    }
+  }
+  
+public:
+  /** Constructor.*/
+  Parallel_line_reader(Line_selector& line_selector, Builder& builder):Base(line_selector,builder),next_chunk_(0),consumed_chunks_(0),max_pending_chunks_(1){}
+  
+  /** Reads the lines of a file and give instruction to the builder to construct molecular system(s).
+    * The parameters are the same as those of ESBTL::Line_reader::read, except:
+    * \param nb_threads is the number of worker threads converting fields. If 0, the number of hardware threads is used.
+    * \param min_chunk_size is the minimal size in bytes of a chunk of the file given to a worker thread.
+    * Small files are thus read by one worker thread.
+    * \param max_chunk_size is the maximal size in bytes of a chunk (if larger than min_chunk_size): large files
+    * are split in more chunks, so that the records of the chunks converted ahead stay small.
+    */
+  template <class Occupancy_handler>
+  bool read(const std::string& filename,Occupancy_handler occupancy,char default_altloc=' ',
+            unsigned nb_threads=0,std::size_t min_chunk_size=1<<20,std::size_t max_chunk_size=1<<23)
+  {
+    internal::Mapped_file input;
+    
+    if (! input.open(filename) ){
+      std::cerr << "Problem while trying to open file " << filename << ".\nPlease check that the file exists and that you have the right to read it."  << std::endl;
+      return false;   
+    }
+    
+    if (nb_threads==0) nb_threads=boost::thread::hardware_concurrency();
+    if (nb_threads==0) nb_threads=1;
+    
+    //several chunks per thread to balance the load
+    std::size_t nb_chunks=4*nb_threads;
+    if (max_chunk_size>min_chunk_size && input.size()/nb_chunks > max_chunk_size) nb_chunks=(input.size()+max_chunk_size-1)/max_chunk_size;
+    if (input.size()/nb_chunks < min_chunk_size) nb_chunks=input.size()/min_chunk_size;
+    if (nb_chunks==0) nb_chunks=1;
+    
+    chunks_.clear();
+    next_chunk_=0;
+    consumed_chunks_=0;
+    max_pending_chunks_=2*nb_threads;
+    split(input.data(),input.data()+input.size(),nb_chunks);
+    
+    boost::thread_group workers;
+    for (unsigned i=0;i<nb_threads && i<chunks_.size();++i)
+      workers.add_thread(new boost::thread(&Parallel_line_reader::worker,this));
+    
+    //records are given to the builder in file order, as soon as their chunk is converted
+    int nblines=0;
+    for (typename std::vector<Chunk>::iterator it=chunks_.begin();it!=chunks_.end();++it){
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        while (!it->done)
+          chunk_done_.wait(lock);
+      }
+      for (std::vector<PDB::Parsed_line>::const_iterator itl=it->lines.begin();itl!=it->lines.end();++itl)
+        if (this->read_line(*itl,occupancy,default_altloc))
+          ++nblines;
+      //release the records of the chunk, a worker can take the next one
+      std::vector<PDB::Parsed_line>().swap(it->lines);
+      {
+        boost::mutex::scoped_lock lock(mutex_);
+        ++consumed_chunks_;
+      }
+      chunk_consumed_.notify_all();
+    }
+    
+    workers.join_all();
+    chunks_.clear();
+    return this->finalize(nblines,occupancy,default_altloc);
+  }
+};
+
+/**
+ * Short cut to read a PDB file using several threads. See the documentation of ESBTL::Parallel_line_reader::read for more details.
+ */
+template<class Line_selector,class Builder,class Occupancy_handler>
+inline
+bool read_a_pdb_file_in_parallel(const std::string& filename,Line_selector& sel,Builder& builder,const Occupancy_handler& occupancy,
+                                 char altloc=' ',unsigned nb_threads=0)
+{
+  return Parallel_line_reader<PDB::Line_format<>,Line_selector,Builder>(sel,builder).read(filename,occupancy,altloc,nb_threads);
+}
+
+} //namespace ESBTL
+
+#endif // ESBTL_PARALLEL_LINE_READER_H
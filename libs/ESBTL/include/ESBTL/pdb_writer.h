@@ -0,0 +1,249 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+#ifndef ESBTL_PDB_WRITER_H
+#define ESBTL_PDB_WRITER_H
+
+#include <string>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <ESBTL/PDB.h>
+
+namespace ESBTL{
+
+/**
+  * Class writing atoms in the PDB format to a file descriptor.
+  * The lines are formatted directly into a buffer (the output is identical to ESBTL::PDB::get_atom_pdb_format),
+  * which is written once it exceeds a given size. With a writer thread, a full buffer is written while the
+  * next one is formatted. Buffers are reused, so that no memory is allocated after the first buffers are full.
+  *
+  * Using the writer thread requires the boost_thread library.
+  */
+class PDB_writer{
+  int fd_;
+  bool owns_fd_;
+  bool failed_;
+  std::size_t buffer_size_;
+  std::string buffer_;
+  
+  //writer thread
+  boost::thread* thread_;
+  boost::mutex mutex_;
+  boost::condition_variable condition_;
+  std::string pending_;
+  bool has_pending_;
+  bool stop_;
+  bool threaded_;
+  
+  PDB_writer(const PDB_writer&);
+  PDB_writer& operator=(const PDB_writer&);
+  
+  bool write_all(const std::string& data){
+    const char* begin=data.data();
+    std::size_t size=data.size();
+    while (size!=0){
+      ssize_t n=::write(fd_,begin,size);
+      if (n==-1){
+        if (errno==EINTR) continue;
+        return false;
+      }
+      begin+=n;
+      size-=n;
+    }
+    return true;
+  }
+  
+  void writer(){
+    std::string writing;
+    writing.reserve(buffer_size_+256);
+    while (true){
+      {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (!has_pending_ && !stop_) condition_.wait(lock);
+        if (!has_pending_) return;
+        writing.swap(pending_);
+        has_pending_=false;
+        condition_.notify_all();
+      }
+      bool ok=write_all(writing);
+      writing.clear();
+      if (!ok){
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        failed_=true;
+      }
+    }
+  }
+  
+  //write the buffer, or give it to the writer thread
+  void submit(){
+    if (buffer_.empty()) return;
+    if (thread_==NULL){
+      if (!write_all(buffer_)) failed_=true;
+      buffer_.clear();
+      return;
+    }
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    while (has_pending_) condition_.wait(lock);
+    pending_.swap(buffer_);
+    has_pending_=true;
+    condition_.notify_all();
+    buffer_.clear();
+  }
+  
+  void start(bool threaded){
+    failed_=false;
+    buffer_.reserve(buffer_size_+256);
+    if (threaded){
+      pending_.reserve(buffer_size_+256);
+      has_pending_=false;
+      stop_=false;
+      thread_=new boost::thread(&PDB_writer::writer,this);
+    }
+  }
+  
+public:
+  /** Constructor.
+    * \param buffer_size is the size above which the buffer is written.
+    * \param threaded tells whether the buffers are written by a separate thread.
+    */
+  PDB_writer(std::size_t buffer_size=1<<20,bool threaded=false):
+    fd_(-1),owns_fd_(false),failed_(false),buffer_size_(buffer_size),thread_(NULL),has_pending_(false),stop_(false),threaded_(threaded){}
+  
+  ~PDB_writer(){close();}
+  
+  /** Creates (or truncates) a file and writes into it. Returns false if the file can not be opened.*/
+  bool open(const std::string& filename){
+    close();
+    fd_=::open(filename.c_str(),O_WRONLY|O_CREAT|O_TRUNC,0644);
+    if (fd_==-1) return false;
+    owns_fd_=true;
+    start(threaded_);
+    return true;
+  }
+  
+  /** Writes into an opened file descriptor (like 1 for the standard output), which is not closed by the writer.*/
+  void open(int fd){
+    close();
+    fd_=fd;
+    owns_fd_=false;
+    start(threaded_);
+  }
+  
+  /** Appends a line (end of line excluded), like "END".*/
+  void write_line(const std::string& line){
+    buffer_+=line;
+    buffer_+='\n';
+    if (buffer_.size()>=buffer_size_) submit();
+  }
+  
+  /** Appends the PDB line of an atom.*/
+  template <class PDB_Atom>
+  void write_atom(const PDB_Atom& atom){
+    PDB::append_atom_pdb_format(buffer_,atom);
+    buffer_+='\n';
+    if (buffer_.size()>=buffer_size_) submit();
+  }
+  
+  /** Appends the PDB lines of a range of atoms.*/
+  template <class Atom_iterator>
+  void write_atoms(Atom_iterator begin,Atom_iterator end){
+    for (;begin!=end;++begin)
+      write_atom(*begin);
+  }
+  
+  /** Appends the atoms of a model between a \c MODEL and a \c ENDMDL record.*/
+  template <class Model>
+  void write_model(const Model& model){
+    buffer_.append("MODEL     ");
+    internal::append_integer(buffer_,model.model_number(),4);
+    buffer_+='\n';
+    write_atoms(model.atoms_begin(),model.atoms_end());
+    write_line("ENDMDL");
+  }
+  
+  /** Writes the content of the buffer. Returns false if a write failed.*/
+  bool flush(){
+    submit();
+    if (thread_!=NULL){
+      boost::unique_lock<boost::mutex> lock(mutex_);
+      while (has_pending_) condition_.wait(lock);
+    }
+    return !failed();
+  }
+  
+  /** Writes the content of the buffer and closes the file (if opened by the writer). Returns false if a write failed.*/
+  bool close(){
+    if (fd_==-1) return !failed_;
+    submit();
+    if (thread_!=NULL){
+      {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        stop_=true;
+        condition_.notify_all();
+      }
+      thread_->join();
+      delete thread_;
+      thread_=NULL;
+    }
+    if (owns_fd_ && ::close(fd_)==-1) failed_=true;
+    fd_=-1;
+    return !failed_;
+  }
+  
+  /** Tells whether a write failed.*/
+  bool failed(){
+    if (thread_==NULL) return failed_;
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    return failed_;
+  }
+};
+
+/** Writes the atoms of a model in a PDB file (\c MODEL record, atoms, \c ENDMDL and \c END records).
+  * Returns false if the file can not be written.
+  */
+template <class Model>
+bool write_a_pdb_file(const std::string& filename,const Model& model,bool threaded=false){
+  PDB_writer writer(1<<20,threaded);
+  if (!writer.open(filename)) return false;
+  writer.write_model(model);
+  writer.write_line("END");
+  return writer.close();
+}
+
+} //namespace ESBTL
+
+#endif //ESBTL_PDB_WRITER_H
@@ -1,190 +1,190 @@
-dict["ALAO"]=0;
-dict["ARGO"]=0;
-dict["ASNO"]=0;
-dict["ASNOD1"]=0;
-dict["ASPO"]=0;
-dict["ASPOD1"]=0;
-dict["ASPOD2"]=0;
-dict["CYSO"]=0;
-dict["GLNO"]=0;
-dict["GLNOE1"]=0;
-dict["GLUO"]=0;
-dict["GLUOE1"]=0;
-dict["GLUOE2"]=0;
-dict["GLYO"]=0;
-dict["HISO"]=0;
-dict["ILEO"]=0;
-dict["LEUO"]=0;
-dict["LYSO"]=0;
-dict["METO"]=0;
-dict["PHEO"]=0;
-dict["PROO"]=0;
-dict["SERO"]=0;
-dict["THRO"]=0;
-dict["TRPO"]=0;
-dict["TYRO"]=0;
-dict["VALO"]=0;
-dict["SEROG"]=1;
-dict["THROG1"]=1;
-dict["TYROH"]=1;
-dict["ALACA"]=2;
-dict["ALACB"]=2;
-dict["ARGCA"]=2;
-dict["ARGCB"]=2;
-dict["ARGCD"]=2;
-dict["ARGCG"]=2;
-dict["ASNCA"]=2;
-dict["ASNCB"]=2;
-dict["ASPCA"]=2;
-dict["ASPCB"]=2;
-dict["CYSCA"]=2;
-dict["CYSCB"]=2;
-dict["GLNCA"]=2;
-dict["GLNCB"]=2;
-dict["GLNCG"]=2;
-dict["GLUCA"]=2;
-dict["GLUCB"]=2;
-dict["GLUCG"]=2;
-dict["GLYCA"]=2;
-dict["HISCA"]=2;
-dict["HISCB"]=2;
-dict["ILECA"]=2;
-dict["ILECB"]=2;
-dict["ILECD1"]=2;
-dict["ILECG1"]=2;
-dict["ILECG2"]=2;
-dict["LEUCA"]=2;
-dict["LEUCB"]=2;
-dict["LEUCD1"]=2;
-dict["LEUCD2"]=2;
-dict["LEUCG"]=2;
-dict["LYSCA"]=2;
-dict["LYSCB"]=2;
-dict["LYSCD"]=2;
-dict["LYSCE"]=2;
-dict["LYSCG"]=2;
-dict["METCA"]=2;
-dict["METCB"]=2;
-dict["METCE"]=2;
-dict["METCG"]=2;
-dict["PHECA"]=2;
-dict["PHECB"]=2;
-dict["PROCA"]=2;
-dict["PROCB"]=2;
-dict["PROCD"]=2;
-dict["PROCG"]=2;
-dict["SERCA"]=2;
-dict["SERCB"]=2;
-dict["THRCA"]=2;
-dict["THRCB"]=2;
-dict["THRCG2"]=2;
-dict["TRPCA"]=2;
-dict["TRPCB"]=2;
-dict["TYRCA"]=2;
-dict["TYRCB"]=2;
-dict["VALCA"]=2;
-dict["VALCB"]=2;
-dict["VALCG1"]=2;
-dict["VALCG2"]=2;
-dict["CYSSG"]=3;
-dict["METSD"]=3;
-dict["ALAC"]=4;
-dict["ARGC"]=4;
-dict["ARGCZ"]=4;
-dict["ASNC"]=4;
-dict["ASNCG"]=4;
-dict["ASPC"]=4;
-dict["ASPCG"]=4;
-dict["CYSC"]=4;
-dict["GLNC"]=4;
-dict["GLNCD"]=4;
-dict["GLUC"]=4;
-dict["GLUCD"]=4;
-dict["GLYC"]=4;
-dict["HISC"]=4;
-dict["ILEC"]=4;
-dict["LEUC"]=4;
-dict["LYSC"]=4;
-dict["METC"]=4;
-dict["PHEC"]=4;
-dict["PROC"]=4;
-dict["SERC"]=4;
-dict["THRC"]=4;
-dict["TRPC"]=4;
-dict["TYRC"]=4;
-dict["VALC"]=4;
-dict["ALAN"]=5;
-dict["ARGN"]=5;
-dict["ARGNE"]=5;
-dict["ARGNH1"]=5;
-dict["ARGNH2"]=5;
-dict["ASNN"]=5;
-dict["ASNND2"]=5;
-dict["ASPN"]=5;
-dict["CYSN"]=5;
-dict["GLNN"]=5;
-dict["GLNNE2"]=5;
-dict["GLUN"]=5;
-dict["GLYN"]=5;
-dict["HISN"]=5;
-dict["HISND1"]=5;
-dict["HISNE2"]=5;
-dict["ILEN"]=5;
-dict["LEUN"]=5;
-dict["LYSN"]=5;
-dict["LYSNZ"]=5;
-dict["METN"]=5;
-dict["PHEN"]=5;
-dict["PRON"]=5;
-dict["SERN"]=5;
-dict["THRN"]=5;
-dict["TRPN"]=5;
-dict["TRPNE1"]=5;
-dict["TYRN"]=5;
-dict["VALN"]=5;
-dict["HISCD2"]=6;
-dict["HISCE1"]=6;
-dict["HISCG"]=6;
-dict["PHECD1"]=6;
-dict["PHECD2"]=6;
-dict["PHECE1"]=6;
-dict["PHECE2"]=6;
-dict["PHECG"]=6;
-dict["PHECZ"]=6;
-dict["TRPCD1"]=6;
-dict["TRPCD2"]=6;
-dict["TRPCE2"]=6;
-dict["TRPCE3"]=6;
-dict["TRPCG"]=6;
-dict["TRPCH2"]=6;
-dict["TRPCZ2"]=6;
-dict["TRPCZ3"]=6;
-dict["TYRCD1"]=6;
-dict["TYRCD2"]=6;
-dict["TYRCE1"]=6;
-dict["TYRCE2"]=6;
-dict["TYRCG"]=6;
-dict["TYRCZ"]=6;
-dict["ALAOXT"]=0;
-dict["ARGOXT"]=0;
-dict["ASNOXT"]=0;
-dict["ASPOXT"]=0;
-dict["CYSOXT"]=0;
-dict["GLNOXT"]=0;
-dict["GLUOXT"]=0;
-dict["GLYOXT"]=0;
-dict["HISOXT"]=0;
-dict["ILEOXT"]=0;
-dict["LEUOXT"]=0;
-dict["LYSOXT"]=0;
-dict["METOXT"]=0;
-dict["PHEOXT"]=0;
-dict["PROOXT"]=0;
-dict["SEROXT"]=0;
-dict["THROXT"]=0;
-dict["TRPOXT"]=0;
-dict["TYROXT"]=0;
-dict["VALOXT"]=0;
+dict[Key_type("ALA","O")]=0;
+dict[Key_type("ARG","O")]=0;
+dict[Key_type("ASN","O")]=0;
+dict[Key_type("ASN","OD1")]=0;
+dict[Key_type("ASP","O")]=0;
+dict[Key_type("ASP","OD1")]=0;
+dict[Key_type("ASP","OD2")]=0;
+dict[Key_type("CYS","O")]=0;
+dict[Key_type("GLN","O")]=0;
+dict[Key_type("GLN","OE1")]=0;
+dict[Key_type("GLU","O")]=0;
+dict[Key_type("GLU","OE1")]=0;
+dict[Key_type("GLU","OE2")]=0;
+dict[Key_type("GLY","O")]=0;
+dict[Key_type("HIS","O")]=0;
+dict[Key_type("ILE","O")]=0;
+dict[Key_type("LEU","O")]=0;
+dict[Key_type("LYS","O")]=0;
+dict[Key_type("MET","O")]=0;
+dict[Key_type("PHE","O")]=0;
+dict[Key_type("PRO","O")]=0;
+dict[Key_type("SER","O")]=0;
+dict[Key_type("THR","O")]=0;
+dict[Key_type("TRP","O")]=0;
+dict[Key_type("TYR","O")]=0;
+dict[Key_type("VAL","O")]=0;
+dict[Key_type("SER","OG")]=1;
+dict[Key_type("THR","OG1")]=1;
+dict[Key_type("TYR","OH")]=1;
+dict[Key_type("ALA","CA")]=2;
+dict[Key_type("ALA","CB")]=2;
+dict[Key_type("ARG","CA")]=2;
+dict[Key_type("ARG","CB")]=2;
+dict[Key_type("ARG","CD")]=2;
+dict[Key_type("ARG","CG")]=2;
+dict[Key_type("ASN","CA")]=2;
+dict[Key_type("ASN","CB")]=2;
+dict[Key_type("ASP","CA")]=2;
+dict[Key_type("ASP","CB")]=2;
+dict[Key_type("CYS","CA")]=2;
+dict[Key_type("CYS","CB")]=2;
+dict[Key_type("GLN","CA")]=2;
+dict[Key_type("GLN","CB")]=2;
+dict[Key_type("GLN","CG")]=2;
+dict[Key_type("GLU","CA")]=2;
+dict[Key_type("GLU","CB")]=2;
+dict[Key_type("GLU","CG")]=2;
+dict[Key_type("GLY","CA")]=2;
+dict[Key_type("HIS","CA")]=2;
+dict[Key_type("HIS","CB")]=2;
+dict[Key_type("ILE","CA")]=2;
+dict[Key_type("ILE","CB")]=2;
+dict[Key_type("ILE","CD1")]=2;
+dict[Key_type("ILE","CG1")]=2;
+dict[Key_type("ILE","CG2")]=2;
+dict[Key_type("LEU","CA")]=2;
+dict[Key_type("LEU","CB")]=2;
+dict[Key_type("LEU","CD1")]=2;
+dict[Key_type("LEU","CD2")]=2;
+dict[Key_type("LEU","CG")]=2;
+dict[Key_type("LYS","CA")]=2;
+dict[Key_type("LYS","CB")]=2;
+dict[Key_type("LYS","CD")]=2;
+dict[Key_type("LYS","CE")]=2;
+dict[Key_type("LYS","CG")]=2;
+dict[Key_type("MET","CA")]=2;
+dict[Key_type("MET","CB")]=2;
+dict[Key_type("MET","CE")]=2;
+dict[Key_type("MET","CG")]=2;
+dict[Key_type("PHE","CA")]=2;
+dict[Key_type("PHE","CB")]=2;
+dict[Key_type("PRO","CA")]=2;
+dict[Key_type("PRO","CB")]=2;
+dict[Key_type("PRO","CD")]=2;
+dict[Key_type("PRO","CG")]=2;
+dict[Key_type("SER","CA")]=2;
+dict[Key_type("SER","CB")]=2;
+dict[Key_type("THR","CA")]=2;
+dict[Key_type("THR","CB")]=2;
+dict[Key_type("THR","CG2")]=2;
+dict[Key_type("TRP","CA")]=2;
+dict[Key_type("TRP","CB")]=2;
+dict[Key_type("TYR","CA")]=2;
+dict[Key_type("TYR","CB")]=2;
+dict[Key_type("VAL","CA")]=2;
+dict[Key_type("VAL","CB")]=2;
+dict[Key_type("VAL","CG1")]=2;
+dict[Key_type("VAL","CG2")]=2;
+dict[Key_type("CYS","SG")]=3;
+dict[Key_type("MET","SD")]=3;
+dict[Key_type("ALA","C")]=4;
+dict[Key_type("ARG","C")]=4;
+dict[Key_type("ARG","CZ")]=4;
+dict[Key_type("ASN","C")]=4;
+dict[Key_type("ASN","CG")]=4;
+dict[Key_type("ASP","C")]=4;
+dict[Key_type("ASP","CG")]=4;
+dict[Key_type("CYS","C")]=4;
+dict[Key_type("GLN","C")]=4;
+dict[Key_type("GLN","CD")]=4;
+dict[Key_type("GLU","C")]=4;
+dict[Key_type("GLU","CD")]=4;
+dict[Key_type("GLY","C")]=4;
+dict[Key_type("HIS","C")]=4;
+dict[Key_type("ILE","C")]=4;
+dict[Key_type("LEU","C")]=4;
+dict[Key_type("LYS","C")]=4;
+dict[Key_type("MET","C")]=4;
+dict[Key_type("PHE","C")]=4;
+dict[Key_type("PRO","C")]=4;
+dict[Key_type("SER","C")]=4;
+dict[Key_type("THR","C")]=4;
+dict[Key_type("TRP","C")]=4;
+dict[Key_type("TYR","C")]=4;
+dict[Key_type("VAL","C")]=4;
+dict[Key_type("ALA","N")]=5;
+dict[Key_type("ARG","N")]=5;
+dict[Key_type("ARG","NE")]=5;
+dict[Key_type("ARG","NH1")]=5;
+dict[Key_type("ARG","NH2")]=5;
+dict[Key_type("ASN","N")]=5;
+dict[Key_type("ASN","ND2")]=5;
+dict[Key_type("ASP","N")]=5;
+dict[Key_type("CYS","N")]=5;
+dict[Key_type("GLN","N")]=5;
+dict[Key_type("GLN","NE2")]=5;
+dict[Key_type("GLU","N")]=5;
+dict[Key_type("GLY","N")]=5;
+dict[Key_type("HIS","N")]=5;
+dict[Key_type("HIS","ND1")]=5;
+dict[Key_type("HIS","NE2")]=5;
+dict[Key_type("ILE","N")]=5;
+dict[Key_type("LEU","N")]=5;
+dict[Key_type("LYS","N")]=5;
+dict[Key_type("LYS","NZ")]=5;
+dict[Key_type("MET","N")]=5;
+dict[Key_type("PHE","N")]=5;
+dict[Key_type("PRO","N")]=5;
+dict[Key_type("SER","N")]=5;
+dict[Key_type("THR","N")]=5;
+dict[Key_type("TRP","N")]=5;
+dict[Key_type("TRP","NE1")]=5;
+dict[Key_type("TYR","N")]=5;
+dict[Key_type("VAL","N")]=5;
+dict[Key_type("HIS","CD2")]=6;
+dict[Key_type("HIS","CE1")]=6;
+dict[Key_type("HIS","CG")]=6;
+dict[Key_type("PHE","CD1")]=6;
+dict[Key_type("PHE","CD2")]=6;
+dict[Key_type("PHE","CE1")]=6;
+dict[Key_type("PHE","CE2")]=6;
+dict[Key_type("PHE","CG")]=6;
+dict[Key_type("PHE","CZ")]=6;
+dict[Key_type("TRP","CD1")]=6;
+dict[Key_type("TRP","CD2")]=6;
+dict[Key_type("TRP","CE2")]=6;
+dict[Key_type("TRP","CE3")]=6;
+dict[Key_type("TRP","CG")]=6;
+dict[Key_type("TRP","CH2")]=6;
+dict[Key_type("TRP","CZ2")]=6;
+dict[Key_type("TRP","CZ3")]=6;
+dict[Key_type("TYR","CD1")]=6;
+dict[Key_type("TYR","CD2")]=6;
+dict[Key_type("TYR","CE1")]=6;
+dict[Key_type("TYR","CE2")]=6;
+dict[Key_type("TYR","CG")]=6;
+dict[Key_type("TYR","CZ")]=6;
+dict[Key_type("ALA","OXT")]=0;
+dict[Key_type("ARG","OXT")]=0;
+dict[Key_type("ASN","OXT")]=0;
+dict[Key_type("ASP","OXT")]=0;
+dict[Key_type("CYS","OXT")]=0;
+dict[Key_type("GLN","OXT")]=0;
+dict[Key_type("GLU","OXT")]=0;
+dict[Key_type("GLY","OXT")]=0;
+dict[Key_type("HIS","OXT")]=0;
+dict[Key_type("ILE","OXT")]=0;
+dict[Key_type("LEU","OXT")]=0;
+dict[Key_type("LYS","OXT")]=0;
+dict[Key_type("MET","OXT")]=0;
+dict[Key_type("PHE","OXT")]=0;
+dict[Key_type("PRO","OXT")]=0;
+dict[Key_type("SER","OXT")]=0;
+dict[Key_type("THR","OXT")]=0;
+dict[Key_type("TRP","OXT")]=0;
+dict[Key_type("TYR","OXT")]=0;
+dict[Key_type("VAL","OXT")]=0;
 
 vect.reserve(8);
 
@@ -1,533 +1,533 @@
-dict["UNKC"]=0;
-dict["UNKO"]=6;
-dict["UNKN"]=3;
-dict["UNKS"]=10;
-dict["GLYC"]=2;
-dict["GLYCA"]=0;
-dict["GLYO"]=7;
-dict["GLYN"]=3;
-dict["GLYOXT"]=6;
-dict["GLYO1"]=6;
-dict["GLYO2"]=6;
-dict["ALAC"]=2;
-dict["ALACB"]=0;
-dict["ALACA"]=0;
-dict["ALAO"]=7;
-dict["ALAN"]=3;
-dict["ALAOXT"]=6;
-dict["ALAO1"]=6;
-dict["ALAO2"]=6;
-dict["LEUC"]=2;
-dict["LEUCB"]=0;
-dict["LEUCA"]=0;
-dict["LEUCG"]=0;
-dict["LEUO"]=7;
-dict["LEUN"]=3;
-dict["LEUCD1"]=0;
-dict["LEUCD2"]=0;
-dict["LEUOXT"]=6;
-dict["LEUO1"]=6;
-dict["LEUO2"]=6;
-dict["ILEC"]=2;
-dict["ILEN"]=3;
-dict["ILECB"]=0;
-dict["ILECA"]=0;
-dict["ILEO"]=7;
-dict["ILECD"]=0;
-dict["ILECD1"]=0;
-dict["ILECG1"]=0;
-dict["ILECG2"]=0;
-dict["ILEOXT"]=6;
-dict["ILEO1"]=6;
-dict["ILEO2"]=6;
-dict["VALC"]=2;
-dict["VALCB"]=0;
-dict["VALCA"]=0;
-dict["VALO"]=7;
-dict["VALN"]=3;
-dict["VALCG1"]=0;
-dict["VALCG2"]=0;
-dict["VALOXT"]=6;
-dict["VALO1"]=6;
-dict["VALO2"]=6;
-dict["ASPC"]=2;
-dict["ASPCB"]=0;
-dict["ASPCA"]=0;
-dict["ASPCG"]=1;
-dict["ASPO"]=7;
-dict["ASPN"]=3;
-dict["ASPOD1"]=8;
-dict["ASPOD2"]=8;
-dict["ASPOXT"]=6;
-dict["ASPO1"]=6;
-dict["ASPO2"]=6;
-dict["GLUC"]=2;
-dict["GLUCB"]=0;
-dict["GLUCA"]=0;
-dict["GLUCG"]=0;
-dict["GLUO"]=7;
-dict["GLUCD"]=1;
-dict["GLUN"]=3;
-dict["GLUOE2"]=8;
-dict["GLUOE1"]=8;
-dict["GLUOXT"]=6;
-dict["GLUO1"]=6;
-dict["GLUO2"]=6;
-dict["ASNC"]=2;
-dict["ASNND2"]=3;
-dict["ASNCB"]=0;
-dict["ASNCA"]=0;
-dict["ASNCG"]=1;
-dict["ASNO"]=7;
-dict["ASNN"]=3;
-dict["ASNOD1"]=6;
-dict["ASNOXT"]=6;
-dict["ASNO1"]=6;
-dict["ASNO2"]=6;
-dict["GLNC"]=2;
-dict["GLNCB"]=0;
-dict["GLNCA"]=0;
-dict["GLNCG"]=0;
-dict["GLNO"]=7;
-dict["GLNCD"]=1;
-dict["GLNN"]=3;
-dict["GLNNE2"]=3;
-dict["GLNOE1"]=6;
-dict["GLNOXT"]=6;
-dict["GLNO1"]=6;
-dict["GLNO2"]=6;
-dict["HISC"]=2;
-dict["HISCD2"]=1;
-dict["HISCB"]=0;
-dict["HISCA"]=0;
-dict["HISCG"]=1;
-dict["HISO"]=7;
-dict["HISN"]=3;
-dict["HISCE1"]=1;
-dict["HISND1"]=4;
-dict["HISNE2"]=4;
-dict["HISOXT"]=6;
-dict["HISO1"]=6;
-dict["HISO2"]=6;
-dict["HSEC"]=2;
-dict["HSECD2"]=1;
-dict["HSECB"]=0;
-dict["HSECA"]=0;
-dict["HSECG"]=1;
-dict["HSEO"]=7;
-dict["HSEN"]=3;
-dict["HSECE1"]=1;
-dict["HSEND1"]=4;
-dict["HSENE2"]=4;
-dict["HSEOXT"]=6;
-dict["HSEO1"]=6;
-dict["HSEO2"]=6;
-dict["SERC"]=2;
-dict["SEROG"]=6;
-dict["SERCB"]=0;
-dict["SERCA"]=0;
-dict["SERO"]=7;
-dict["SERN"]=3;
-dict["SEROXT"]=6;
-dict["SERO1"]=6;
-dict["SERO2"]=6;
-dict["THRC"]=2;
-dict["THRCB"]=0;
-dict["THRCA"]=0;
-dict["THROG1"]=6;
-dict["THRO"]=7;
-dict["THRN"]=3;
-dict["THRCG2"]=0;
-dict["THROXT"]=6;
-dict["THRO1"]=6;
-dict["THRO2"]=6;
-dict["CYSC"]=2;
-dict["CYSCB"]=0;
-dict["CYSCA"]=0;
-dict["CYSO"]=7;
-dict["CYSN"]=3;
-dict["CYSSG"]=10;
-dict["CYSOXT"]=6;
-dict["CYSO1"]=6;
-dict["CYSO2"]=6;
-dict["METC"]=2;
-dict["METCB"]=0;
-dict["METCA"]=0;
-dict["METCG"]=0;
-dict["METCE"]=0;
-dict["METN"]=3;
-dict["METSD"]=10;
-dict["METO"]=7;
-dict["METOXT"]=6;
-dict["METO1"]=6;
-dict["METO2"]=6;
-dict["MSEC"]=2;
-dict["MSECB"]=0;
-dict["MSECA"]=0;
-dict["MSECG"]=0;
-dict["MSECE"]=0;
-dict["MSEN"]=3;
-dict["MSESD"]=10;
-dict["MSEO"]=7;
-dict["MSEOXT"]=6;
-dict["MSEO1"]=6;
-dict["MSEO2"]=6;
-dict["MSESE"]=10;
-dict["PROC"]=2;
-dict["PROCB"]=0;
-dict["PROCA"]=0;
-dict["PROCG"]=0;
-dict["PROO"]=7;
-dict["PROCD"]=0;
-dict["PRON"]=3;
-dict["PROOXT"]=6;
-dict["PROO1"]=6;
-dict["PROO2"]=6;
-dict["ARGNE"]=5;
-dict["ARGC"]=2;
-dict["ARGCB"]=0;
-dict["ARGCA"]=0;
-dict["ARGCG"]=0;
-dict["ARGO"]=7;
-dict["ARGCD"]=0;
-dict["ARGCZ"]=1;
-dict["ARGNH1"]=5;
-dict["ARGNH2"]=5;
-dict["ARGN"]=3;
-dict["ARGOXT"]=6;
-dict["ARGO1"]=6;
-dict["ARGO2"]=6;
-dict["LYSNZ"]=5;
-dict["LYSC"]=2;
-dict["LYSCB"]=0;
-dict["LYSCA"]=0;
-dict["LYSCG"]=0;
-dict["LYSCE"]=0;
-dict["LYSCD"]=0;
-dict["LYSO"]=7;
-dict["LYSN"]=3;
-dict["LYSOXT"]=6;
-dict["LYSO1"]=6;
-dict["LYSO2"]=6;
-dict["PHEC"]=2;
-dict["PHECD2"]=1;
-dict["PHECB"]=0;
-dict["PHECA"]=0;
-dict["PHECG"]=1;
-dict["PHEO"]=7;
-dict["PHECZ"]=1;
-dict["PHEN"]=3;
-dict["PHECD1"]=1;
-dict["PHECE1"]=1;
-dict["PHECE2"]=1;
-dict["PHEOXT"]=6;
-dict["PHEO1"]=6;
-dict["PHEO2"]=6;
-dict["TYRC"]=2;
-dict["TYRCD2"]=1;
-dict["TYROH"]=6;
-dict["TYRN"]=3;
-dict["TYRCB"]=0;
-dict["TYRCA"]=0;
-dict["TYRCG"]=1;
-dict["TYRO"]=7;
-dict["TYRCZ"]=1;
-dict["TYRCD1"]=1;
-dict["TYRCE1"]=1;
-dict["TYRCE2"]=1;
-dict["TYROXT"]=6;
-dict["TYRO1"]=6;
-dict["TYRO2"]=6;
-dict["TRPCZ2"]=1;
-dict["TRPCZ3"]=1;
-dict["TRPCD1"]=1;
-dict["TRPCD2"]=1;
-dict["TRPCH2"]=1;
-dict["TRPC"]=2;
-dict["TRPCB"]=0;
-dict["TRPCA"]=0;
-dict["TRPCG"]=1;
-dict["TRPO"]=7;
-dict["TRPN"]=3;
-dict["TRPCE3"]=1;
-dict["TRPCE2"]=1;
-dict["TRPNE1"]=4;
-dict["TRPOXT"]=6;
-dict["TRPO1"]=6;
-dict["TRPO2"]=6;
-dict["HOHO"]=9;
-dict["HOHOW"]=9;
-dict["SOLO"]=9;
-dict["SOLOW"]=9;
-dict["DGP"]=11;
-dict["DGOP1"]=12;
-dict["DGOP2"]=12;
-dict["DGOP3"]=12;
-dict["DGO5'"]=6;
-dict["DGC5'"]=0;
-dict["DGC4'"]=0;
-dict["DGO4'"]=13;
-dict["DGC3'"]=0;
-dict["DGO3'"]=6;
-dict["DGC2'"]=0;
-dict["DGC1'"]=0;
-dict["DGN9"]=3;
-dict["DGC8"]=1;
-dict["DGN7"]=4;
-dict["DGC5"]=1;
-dict["DGC6"]=1;
-dict["DGO6"]=6;
-dict["DGN1"]=4;
-dict["DGC2"]=1;
-dict["DGN2"]=3;
-dict["DGN3"]=4;
-dict["DGC4"]=1;
-dict["DCP"]=11;
-dict["DCOP1"]=12;
-dict["DCOP2"]=12;
-dict["DCOP3"]=12;
-dict["DCO5'"]=6;
-dict["DCC5'"]=0;
-dict["DCC4'"]=0;
-dict["DCO4'"]=13;
-dict["DCC3'"]=0;
-dict["DCO3'"]=6;
-dict["DCC2'"]=0;
-dict["DCC1'"]=0;
-dict["DCN1"]=3;
-dict["DCC2"]=1;
-dict["DCO2"]=6;
-dict["DCN3"]=4;
-dict["DCC4"]=1;
-dict["DCN4"]=3;
-dict["DCC5"]=1;
-dict["DCC6"]=1;
-dict["DAP"]=11;
-dict["DAOP1"]=12;
-dict["DAOP2"]=12;
-dict["DAOP3"]=12;
-dict["DAO5'"]=6;
-dict["DAC5'"]=0;
-dict["DAC4'"]=0;
-dict["DAO4'"]=13;
-dict["DAC3'"]=0;
-dict["DAO3'"]=6;
-dict["DAC2'"]=0;
-dict["DAC1'"]=0;
-dict["DAN9"]=3;
-dict["DAC8"]=1;
-dict["DAN7"]=4;
-dict["DAC5"]=1;
-dict["DAC6"]=1;
-dict["DAN6"]=3;
-dict["DAN1"]=3;
-dict["DAC2"]=1;
-dict["DAN3"]=4;
-dict["DAC4"]=1;
-dict["DTP"]=11;
-dict["DTOP1"]=12;
-dict["DTOP2"]=12;
-dict["DTOP3"]=12;
-dict["DTO5'"]=6;
-dict["DTC5'"]=0;
-dict["DTC4'"]=0;
-dict["DTO4'"]=13;
-dict["DTC3'"]=0;
-dict["DTO3'"]=6;
-dict["DTC2'"]=0;
-dict["DTC1'"]=0;
-dict["DTN1"]=3;
-dict["DTC2"]=1;
-dict["DTO2"]=6;
-dict["DTN3"]=3;
-dict["DTC4"]=1;
-dict["DTO4"]=6;
-dict["DTC5"]=1;
-dict["DTC7"]=0;
-dict["DTC6"]=1;
-dict["GP"]=11;
-dict["GOP1"]=12;
-dict["GOP2"]=12;
-dict["GOP3"]=12;
-dict["GO5'"]=6;
-dict["GC5'"]=0;
-dict["GC4'"]=0;
-dict["GO4'"]=13;
-dict["GC3'"]=0;
-dict["GO3'"]=6;
-dict["GC2'"]=0;
-dict["GO2'"]=6;
-dict["GC1'"]=0;
-dict["GN9"]=3;
-dict["GC8"]=1;
-dict["GN7"]=4;
-dict["GC5"]=1;
-dict["GC6"]=1;
-dict["GO6"]=6;
-dict["GN1"]=4;
-dict["GC2"]=1;
-dict["GN2"]=3;
-dict["GN3"]=4;
-dict["GC4"]=1;
-dict["GC10"]=0;
-dict["GC11"]=1;
-dict["GC12"]=1;
-dict["GC13"]=0;
-dict["GC14"]=0;
-dict["GC15"]=0;
-dict["GC16"]=0;
-dict["GC19"]=0;
-dict["GC21"]=0;
-dict["GC24"]=0;
-dict["GC3"]=0;
-dict["GCM1"]=0;
-dict["GCM2"]=0;
-dict["GCM7"]=0;
-dict["GN20"]=3;
-dict["GO17"]=7;
-dict["GO18"]=8;
-dict["GO22"]=7;
-dict["GO23"]=8;
-dict["CP"]=11;
-dict["COP1"]=12;
-dict["COP2"]=12;
-dict["COP3"]=12;
-dict["CO5'"]=6;
-dict["CC5'"]=0;
-dict["CC4'"]=0;
-dict["CO4'"]=13;
-dict["CC3'"]=0;
-dict["CO3'"]=6;
-dict["CC2'"]=0;
-dict["CO2'"]=6;
-dict["CC1'"]=0;
-dict["CN1"]=3;
-dict["CC2"]=1;
-dict["CO2"]=6;
-dict["CN3"]=4;
-dict["CC4"]=1;
-dict["CN4"]=3;
-dict["CC5"]=1;
-dict["CC6"]=1;
-dict["CCM2"]=0;
-dict["CCM5"]=0;
-dict["AP"]=11;
-dict["AOP1"]=12;
-dict["AOP2"]=12;
-dict["AOP3"]=12;
-dict["AO5'"]=6;
-dict["AC5'"]=0;
-dict["AC4'"]=0;
-dict["AO4'"]=13;
-dict["AC3'"]=0;
-dict["AO3'"]=6;
-dict["AC2'"]=0;
-dict["AO2'"]=6;
-dict["AC1'"]=0;
-dict["AN9"]=3;
-dict["AC8"]=1;
-dict["AN7"]=4;
-dict["AC5"]=1;
-dict["AC6"]=1;
-dict["AN6"]=3;
-dict["AN1"]=3;
-dict["AC2"]=1;
-dict["AN3"]=4;
-dict["AC4"]=1;
-dict["ACM1"]=0;
-dict["UP"]=11;
-dict["UOP1"]=12;
-dict["UOP2"]=12;
-dict["UOP3"]=12;
-dict["UO5'"]=6;
-dict["UC5'"]=0;
-dict["UC4'"]=0;
-dict["UO4'"]=13;
-dict["UC3'"]=0;
-dict["UO3'"]=6;
-dict["UC2'"]=0;
-dict["UO2'"]=6;
-dict["UC1'"]=0;
-dict["UN1"]=3;
-dict["UC2"]=1;
-dict["UO2"]=6;
-dict["UN3"]=3;
-dict["UC4"]=1;
-dict["UO4"]=6;
-dict["UC5"]=1;
-dict["UC7"]=0;
-dict["UC6"]=1;
-dict["UC5M"]=0;
-dict["DG5O5'"]=6;
-dict["DG5C5'"]=0;
-dict["DG5C4'"]=0;
-dict["DG5O4'"]=13;
-dict["DG5C3'"]=0;
-dict["DG5O3'"]=6;
-dict["DG5C2'"]=0;
-dict["DG5C1'"]=0;
-dict["DG5N9"]=3;
-dict["DG5C8"]=1;
-dict["DG5N7"]=4;
-dict["DG5C5"]=1;
-dict["DG5C6"]=1;
-dict["DG5O6"]=6;
-dict["DG5N1"]=4;
-dict["DG5C2"]=1;
-dict["DG5N2"]=3;
-dict["DG5N3"]=4;
-dict["DG5C4"]=1;
-dict["DC5O5'"]=6;
-dict["DC5C5'"]=0;
-dict["DC5C4'"]=0;
-dict["DC5O4'"]=13;
-dict["DC5C3'"]=0;
-dict["DC5O3'"]=6;
-dict["DC5C2'"]=0;
-dict["DC5C1'"]=0;
-dict["DC5N1"]=3;
-dict["DC5C2"]=1;
-dict["DC5O2"]=6;
-dict["DC5N3"]=4;
-dict["DC5C4"]=1;
-dict["DC5N4"]=3;
-dict["DC5C5"]=1;
-dict["DC5C6"]=1;
-dict["DA5O5'"]=6;
-dict["DA5C5'"]=0;
-dict["DA5C4'"]=0;
-dict["DA5O4'"]=13;
-dict["DA5C3'"]=0;
-dict["DA5O3'"]=6;
-dict["DA5C2'"]=0;
-dict["DA5C1'"]=0;
-dict["DA5N9"]=3;
-dict["DA5C8"]=1;
-dict["DA5N7"]=4;
-dict["DA5C5"]=1;
-dict["DA5C6"]=1;
-dict["DA5N6"]=3;
-dict["DA5N1"]=3;
-dict["DA5C2"]=1;
-dict["DA5N3"]=4;
-dict["DA5C4"]=1;
-dict["DT5O5'"]=6;
-dict["DT5C5'"]=0;
-dict["DT5C4'"]=0;
-dict["DT5O4'"]=13;
-dict["DT5C3'"]=0;
-dict["DT5O3'"]=6;
-dict["DT5C2'"]=0;
-dict["DT5C1'"]=0;
-dict["DT5N1"]=3;
-dict["DT5C2"]=1;
-dict["DT5O2"]=6;
-dict["DT5N3"]=3;
-dict["DT5C4"]=1;
-dict["DT5O4"]=6;
-dict["DT5C5"]=1;
-dict["DT5C7"]=0;
-dict["DT5C6"]=1;
+dict[Key_type("UNK","C")]=0;
+dict[Key_type("UNK","O")]=6;
+dict[Key_type("UNK","N")]=3;
+dict[Key_type("UNK","S")]=10;
+dict[Key_type("GLY","C")]=2;
+dict[Key_type("GLY","CA")]=0;
+dict[Key_type("GLY","O")]=7;
+dict[Key_type("GLY","N")]=3;
+dict[Key_type("GLY","OXT")]=6;
+dict[Key_type("GLY","O1")]=6;
+dict[Key_type("GLY","O2")]=6;
+dict[Key_type("ALA","C")]=2;
+dict[Key_type("ALA","CB")]=0;
+dict[Key_type("ALA","CA")]=0;
+dict[Key_type("ALA","O")]=7;
+dict[Key_type("ALA","N")]=3;
+dict[Key_type("ALA","OXT")]=6;
+dict[Key_type("ALA","O1")]=6;
+dict[Key_type("ALA","O2")]=6;
+dict[Key_type("LEU","C")]=2;
+dict[Key_type("LEU","CB")]=0;
+dict[Key_type("LEU","CA")]=0;
+dict[Key_type("LEU","CG")]=0;
+dict[Key_type("LEU","O")]=7;
+dict[Key_type("LEU","N")]=3;
+dict[Key_type("LEU","CD1")]=0;
+dict[Key_type("LEU","CD2")]=0;
+dict[Key_type("LEU","OXT")]=6;
+dict[Key_type("LEU","O1")]=6;
+dict[Key_type("LEU","O2")]=6;
+dict[Key_type("ILE","C")]=2;
+dict[Key_type("ILE","N")]=3;
+dict[Key_type("ILE","CB")]=0;
+dict[Key_type("ILE","CA")]=0;
+dict[Key_type("ILE","O")]=7;
+dict[Key_type("ILE","CD")]=0;
+dict[Key_type("ILE","CD1")]=0;
+dict[Key_type("ILE","CG1")]=0;
+dict[Key_type("ILE","CG2")]=0;
+dict[Key_type("ILE","OXT")]=6;
+dict[Key_type("ILE","O1")]=6;
+dict[Key_type("ILE","O2")]=6;
+dict[Key_type("VAL","C")]=2;
+dict[Key_type("VAL","CB")]=0;
+dict[Key_type("VAL","CA")]=0;
+dict[Key_type("VAL","O")]=7;
+dict[Key_type("VAL","N")]=3;
+dict[Key_type("VAL","CG1")]=0;
+dict[Key_type("VAL","CG2")]=0;
+dict[Key_type("VAL","OXT")]=6;
+dict[Key_type("VAL","O1")]=6;
+dict[Key_type("VAL","O2")]=6;
+dict[Key_type("ASP","C")]=2;
+dict[Key_type("ASP","CB")]=0;
+dict[Key_type("ASP","CA")]=0;
+dict[Key_type("ASP","CG")]=1;
+dict[Key_type("ASP","O")]=7;
+dict[Key_type("ASP","N")]=3;
+dict[Key_type("ASP","OD1")]=8;
+dict[Key_type("ASP","OD2")]=8;
+dict[Key_type("ASP","OXT")]=6;
+dict[Key_type("ASP","O1")]=6;
+dict[Key_type("ASP","O2")]=6;
+dict[Key_type("GLU","C")]=2;
+dict[Key_type("GLU","CB")]=0;
+dict[Key_type("GLU","CA")]=0;
+dict[Key_type("GLU","CG")]=0;
+dict[Key_type("GLU","O")]=7;
+dict[Key_type("GLU","CD")]=1;
+dict[Key_type("GLU","N")]=3;
+dict[Key_type("GLU","OE2")]=8;
+dict[Key_type("GLU","OE1")]=8;
+dict[Key_type("GLU","OXT")]=6;
+dict[Key_type("GLU","O1")]=6;
+dict[Key_type("GLU","O2")]=6;
+dict[Key_type("ASN","C")]=2;
+dict[Key_type("ASN","ND2")]=3;
+dict[Key_type("ASN","CB")]=0;
+dict[Key_type("ASN","CA")]=0;
+dict[Key_type("ASN","CG")]=1;
+dict[Key_type("ASN","O")]=7;
+dict[Key_type("ASN","N")]=3;
+dict[Key_type("ASN","OD1")]=6;
+dict[Key_type("ASN","OXT")]=6;
+dict[Key_type("ASN","O1")]=6;
+dict[Key_type("ASN","O2")]=6;
+dict[Key_type("GLN","C")]=2;
+dict[Key_type("GLN","CB")]=0;
+dict[Key_type("GLN","CA")]=0;
+dict[Key_type("GLN","CG")]=0;
+dict[Key_type("GLN","O")]=7;
+dict[Key_type("GLN","CD")]=1;
+dict[Key_type("GLN","N")]=3;
+dict[Key_type("GLN","NE2")]=3;
+dict[Key_type("GLN","OE1")]=6;
+dict[Key_type("GLN","OXT")]=6;
+dict[Key_type("GLN","O1")]=6;
+dict[Key_type("GLN","O2")]=6;
+dict[Key_type("HIS","C")]=2;
+dict[Key_type("HIS","CD2")]=1;
+dict[Key_type("HIS","CB")]=0;
+dict[Key_type("HIS","CA")]=0;
+dict[Key_type("HIS","CG")]=1;
+dict[Key_type("HIS","O")]=7;
+dict[Key_type("HIS","N")]=3;
+dict[Key_type("HIS","CE1")]=1;
+dict[Key_type("HIS","ND1")]=4;
+dict[Key_type("HIS","NE2")]=4;
+dict[Key_type("HIS","OXT")]=6;
+dict[Key_type("HIS","O1")]=6;
+dict[Key_type("HIS","O2")]=6;
+dict[Key_type("HSE","C")]=2;
+dict[Key_type("HSE","CD2")]=1;
+dict[Key_type("HSE","CB")]=0;
+dict[Key_type("HSE","CA")]=0;
+dict[Key_type("HSE","CG")]=1;
+dict[Key_type("HSE","O")]=7;
+dict[Key_type("HSE","N")]=3;
+dict[Key_type("HSE","CE1")]=1;
+dict[Key_type("HSE","ND1")]=4;
+dict[Key_type("HSE","NE2")]=4;
+dict[Key_type("HSE","OXT")]=6;
+dict[Key_type("HSE","O1")]=6;
+dict[Key_type("HSE","O2")]=6;
+dict[Key_type("SER","C")]=2;
+dict[Key_type("SER","OG")]=6;
+dict[Key_type("SER","CB")]=0;
+dict[Key_type("SER","CA")]=0;
+dict[Key_type("SER","O")]=7;
+dict[Key_type("SER","N")]=3;
+dict[Key_type("SER","OXT")]=6;
+dict[Key_type("SER","O1")]=6;
+dict[Key_type("SER","O2")]=6;
+dict[Key_type("THR","C")]=2;
+dict[Key_type("THR","CB")]=0;
+dict[Key_type("THR","CA")]=0;
+dict[Key_type("THR","OG1")]=6;
+dict[Key_type("THR","O")]=7;
+dict[Key_type("THR","N")]=3;
+dict[Key_type("THR","CG2")]=0;
+dict[Key_type("THR","OXT")]=6;
+dict[Key_type("THR","O1")]=6;
+dict[Key_type("THR","O2")]=6;
+dict[Key_type("CYS","C")]=2;
+dict[Key_type("CYS","CB")]=0;
+dict[Key_type("CYS","CA")]=0;
+dict[Key_type("CYS","O")]=7;
+dict[Key_type("CYS","N")]=3;
+dict[Key_type("CYS","SG")]=10;
+dict[Key_type("CYS","OXT")]=6;
+dict[Key_type("CYS","O1")]=6;
+dict[Key_type("CYS","O2")]=6;
+dict[Key_type("MET","C")]=2;
+dict[Key_type("MET","CB")]=0;
+dict[Key_type("MET","CA")]=0;
+dict[Key_type("MET","CG")]=0;
+dict[Key_type("MET","CE")]=0;
+dict[Key_type("MET","N")]=3;
+dict[Key_type("MET","SD")]=10;
+dict[Key_type("MET","O")]=7;
+dict[Key_type("MET","OXT")]=6;
+dict[Key_type("MET","O1")]=6;
+dict[Key_type("MET","O2")]=6;
+dict[Key_type("MSE","C")]=2;
+dict[Key_type("MSE","CB")]=0;
+dict[Key_type("MSE","CA")]=0;
+dict[Key_type("MSE","CG")]=0;
+dict[Key_type("MSE","CE")]=0;
+dict[Key_type("MSE","N")]=3;
+dict[Key_type("MSE","SD")]=10;
+dict[Key_type("MSE","O")]=7;
+dict[Key_type("MSE","OXT")]=6;
+dict[Key_type("MSE","O1")]=6;
+dict[Key_type("MSE","O2")]=6;
+dict[Key_type("MSE","SE")]=10;
+dict[Key_type("PRO","C")]=2;
+dict[Key_type("PRO","CB")]=0;
+dict[Key_type("PRO","CA")]=0;
+dict[Key_type("PRO","CG")]=0;
+dict[Key_type("PRO","O")]=7;
+dict[Key_type("PRO","CD")]=0;
+dict[Key_type("PRO","N")]=3;
+dict[Key_type("PRO","OXT")]=6;
+dict[Key_type("PRO","O1")]=6;
+dict[Key_type("PRO","O2")]=6;
+dict[Key_type("ARG","NE")]=5;
+dict[Key_type("ARG","C")]=2;
+dict[Key_type("ARG","CB")]=0;
+dict[Key_type("ARG","CA")]=0;
+dict[Key_type("ARG","CG")]=0;
+dict[Key_type("ARG","O")]=7;
+dict[Key_type("ARG","CD")]=0;
+dict[Key_type("ARG","CZ")]=1;
+dict[Key_type("ARG","NH1")]=5;
+dict[Key_type("ARG","NH2")]=5;
+dict[Key_type("ARG","N")]=3;
+dict[Key_type("ARG","OXT")]=6;
+dict[Key_type("ARG","O1")]=6;
+dict[Key_type("ARG","O2")]=6;
+dict[Key_type("LYS","NZ")]=5;
+dict[Key_type("LYS","C")]=2;
+dict[Key_type("LYS","CB")]=0;
+dict[Key_type("LYS","CA")]=0;
+dict[Key_type("LYS","CG")]=0;
+dict[Key_type("LYS","CE")]=0;
+dict[Key_type("LYS","CD")]=0;
+dict[Key_type("LYS","O")]=7;
+dict[Key_type("LYS","N")]=3;
+dict[Key_type("LYS","OXT")]=6;
+dict[Key_type("LYS","O1")]=6;
+dict[Key_type("LYS","O2")]=6;
+dict[Key_type("PHE","C")]=2;
+dict[Key_type("PHE","CD2")]=1;
+dict[Key_type("PHE","CB")]=0;
+dict[Key_type("PHE","CA")]=0;
+dict[Key_type("PHE","CG")]=1;
+dict[Key_type("PHE","O")]=7;
+dict[Key_type("PHE","CZ")]=1;
+dict[Key_type("PHE","N")]=3;
+dict[Key_type("PHE","CD1")]=1;
+dict[Key_type("PHE","CE1")]=1;
+dict[Key_type("PHE","CE2")]=1;
+dict[Key_type("PHE","OXT")]=6;
+dict[Key_type("PHE","O1")]=6;
+dict[Key_type("PHE","O2")]=6;
+dict[Key_type("TYR","C")]=2;
+dict[Key_type("TYR","CD2")]=1;
+dict[Key_type("TYR","OH")]=6;
+dict[Key_type("TYR","N")]=3;
+dict[Key_type("TYR","CB")]=0;
+dict[Key_type("TYR","CA")]=0;
+dict[Key_type("TYR","CG")]=1;
+dict[Key_type("TYR","O")]=7;
+dict[Key_type("TYR","CZ")]=1;
+dict[Key_type("TYR","CD1")]=1;
+dict[Key_type("TYR","CE1")]=1;
+dict[Key_type("TYR","CE2")]=1;
+dict[Key_type("TYR","OXT")]=6;
+dict[Key_type("TYR","O1")]=6;
+dict[Key_type("TYR","O2")]=6;
+dict[Key_type("TRP","CZ2")]=1;
+dict[Key_type("TRP","CZ3")]=1;
+dict[Key_type("TRP","CD1")]=1;
+dict[Key_type("TRP","CD2")]=1;
+dict[Key_type("TRP","CH2")]=1;
+dict[Key_type("TRP","C")]=2;
+dict[Key_type("TRP","CB")]=0;
+dict[Key_type("TRP","CA")]=0;
+dict[Key_type("TRP","CG")]=1;
+dict[Key_type("TRP","O")]=7;
+dict[Key_type("TRP","N")]=3;
+dict[Key_type("TRP","CE3")]=1;
+dict[Key_type("TRP","CE2")]=1;
+dict[Key_type("TRP","NE1")]=4;
+dict[Key_type("TRP","OXT")]=6;
+dict[Key_type("TRP","O1")]=6;
+dict[Key_type("TRP","O2")]=6;
+dict[Key_type("HOH","O")]=9;
+dict[Key_type("HOH","OW")]=9;
+dict[Key_type("SOL","O")]=9;
+dict[Key_type("SOL","OW")]=9;
+dict[Key_type("DG","P")]=11;
+dict[Key_type("DG","OP1")]=12;
+dict[Key_type("DG","OP2")]=12;
+dict[Key_type("DG","OP3")]=12;
+dict[Key_type("DG","O5'")]=6;
+dict[Key_type("DG","C5'")]=0;
+dict[Key_type("DG","C4'")]=0;
+dict[Key_type("DG","O4'")]=13;
+dict[Key_type("DG","C3'")]=0;
+dict[Key_type("DG","O3'")]=6;
+dict[Key_type("DG","C2'")]=0;
+dict[Key_type("DG","C1'")]=0;
+dict[Key_type("DG","N9")]=3;
+dict[Key_type("DG","C8")]=1;
+dict[Key_type("DG","N7")]=4;
+dict[Key_type("DG","C5")]=1;
+dict[Key_type("DG","C6")]=1;
+dict[Key_type("DG","O6")]=6;
+dict[Key_type("DG","N1")]=4;
+dict[Key_type("DG","C2")]=1;
+dict[Key_type("DG","N2")]=3;
+dict[Key_type("DG","N3")]=4;
+dict[Key_type("DG","C4")]=1;
+dict[Key_type("DC","P")]=11;
+dict[Key_type("DC","OP1")]=12;
+dict[Key_type("DC","OP2")]=12;
+dict[Key_type("DC","OP3")]=12;
+dict[Key_type("DC","O5'")]=6;
+dict[Key_type("DC","C5'")]=0;
+dict[Key_type("DC","C4'")]=0;
+dict[Key_type("DC","O4'")]=13;
+dict[Key_type("DC","C3'")]=0;
+dict[Key_type("DC","O3'")]=6;
+dict[Key_type("DC","C2'")]=0;
+dict[Key_type("DC","C1'")]=0;
+dict[Key_type("DC","N1")]=3;
+dict[Key_type("DC","C2")]=1;
+dict[Key_type("DC","O2")]=6;
+dict[Key_type("DC","N3")]=4;
+dict[Key_type("DC","C4")]=1;
+dict[Key_type("DC","N4")]=3;
+dict[Key_type("DC","C5")]=1;
+dict[Key_type("DC","C6")]=1;
+dict[Key_type("DA","P")]=11;
+dict[Key_type("DA","OP1")]=12;
+dict[Key_type("DA","OP2")]=12;
+dict[Key_type("DA","OP3")]=12;
+dict[Key_type("DA","O5'")]=6;
+dict[Key_type("DA","C5'")]=0;
+dict[Key_type("DA","C4'")]=0;
+dict[Key_type("DA","O4'")]=13;
+dict[Key_type("DA","C3'")]=0;
+dict[Key_type("DA","O3'")]=6;
+dict[Key_type("DA","C2'")]=0;
+dict[Key_type("DA","C1'")]=0;
+dict[Key_type("DA","N9")]=3;
+dict[Key_type("DA","C8")]=1;
+dict[Key_type("DA","N7")]=4;
+dict[Key_type("DA","C5")]=1;
+dict[Key_type("DA","C6")]=1;
+dict[Key_type("DA","N6")]=3;
+dict[Key_type("DA","N1")]=3;
+dict[Key_type("DA","C2")]=1;
+dict[Key_type("DA","N3")]=4;
+dict[Key_type("DA","C4")]=1;
+dict[Key_type("DT","P")]=11;
+dict[Key_type("DT","OP1")]=12;
+dict[Key_type("DT","OP2")]=12;
+dict[Key_type("DT","OP3")]=12;
+dict[Key_type("DT","O5'")]=6;
+dict[Key_type("DT","C5'")]=0;
+dict[Key_type("DT","C4'")]=0;
+dict[Key_type("DT","O4'")]=13;
+dict[Key_type("DT","C3'")]=0;
+dict[Key_type("DT","O3'")]=6;
+dict[Key_type("DT","C2'")]=0;
+dict[Key_type("DT","C1'")]=0;
+dict[Key_type("DT","N1")]=3;
+dict[Key_type("DT","C2")]=1;
+dict[Key_type("DT","O2")]=6;
+dict[Key_type("DT","N3")]=3;
+dict[Key_type("DT","C4")]=1;
+dict[Key_type("DT","O4")]=6;
+dict[Key_type("DT","C5")]=1;
+dict[Key_type("DT","C7")]=0;
+dict[Key_type("DT","C6")]=1;
+dict[Key_type("G","P")]=11;
+dict[Key_type("G","OP1")]=12;
+dict[Key_type("G","OP2")]=12;
+dict[Key_type("G","OP3")]=12;
+dict[Key_type("G","O5'")]=6;
+dict[Key_type("G","C5'")]=0;
+dict[Key_type("G","C4'")]=0;
+dict[Key_type("G","O4'")]=13;
+dict[Key_type("G","C3'")]=0;
+dict[Key_type("G","O3'")]=6;
+dict[Key_type("G","C2'")]=0;
+dict[Key_type("G","O2'")]=6;
+dict[Key_type("G","C1'")]=0;
+dict[Key_type("G","N9")]=3;
+dict[Key_type("G","C8")]=1;
+dict[Key_type("G","N7")]=4;
+dict[Key_type("G","C5")]=1;
+dict[Key_type("G","C6")]=1;
+dict[Key_type("G","O6")]=6;
+dict[Key_type("G","N1")]=4;
+dict[Key_type("G","C2")]=1;
+dict[Key_type("G","N2")]=3;
+dict[Key_type("G","N3")]=4;
+dict[Key_type("G","C4")]=1;
+dict[Key_type("G","C10")]=0;
+dict[Key_type("G","C11")]=1;
+dict[Key_type("G","C12")]=1;
+dict[Key_type("G","C13")]=0;
+dict[Key_type("G","C14")]=0;
+dict[Key_type("G","C15")]=0;
+dict[Key_type("G","C16")]=0;
+dict[Key_type("G","C19")]=0;
+dict[Key_type("G","C21")]=0;
+dict[Key_type("G","C24")]=0;
+dict[Key_type("G","C3")]=0;
+dict[Key_type("G","CM1")]=0;
+dict[Key_type("G","CM2")]=0;
+dict[Key_type("G","CM7")]=0;
+dict[Key_type("G","N20")]=3;
+dict[Key_type("G","O17")]=7;
+dict[Key_type("G","O18")]=8;
+dict[Key_type("G","O22")]=7;
+dict[Key_type("G","O23")]=8;
+dict[Key_type("C","P")]=11;
+dict[Key_type("C","OP1")]=12;
+dict[Key_type("C","OP2")]=12;
+dict[Key_type("C","OP3")]=12;
+dict[Key_type("C","O5'")]=6;
+dict[Key_type("C","C5'")]=0;
+dict[Key_type("C","C4'")]=0;
+dict[Key_type("C","O4'")]=13;
+dict[Key_type("C","C3'")]=0;
+dict[Key_type("C","O3'")]=6;
+dict[Key_type("C","C2'")]=0;
+dict[Key_type("C","O2'")]=6;
+dict[Key_type("C","C1'")]=0;
+dict[Key_type("C","N1")]=3;
+dict[Key_type("C","C2")]=1;
+dict[Key_type("C","O2")]=6;
+dict[Key_type("C","N3")]=4;
+dict[Key_type("C","C4")]=1;
+dict[Key_type("C","N4")]=3;
+dict[Key_type("C","C5")]=1;
+dict[Key_type("C","C6")]=1;
+dict[Key_type("C","CM2")]=0;
+dict[Key_type("C","CM5")]=0;
+dict[Key_type("A","P")]=11;
+dict[Key_type("A","OP1")]=12;
+dict[Key_type("A","OP2")]=12;
+dict[Key_type("A","OP3")]=12;
+dict[Key_type("A","O5'")]=6;
+dict[Key_type("A","C5'")]=0;
+dict[Key_type("A","C4'")]=0;
+dict[Key_type("A","O4'")]=13;
+dict[Key_type("A","C3'")]=0;
+dict[Key_type("A","O3'")]=6;
+dict[Key_type("A","C2'")]=0;
+dict[Key_type("A","O2'")]=6;
+dict[Key_type("A","C1'")]=0;
+dict[Key_type("A","N9")]=3;
+dict[Key_type("A","C8")]=1;
+dict[Key_type("A","N7")]=4;
+dict[Key_type("A","C5")]=1;
+dict[Key_type("A","C6")]=1;
+dict[Key_type("A","N6")]=3;
+dict[Key_type("A","N1")]=3;
+dict[Key_type("A","C2")]=1;
+dict[Key_type("A","N3")]=4;
+dict[Key_type("A","C4")]=1;
+dict[Key_type("A","CM1")]=0;
+dict[Key_type("U","P")]=11;
+dict[Key_type("U","OP1")]=12;
+dict[Key_type("U","OP2")]=12;
+dict[Key_type("U","OP3")]=12;
+dict[Key_type("U","O5'")]=6;
+dict[Key_type("U","C5'")]=0;
+dict[Key_type("U","C4'")]=0;
+dict[Key_type("U","O4'")]=13;
+dict[Key_type("U","C3'")]=0;
+dict[Key_type("U","O3'")]=6;
+dict[Key_type("U","C2'")]=0;
+dict[Key_type("U","O2'")]=6;
+dict[Key_type("U","C1'")]=0;
+dict[Key_type("U","N1")]=3;
+dict[Key_type("U","C2")]=1;
+dict[Key_type("U","O2")]=6;
+dict[Key_type("U","N3")]=3;
+dict[Key_type("U","C4")]=1;
+dict[Key_type("U","O4")]=6;
+dict[Key_type("U","C5")]=1;
+dict[Key_type("U","C7")]=0;
+dict[Key_type("U","C6")]=1;
+dict[Key_type("U","C5M")]=0;
+dict[Key_type("DG","5O5'")]=6;
+dict[Key_type("DG","5C5'")]=0;
+dict[Key_type("DG","5C4'")]=0;
+dict[Key_type("DG","5O4'")]=13;
+dict[Key_type("DG","5C3'")]=0;
+dict[Key_type("DG","5O3'")]=6;
+dict[Key_type("DG","5C2'")]=0;
+dict[Key_type("DG","5C1'")]=0;
+dict[Key_type("DG","5N9")]=3;
+dict[Key_type("DG","5C8")]=1;
+dict[Key_type("DG","5N7")]=4;
+dict[Key_type("DG","5C5")]=1;
+dict[Key_type("DG","5C6")]=1;
+dict[Key_type("DG","5O6")]=6;
+dict[Key_type("DG","5N1")]=4;
+dict[Key_type("DG","5C2")]=1;
+dict[Key_type("DG","5N2")]=3;
+dict[Key_type("DG","5N3")]=4;
+dict[Key_type("DG","5C4")]=1;
+dict[Key_type("DC","5O5'")]=6;
+dict[Key_type("DC","5C5'")]=0;
+dict[Key_type("DC","5C4'")]=0;
+dict[Key_type("DC","5O4'")]=13;
+dict[Key_type("DC","5C3'")]=0;
+dict[Key_type("DC","5O3'")]=6;
+dict[Key_type("DC","5C2'")]=0;
+dict[Key_type("DC","5C1'")]=0;
+dict[Key_type("DC","5N1")]=3;
+dict[Key_type("DC","5C2")]=1;
+dict[Key_type("DC","5O2")]=6;
+dict[Key_type("DC","5N3")]=4;
+dict[Key_type("DC","5C4")]=1;
+dict[Key_type("DC","5N4")]=3;
+dict[Key_type("DC","5C5")]=1;
+dict[Key_type("DC","5C6")]=1;
+dict[Key_type("DA","5O5'")]=6;
+dict[Key_type("DA","5C5'")]=0;
+dict[Key_type("DA","5C4'")]=0;
+dict[Key_type("DA","5O4'")]=13;
+dict[Key_type("DA","5C3'")]=0;
+dict[Key_type("DA","5O3'")]=6;
+dict[Key_type("DA","5C2'")]=0;
+dict[Key_type("DA","5C1'")]=0;
+dict[Key_type("DA","5N9")]=3;
+dict[Key_type("DA","5C8")]=1;
+dict[Key_type("DA","5N7")]=4;
+dict[Key_type("DA","5C5")]=1;
+dict[Key_type("DA","5C6")]=1;
+dict[Key_type("DA","5N6")]=3;
+dict[Key_type("DA","5N1")]=3;
+dict[Key_type("DA","5C2")]=1;
+dict[Key_type("DA","5N3")]=4;
+dict[Key_type("DA","5C4")]=1;
+dict[Key_type("DT","5O5'")]=6;
+dict[Key_type("DT","5C5'")]=0;
+dict[Key_type("DT","5C4'")]=0;
+dict[Key_type("DT","5O4'")]=13;
+dict[Key_type("DT","5C3'")]=0;
+dict[Key_type("DT","5O3'")]=6;
+dict[Key_type("DT","5C2'")]=0;
+dict[Key_type("DT","5C1'")]=0;
+dict[Key_type("DT","5N1")]=3;
+dict[Key_type("DT","5C2")]=1;
+dict[Key_type("DT","5O2")]=6;
+dict[Key_type("DT","5N3")]=3;
+dict[Key_type("DT","5C4")]=1;
+dict[Key_type("DT","5O4")]=6;
+dict[Key_type("DT","5C5")]=1;
+dict[Key_type("DT","5C7")]=0;
+dict[Key_type("DT","5C6")]=1;
 
 
 vect.reserve(15);
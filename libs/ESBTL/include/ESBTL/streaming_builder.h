@@ -0,0 +1,173 @@
+// Copyright (c) 2009-2010  INRIA Sophia-Antipolis (France).
+// All rights reserved.
+//
+//This file is part of ESBTL.
+//
+//ESBTL is free software: you can redistribute it and/or modify
+//it under the terms of the GNU General Public License as published by
+//the Free Software Foundation, either version 3 of the License, or
+//(at your option) any later version.
+//
+//ESBTL is distributed in the hope that it will be useful,
+//but WITHOUT ANY WARRANTY; without even the implied warranty of
+//MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//GNU General Public License for more details.
+//
+//You should have received a copy of the GNU General Public License
+//along with ESBTL.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+//Additional permission under GNU GPL version 3 section 7
+//
+//If you modify this Library, or any covered work, by linking or
+//combining it with CGAL (or a modified version of that library), the
+//licensors of this Library grant you additional permission to convey
+//the resulting work. Corresponding Source for a non-source form of
+//such a combination shall include the source code for the parts of CGAL
+//used as well as that of the covered work. 
+//
+//
+//
+// Author(s)     :  Sébastien Loriot
+
+
+#ifndef ESBTL_STREAMING_BUILDER_H
+#define ESBTL_STREAMING_BUILDER_H
+
+#include <vector>
+#include <ESBTL/constants.h>
+#include <ESBTL/name.h>
+#include <ESBTL/line_reader.h>
+
+namespace ESBTL{
+
+/**
+  * Compact record of an atom line given to the visitor of ESBTL::Streaming_builder.
+  * Names are the trimmed fields, stored as ESBTL::Name.
+  */
+struct Streamed_atom{
+  double x;
+  double y;
+  double z;
+  double occupancy;
+  double temperature_factor;
+  int atom_serial_number;
+  int residue_sequence_number;
+  int charge;
+  int model_number;
+  /** The index of the system given by the line selector (starting at 1).*/
+  int system_index;
+  Name atom_name;
+  Name residue_name;
+  Name element;
+  char alternate_location;
+  char chain_identifier;
+  char insertion_code;
+  bool is_hetatm;
+};
+
+/**
+ * Builder giving the atoms read to a visitor instead of building systems.
+ * It can be used in place of ESBTL::All_atom_system_builder with ESBTL::Line_reader, so that line selectors,
+ * occupancy policies and alternate location selection are the same, but no model, chain or residue is created:
+ * the atoms are stored in a batch of ESBTL::Streamed_atom records, given to the visitor each time it is full.
+ * Memory is thus bounded by the size of a batch, whatever the size of the file
+ * (occupancy policies keeping lines until the end of the file, like ESBTL::Max_occupancy_policy, excepted).
+ * 
+ * Atoms are given in file order, and atoms with the same identification are not merged as in a system.
+ * @tparam Visitor is a function object with an operator <TT>void operator()(const std::vector<ESBTL::Streamed_atom>&)</TT>.
+ */
+template <class Visitor>
+class Streaming_builder{
+  Visitor& visitor_;
+  std::vector<Streamed_atom> batch_;
+  std::size_t batch_size_;
+  int current_model;
+  std::size_t nb_atoms_;
+  
+public:
+  /**
+   * Constructor.
+   * @param visitor is called with each batch of atoms.
+   * @param batch_size is the number of atoms in a batch.
+   */
+  Streaming_builder(Visitor& visitor,std::size_t batch_size=4096):
+    visitor_(visitor),batch_size_(batch_size==0?1:batch_size),current_model(1),nb_atoms_(0){
+    batch_.reserve(batch_size_);
+  }
+  
+  /**
+   * Extract information from a line in a PDB file and add an atom to the current batch.
+   * See ESBTL::All_atom_system_builder::interpret_line.
+   */
+  template<class Line_format,class Line>
+  void interpret_line(const Line_format& line_format,const Line& line,int system_info){
+    if (system_info==RMK){
+      if (line_format.record_type()==PDB::MODEL)
+        current_model=line_format.get_model_number(line);
+      return;
+    }
+    
+    batch_.resize(batch_.size()+1);
+    Streamed_atom& atom=batch_.back();
+    atom.x=line_format.get_x(line);
+    atom.y=line_format.get_y(line);
+    atom.z=line_format.get_z(line);
+    atom.occupancy=line_format.get_occupancy(line);
+    atom.temperature_factor=line_format.get_temperature_factor(line);
+    atom.atom_serial_number=line_format.get_atom_serial_number(line);
+    atom.residue_sequence_number=line_format.get_residue_sequence_number(line);
+    atom.charge=line_format.get_charge(line);
+    atom.model_number=current_model;
+    atom.system_index=system_info;
+    atom.atom_name=line_format.get_atom_name(line);
+    atom.residue_name=line_format.get_residue_name(line);
+    atom.element=line_format.get_element(line);
+    atom.alternate_location=line_format.get_alternate_location(line);
+    atom.chain_identifier=line_format.get_chain_identifier(line);
+    atom.insertion_code=line_format.get_insertion_code(line);
+    atom.is_hetatm=line_format.is_hetatm();
+    
+    if (batch_.size()>=batch_size_) flush();
+  }
+  
+  /** Gives the last batch to the visitor (called by the reader at the end of the file).*/
+  void create_systems(char){
+    flush();
+  }
+  
+  /** Gives the current batch to the visitor, if not empty.*/
+  void flush(){
+    if (batch_.empty()) return;
+    visitor_(batch_);
+    nb_atoms_+=batch_.size();
+    batch_.clear();
+  }
+  
+  /** The number of atoms given to the visitor.*/
+  std::size_t number_of_atoms() const {return nb_atoms_;}
+};
+
+/**
+ * Short cut to read a PDB file with a ESBTL::Streaming_builder. See the documentation of ESBTL::Line_reader::read for
+ * the other parameters.
+ * \code
+ * struct Bounding_box{
+ *   double min[3],max[3];
+ *   void operator()(const std::vector<ESBTL::Streamed_atom>& batch){ ... }
+ * };
+ * Bounding_box box;
+ * ESBTL::PDB_line_selector sel;
+ * ESBTL::stream_a_pdb_file<ESBTL::MMAP>(filename,sel,box,ESBTL::Accept_all_occupancy_policy<ESBTL::PDB::Line_format<> >());
+ * \endcode
+ */
+template<Reading_mode mode,class Line_selector,class Visitor,class Occupancy_handler>
+inline
+bool stream_a_pdb_file(const std::string& filename,Line_selector& sel,Visitor& visitor,const Occupancy_handler& occupancy,std::size_t batch_size=4096,char altloc=' '){
+  Streaming_builder<Visitor> builder(visitor,batch_size);
+  return Line_reader<PDB::Line_format<>,Line_selector,Streaming_builder<Visitor> >(sel,builder).template read<mode>(filename,occupancy,altloc);
+}
+
+} //namespace ESBTL
+
+#endif //ESBTL_STREAMING_BUILDER_H
@@ -43,7 +43,10 @@
 
 #include <cstdlib>
 #include <boost/tuple/tuple.hpp>
+#include <algorithm>
 #include <iostream>
+#include <vector>
+#include <utility>
 
 #define CPLUSPLUS
 #include <xdrfile/xdrfile.h>
@@ -63,12 +66,15 @@ namespace ESBTL{
     * at ftp://ftp.gromacs.org/pub/contrib/xdrfile-1.1.tar.gz).
     *
     * Refer to http://www.gromacs.org for more information.
+    * The atoms are found through the index of their model (see ESBTL::Model_index), 
+    * which must have been finalized, as done by ESBTL::read_a_pdb_file.
     * \tparam System is the type of the system used.
     */
   template <class System>
   class System_updater_from_xdrfile{
-    typedef std::map<unsigned,typename System::Atom*> Map_id_to_atom;
-    Map_id_to_atom selected_atoms_;
+    //position of the atom in a frame and the atom, by increasing serial number
+    typedef std::vector<std::pair<unsigned,typename System::Atom*> > Selected_atoms;
+    Selected_atoms selected_atoms_;
     
     XDRFILE* input_file_;
     unsigned first_frame_id_;
@@ -99,13 +105,32 @@ namespace ESBTL{
         exit (EXIT_FAILURE);
       }
       
+      //serial numbers of a frame go from 1 to max_atoms
+      std::vector<bool> is_selected(max_atoms,false);
+      std::vector<typename System::Atom*> atom_of_rank;
       for (System_iterator it_sys=begin;it_sys!=end;++it_sys){
         typename System::Model& model=it_sys->get_model(model_selected_);
-        for (typename System::Model::Atoms_iterator it_atm=model.atoms_begin();it_atm!=model.atoms_end();++it_atm){
-          assert( selected_atoms_.find(it_atm->atom_serial_number())==selected_atoms_.end() );
-          selected_atoms_.insert(std::make_pair(it_atm->atom_serial_number(),&(*it_atm)));
+        atom_of_rank.clear();
+        for (typename System::Model::Atoms_iterator it_atm=model.atoms_begin();it_atm!=model.atoms_end();++it_atm)
+          atom_of_rank.push_back(&(*it_atm));
+        assert(atom_of_rank.size()==model.index().number_of_atoms());
+        std::size_t nb_selected=0;
+        for (unsigned sn=1;sn<=max_atoms;++sn){
+          int rank=model.index().find_atom(sn);
+          if (rank==-1 || is_selected[sn-1]) continue;
+          is_selected[sn-1]=true;
+          selected_atoms_.push_back(std::make_pair(sn-1,atom_of_rank[rank]));
+          ++nb_selected;
+        }
+        //atoms with a serial number out of the frame, or repeated in the model or a previous system, would keep their coordinates
+        if (nb_selected!=atom_of_rank.size()){
+          std::cerr << "Fatal error: only " << nb_selected << " of the " << atom_of_rank.size() << " atoms of model " << model_selected_;
+          std::cerr << " have a serial number from 1 to " << max_atoms << " that no other atom has: frames would update only part of the model.\n";
+          exit(EXIT_FAILURE);
         }
       }
+      //frames are read in order of serial numbers
+      std::sort(selected_atoms_.begin(),selected_atoms_.end());
       
       //check the file contains at least one frame
       int magic=0;
@@ -171,12 +196,12 @@ namespace ESBTL{
       
       //update the coordinates
       if (!is_init)
-        for(typename Map_id_to_atom::iterator it_sel= selected_atoms_.begin(); it_sel!=selected_atoms_.end();++it_sel){
+        for(typename Selected_atoms::iterator it_sel= selected_atoms_.begin(); it_sel!=selected_atoms_.end();++it_sel){
           unsigned i=it_sel->first;
           typename System::Atom::Point_3 new_center(
-            xyz[3*(i-1)]*10, 
-            xyz[3*(i-1)+1]*10,
-            xyz[3*(i-1)+2]*10
+            xyz[3*i]*10, 
+            xyz[3*i+1]*10,
+            xyz[3*i+2]*10
           );//*10 because gromacs is in nanometer
 
           static_cast<typename System::Atom::Point_3&>(*it_sel->second)=new_center;
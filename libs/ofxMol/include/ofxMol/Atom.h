@@ -42,22 +42,36 @@ namespace OfxMol
     class Atom
     {
     public:
+        //! Radius classifier shared by all the atoms, see radius()
+        typedef ESBTL::Generic_classifier<ESBTL::Radius_of_atom<double,ESBTL::Default_system_with_coarse_grain::Residue::Atom> > Radius_classifier;
+        
         Atom() : _atom(ESBTL::Default_system_with_coarse_grain::Atom()),
-            _color(ofColor()), _name(""), _is_backbone(false), _radius(0.0f) {}
+            _color(ofColor()), _chain_identifier(' '), _residue_sequence_number(0), _insertion_code(' '),
+            _is_backbone(false), _property(0) {}
         
-        Atom( ESBTL::Default_system_with_coarse_grain::Atom eatom);
+        Atom(const ESBTL::Default_system_with_coarse_grain::Atom &eatom);
         ~Atom(){}
         
+        //! Set this atom from an ESBTL atom, as the constructor does
+        void set(const ESBTL::Default_system_with_coarse_grain::Atom &eatom);
+        
         //! Logger
         std::string log();
         //! Return a sphere primitive
         ofSpherePrimitive sphere(int resolution = 24);
         //! Return a sphere primitive with given radius
         ofSpherePrimitive sphere(float radius, int resolution = 24);
+        //! Return a sphere primitive with given radius and position
+        static ofSpherePrimitive makeSpherePrimitive(int resolution, float radius, ofVec3f position);
         
         const ofVec3f position() const { return ofVec3f(_atom.x(),_atom.y(),_atom.z()); }
         const double occupancy() const { return _atom.occupancy(); }
-        const std::string residue_name() const { return _atom.residue_name(); }
+        double temperature_factor() const { return _atom.temperature_factor(); }
+        const ESBTL::Name &residue_name() const { return _residue_name; }
+        char chain_identifier() const { return _chain_identifier; }
+        int atom_serial_number() const { return _atom.atom_serial_number(); }
+        int residue_sequence_number() const { return _residue_sequence_number; }
+        char insertion_code() const { return _insertion_code; }
         void setColor(ofFloatColor new_color)
         {
             _color = new_color;
@@ -68,12 +82,12 @@ namespace OfxMol
             return _color;
         }
         
-        std::string name() const
+        const ESBTL::Name &name() const
         {
-            return _name;
+            return _atom.atom_name();
         }
         
-        std::string element() const
+        const ESBTL::Name &element() const
         {
             return _atom.element();
         }
@@ -83,6 +97,17 @@ namespace OfxMol
             return _is_backbone;
         }
         
+        bool is_hetatm() const
+        {
+            return _atom.is_hetatm();
+        }
+        
+        void setPosition(const ofVec3f &position)
+        {
+            static_cast<ESBTL::Default_system_with_coarse_grain::Atom::Point_3&>(_atom) =
+                ESBTL::Default_system_with_coarse_grain::Atom::Point_3(position.x, position.y, position.z);
+        }
+        
         /*
          * Function filling default radius of atoms. Current implementation uses radii
          * from Tsai J, Taylor R, Chothia C, Gerstein M. J Mol Biol. 1999 Jul 2;290(1):253-66.
@@ -91,18 +116,30 @@ namespace OfxMol
          */
         double radius() const
         {
-            return _radius;
+            return Radius_classifier::shared().get_properties(_property).value();
         }
         
     protected:
         ESBTL::Default_system_with_coarse_grain::Atom _atom;
-        ESBTL::Generic_classifier<ESBTL::Radius_of_atom<double,ESBTL::Default_system_with_coarse_grain::Residue::Atom> > radius_classifier;
         ofFloatColor _color;
-        std::string _name;
+        //! Copied from the residue and the chain, that do not outlive the ESBTL system
+        ESBTL::Name _residue_name;
+        char _chain_identifier;
+        int _residue_sequence_number;
+        char _insertion_code;
         bool _is_backbone;
-        double _radius;
-        ofSpherePrimitive makeSpherePrimitive(int resolution, float radius, ofVec3f position);
+        //! Index of the radius in Radius_classifier::shared()
+        unsigned char _property;
+        
+        friend class Cache;
     };
+    
+    //! Global access functions, so that the ESBTL predicates (ESBTL::is_water...) accept an OfxMol::Atom
+    inline const ESBTL::Name &get_atom_name(const Atom &atom) { return atom.name(); }
+    inline const ESBTL::Name &get_residue_name(const Atom &atom) { return atom.residue_name(); }
+    inline const ESBTL::Name &get_element(const Atom &atom) { return atom.element(); }
+    inline bool get_is_hetatm(const Atom &atom) { return atom.is_hetatm(); }
+    inline char get_chain_identifier(const Atom &atom) { return atom.chain_identifier(); }
 }
 
 
@@ -0,0 +1,79 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol/Atom.h"
+
+namespace OfxMol
+{
+    //! Structure of arrays view on the atoms of a Model: one contiguous array per attribute,
+    //! in the order of the atoms, to be read by vectorized code or uploaded to the GPU as is.
+    class AtomArrays
+    {
+    public:
+        //! Bits of flags
+        enum Flag
+        {
+            BACKBONE = 1,
+            HETATM = 2,
+            WATER = 4,
+            HYDROGEN = 8
+        };
+        
+        //! Append the attributes of an atom
+        void push_back(const Atom &atom);
+        void reserve(size_t n);
+        void clear();
+        size_t size() const { return x.size(); }
+        
+        ofVec3f position(size_t i) const { return ofVec3f(x[i], y[i], z[i]); }
+        void setPosition(size_t i, const ofVec3f &position);
+        
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+        std::vector<float> radius;
+        std::vector<ofFloatColor> color;
+        //! ESBTL::Name::id() of the element
+        std::vector<uint32_t> element;
+        //! ESBTL::Name::id() of the residue name
+        std::vector<uint32_t> residue;
+        std::vector<char> chain;
+        //! Temperature factor (B-factor)
+        std::vector<float> bfactor;
+        //! Combination of Flag
+        std::vector<unsigned char> flags;
+    };
+}
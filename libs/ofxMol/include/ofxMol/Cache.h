@@ -0,0 +1,88 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofxMol/System.h"
+
+namespace OfxMol
+{
+    // Binary cache of the models of a System (.ofxmol files).
+    //
+    // All values are stored little-endian with fixed-size records, so a cache file
+    // can be mapped in memory and read on any platform:
+    //
+    //  header:       magic "OFXMOLC\0", version, setup mode, atom record size,
+    //                coarse atom record size, number of models, number of water models,
+    //                file size (u64), FNV-1a checksum of the records (u64),
+    //                size (u64) and modification time (i64 seconds, u32 nanoseconds, reserved u32)
+    //                of the PDB file
+    //  each model:   model number, number of atoms, number of coarse atoms, reserved,
+    //                followed by the atom records and the coarse atom records
+    //                (models first, then water models)
+    //
+    // A cache is rejected if any of these values does not match the file, or if the size or the
+    // modification time of the PDB file changed since the cache was written (an older file copied
+    // over it is rejected too).
+    class Cache
+    {
+    public:
+        //! Format version, bump it when the layout of records changes.
+        static const unsigned int VERSION = 6;
+        
+        //! Size and modification time of a PDB file, as recorded in its cache
+        struct Source
+        {
+            uint64_t size;
+            int64_t mtime;
+            uint32_t mtime_nsec; // 0 where the file system has no sub-second times
+        };
+        
+        //! Size and modification time of the PDB file at path, false if it does not exist
+        static bool stat(const std::string &pdbPath, Source &source);
+        
+        //! Cache file of a PDB file for a setup mode
+        static std::string path(const std::string &pdbPath, SetupMode mode);
+        
+        //! True if the cache file exists and was written from the PDB file as it is now
+        static bool isFresh(const std::string &cachePath, const std::string &pdbPath);
+        
+        //! Write models and water models to a cache file, source being the PDB file before it was parsed
+        static bool write(const std::string &cachePath, const Source &source, SetupMode mode,
+                          const std::vector<OfxMol::Model> &models, const std::vector<OfxMol::Model> &water_models);
+        
+        //! Read models and water models from a cache file. Output vectors are left empty on failure.
+        static bool read(const std::string &cachePath, SetupMode mode,
+                         std::vector<OfxMol::Model> &models, std::vector<OfxMol::Model> &water_models);
+    };
+}
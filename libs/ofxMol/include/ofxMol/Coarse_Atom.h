@@ -42,12 +42,24 @@ namespace OfxMol
     class Coarse_Atom
     {
     public:
-        Coarse_Atom() : _atom(ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom()) {}
-        Coarse_Atom(ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom eatom);
+        //! Radius classifier shared by all the coarse atoms, see radius()
+        typedef ESBTL::Generic_classifier<ESBTL::Radius_of_coarse_atom<double,ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom> > Radius_classifier;
+        
+        Coarse_Atom() : _atom(ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom()), _property(0), _is_backbone(false) {}
+        Coarse_Atom(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom);
         ~Coarse_Atom() {}
         
+        //! Set this coarse atom from an ESBTL coarse atom, as the constructor does
+        void set(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom);
+        
         const ofVec3f position() const { return ofVec3f(_atom.x(),_atom.y(),_atom.z()); }
         
+        void setPosition(const ofVec3f &position)
+        {
+            static_cast<ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom::Point_3&>(_atom) =
+                ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom::Point_3(position.x, position.y, position.z);
+        }
+        
         ofFloatColor getColor() const
         {
             return color;
@@ -55,7 +67,7 @@ namespace OfxMol
         
         float radius() const
         {
-            return _radius;
+            return Radius_classifier::shared().get_properties(_property).value();
         }
         
         bool is_backbone()
@@ -69,8 +81,10 @@ namespace OfxMol
     protected:
         ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom _atom;
         ofFloatColor color;
-        ESBTL::Generic_classifier<ESBTL::Radius_of_coarse_atom<double,ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom> > radius_classifier;
-        float _radius;
+        //! Index of the radius in Radius_classifier::shared()
+        unsigned char _property;
         bool _is_backbone;
+        
+        friend class Cache;
     };
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofxMol/Model.h"
+#include <ESBTL/internal/perfect_hash_table.h>
+
+namespace OfxMol
+{
+    //! Colors of the atoms of a Model, looked up in numeric tables from the residue, element,
+    //! chain or B-factor of each atom, in a single pass over model.arrays().
+    //! Applying a scheme only writes model.arrays().color: the model is not rebuilt, and getAtom,
+    //! atomsPointCloud and the other generators use the new colors.
+    class ColorScheme
+    {
+    public:
+        enum Type
+        {
+            RESIDUE, // residue classes (the colors of the atoms after setup)
+            ELEMENT, // CPK colors
+            CHAIN,   // a palette cycling over the chain identifiers
+            BFACTOR, // blue-white-red gradient of the temperature factor
+            UNIFORM  // the default color
+        };
+        
+        ColorScheme(Type type = RESIDUE);
+        
+        Type getType() const { return type; }
+        std::string getName() const;
+        
+        //! Color all the atoms of model
+        void apply(Model &model) const;
+        
+        //! User palettes, the default color is used for residues, elements and chains without color
+        void setDefaultColor(const ofFloatColor &color);
+        void setResidueColor(const ESBTL::Name &residue, const ofFloatColor &color);
+        void setElementColor(const ESBTL::Name &element, const ofFloatColor &color);
+        void setChainColor(char chain, const ofFloatColor &color);
+        //! Colors of the chains A, B... Z, a... z, 0... 9, cycling over palette (resets setChainColor)
+        void setChainPalette(const std::vector<ofFloatColor> &palette);
+        //! B-factor gradient: low at min, mid halfway and high at max.
+        //! If min >= max (the default), the range is the one of each model colored.
+        void setBFactorColors(const ofFloatColor &low, const ofFloatColor &mid, const ofFloatColor &high);
+        void setBFactorRange(float min, float max);
+        
+    private:
+        //! Colors by ESBTL::Name::id(), searched in a perfect hash table
+        class NameColors
+        {
+        public:
+            void set(uint32_t id, const ofFloatColor &color);
+            void apply(const uint32_t *ids, size_t n, const ofFloatColor &defaultColor, ofFloatColor *colors) const;
+            
+        private:
+            std::map<uint32_t, ofFloatColor> byId;
+            std::vector<ofFloatColor> values;
+            ESBTL::internal::Perfect_hash_table index;
+        };
+        
+        void applyBFactor(const float *bfactor, size_t n, ofFloatColor *colors) const;
+        
+        //! Number of colors of the B-factor gradient
+        static const size_t GRADIENT_SIZE = 256;
+        
+        Type type;
+        ofFloatColor defaultColor;
+        NameColors residueColors;
+        NameColors elementColors;
+        ofFloatColor chainColors[256];
+        std::vector<ofFloatColor> gradient;
+        float bfactorMin;
+        float bfactorMax;
+    };
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <deque>
+
+#include "ofMain.h"
+#include "Poco/Condition.h"
+#include "ofxMol/System.h"
+
+namespace OfxMol
+{
+    // Models of a PDB file parsed on demand.
+    //
+    // setup only indexes the byte range of each MODEL record of the file (memory-mapped).
+    // getModel parses a model the first time it is needed and keeps it in a LRU cache limited
+    // to a number of bytes. prefetch parses a model in a background thread, so that a later
+    // getModel does not wait (for example the next model during a playback).
+    class LazyModels : public ofThread
+    {
+    public:
+        LazyModels();
+        ~LazyModels();
+        
+        //! Index the models of a PDB file. Returns false if the file can not be read.
+        bool setup(const std::string &path, SetupMode mode, size_t cacheBytes);
+        
+        unsigned int number_of_models() const
+        {
+            return ranges.size();
+        }
+        
+        //! Model i (models of the first system in ADVANCED mode).
+        //! The reference is valid until the model is evicted from the cache: the last model
+        //! returned by getModel or getWaterModel is never evicted.
+        Model &getModel(unsigned int i);
+        
+        //! Water atoms of the MODEL record i (ADVANCED mode), empty if there are none
+        Model &getWaterModel(unsigned int i);
+        
+        unsigned int number_of_water_models() const
+        {
+            return mode == ADVANCED ? ranges.size() : 0;
+        }
+        
+        //! Parse model i in the background thread if it is not in the cache
+        void prefetch(unsigned int i);
+        
+        //! Memory budget of the cache (approximate size of the models)
+        void setCacheBytes(size_t bytes);
+        size_t getCacheBytes() const
+        {
+            return cacheBytes;
+        }
+        
+        //! Approximate size of the models in the cache
+        size_t getUsedBytes();
+        
+    protected:
+        struct Range
+        {
+            size_t begin;
+            size_t end;
+        };
+        
+        struct Entry
+        {
+            unsigned int index;
+            Model *model;
+            Model *water;
+            size_t bytes;
+        };
+        
+        void threadedFunction();
+        //! stop the thread once it has parsed the model in progress
+        void stop();
+        
+        //! parse a range of the file, without lock
+        void parse(unsigned int i, Entry &entry);
+        //! cache entry of model i, parsed if needed
+        Entry &get(unsigned int i);
+        //! insert a parsed entry (lock held)
+        void insert(Entry &entry);
+        //! evict least recently used entries above the budget (lock held)
+        void evict();
+        void clear();
+        
+        std::string path;
+        SetupMode mode;
+        char altloc;
+        ESBTL::internal::Mapped_file file;
+        std::vector<Range> ranges;
+        
+        size_t cacheBytes;
+        size_t usedBytes;
+        std::list<Entry> entries; // most recently used first
+        std::map<unsigned int, std::list<Entry>::iterator> cache;
+        
+        std::deque<unsigned int> requests;
+        int loading; // model parsed by the thread, or -1
+        int pinned; // last model returned, or -1
+        Poco::Condition requested; // signalled by prefetch and stop
+        Poco::Condition loaded; // broadcast when the thread has inserted a model
+    };
+}
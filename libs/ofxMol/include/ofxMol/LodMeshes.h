@@ -0,0 +1,157 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol/Model.h"
+
+namespace OfxMol
+{
+    // Sphere meshes of the atoms of a Model with a level of detail chosen for each region from the camera.
+    //
+    // The atoms are bucketed in cubic tiles. Each update(), the size on screen of the atoms of each tile
+    // (from its distance to the camera) chooses one of several sphere resolutions, the finest level whose
+    // minimum size in pixels is reached. Tiles smaller than all the levels are drawn far: as points or as
+    // the coarse atoms of the tile. With a triangle budget, the minimum sizes of all the levels are scaled
+    // up until the triangles (far coarse atoms included) fit, so that near tiles stay finer than far ones.
+    // The mesh of a level is built again only when tiles enter or leave it.
+    //
+    // The Model must outlive the meshes. Call setup() again after the atoms have moved.
+    class LodMeshes
+    {
+    public:
+        //! How tiles past the last level are drawn
+        enum Far
+        {
+            POINTS,
+            COARSE_ATOMS
+        };
+        
+        //! Levels at resolutions 24, 12 and 6 from 16, 6 and 2 pixels of atom radius, far tiles as points
+        LodMeshes();
+        
+        //! Bucket the atoms (and coarse atoms) of model in tiles of tile_size, which must be positive
+        void setup(Model *model, float tile_size = 10.0f);
+        
+        //! Remove the levels, to add others
+        void clearLevels();
+        //! Level of spheres of a resolution, for the atoms of a radius of at least min_pixels on screen.
+        //! Levels are kept by decreasing min_pixels, whatever the order they are added in.
+        void addLevel(int resolution, float min_pixels);
+        size_t getNumLevels() const { return levels.size(); }
+        int getResolution(size_t level) const { return levels[level].resolution; }
+        
+        //! Far tiles: POINTS, or COARSE_ATOMS (spheres at the coarsest resolution, or points without coarse atoms)
+        void setFar(Far far);
+        
+        //! Largest number of triangles of the meshes, 0 for no limit. Far points have no triangles, far coarse
+        //! atoms count: if they exceed the budget when all the tiles are far, all the tiles are drawn far.
+        void setTriangleBudget(size_t triangles) { budget = triangles; }
+        
+        //! Choose the level of the tiles for a camera at eye with a vertical field of view of fov degrees,
+        //! and build the meshes of the levels that changed. Returns true if a mesh changed.
+        bool update(const ofVec3f &eye, float fov, float viewport_height);
+        bool update(const ofCamera &camera, float viewport_height = ofGetViewportHeight());
+        
+        //! Spheres of level (with colors and indices): draw them all, with the far mesh
+        const ofMesh &getMesh(size_t level) const { return levels[level].mesh; }
+        //! Points (OF_PRIMITIVE_POINTS) or coarse atom spheres of the far tiles
+        const ofMesh &getFarMesh() const { return far_mesh; }
+        void draw();
+        
+        //! Counters of the last update: triangles, spheres and tiles of each level
+        size_t getTriangles(size_t level) const { return levels[level].triangles; }
+        size_t getSpheres(size_t level) const { return levels[level].spheres; }
+        size_t getTiles(size_t level) const { return levels[level].tiles; }
+        //! Triangles of the far mesh (0 for points), and its points or coarse atoms
+        size_t getFarTriangles() const { return far_triangles; }
+        size_t getFarElements() const { return far_elements; }
+        size_t getFarTiles() const { return far_tiles; }
+        size_t getTotalTriangles() const;
+        size_t getNumTiles() const { return tiles.size(); }
+        
+    protected:
+        struct Level
+        {
+            int resolution;
+            float min_pixels;
+            size_t triangles_per_sphere;
+            ofMesh mesh;
+            bool changed;
+            size_t triangles;
+            size_t spheres;
+            size_t tiles;
+        };
+        
+        struct Tile
+        {
+            ofVec3f min;
+            ofVec3f max;
+            float radius; // largest radius of the atoms
+            // atoms and coarse atoms of the tile are ranges of tile_atoms and tile_coarse_atoms
+            size_t first_atom;
+            size_t number_of_atoms;
+            size_t first_coarse_atom;
+            size_t number_of_coarse_atoms;
+            size_t level; // levels.size() when far
+            float pixels; // radius on screen
+        };
+        
+        //! Level of a tile from its radius on screen, levels.size() for far tiles
+        size_t chooseLevel(float pixels) const;
+        //! Level of the tiles with the minimum sizes of the levels scaled by factor, returns their triangles
+        size_t chooseLevels(float factor);
+        //! Scale the minimum sizes until the triangles of the levels fit the budget
+        void applyBudget();
+        void buildLevel(size_t level);
+        void buildFar();
+        //! Resolution of the coarse atoms of far tiles: the one of the last level
+        int farResolution() const;
+        
+        Model *model;
+        std::vector<Level> levels;
+        Far far;
+        size_t budget;
+        
+        std::vector<Tile> tiles;
+        std::vector<unsigned int> tile_atoms;
+        std::vector<unsigned int> tile_coarse_atoms;
+        
+        ofMesh far_mesh;
+        bool far_changed;
+        size_t far_triangles;
+        size_t far_elements;
+        size_t far_tiles;
+    };
+}
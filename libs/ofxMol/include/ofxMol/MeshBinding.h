@@ -0,0 +1,110 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol/MeshTask.h"
+#include "ofxMol/MeshBuilder.h"
+#include "ofxMol/SphereInstances.h"
+
+namespace OfxMol
+{
+    class Model;
+    
+    //! A mesh of a Model that follows its atoms (see the Model::*MeshBinding generators).
+    //!
+    //! The mesh is the one of the generator of the same type (MeshTask::Type). Its spheres have a fixed number of
+    //! vertices, so the binding knows the vertices of each atom or coarse atom: after the atoms move
+    //! (Model::setAtomPosition, Model::setCoarseAtomPosition, or arrays()), update() rewrites in place the vertices
+    //! of the spheres that moved, by the threads of a MeshBuilder. Nothing is tessellated nor allocated, and the
+    //! mesh is the same as a new one from the generator.
+    //!
+    //! The Model must outlive the binding. Colors, radii and the number of atoms are those of the binding time:
+    //! if the number of atoms changes, update() builds the mesh again.
+    class MeshBinding
+    {
+    public:
+        MeshBinding(Model *model, MeshTask::Type type, int resolution = 16, float radius = 1.0f, ofColor color = ofColor(255, 255, 255), bool indexed = false);
+        
+        //! The bound mesh. Draw it or upload it, but do not change its number of vertices.
+        ofMesh &getMesh()
+        {
+            return mesh;
+        }
+        
+        const ofMesh &getMesh() const
+        {
+            return mesh;
+        }
+        
+        //! Rewrite the vertices of the spheres (or points) whose atom moved since the last update.
+        //! Returns the number of spheres rewritten.
+        size_t update(const MeshBuilder &builder = MeshBuilder::shared());
+        
+        //! Same as update() for the spheres of atoms first to first+count-1 only (a residue, a selection...)
+        size_t update(size_t first, size_t count, const MeshBuilder &builder = MeshBuilder::shared());
+        
+        //! Number of spheres: atoms or coarse atoms of the model
+        size_t getNumSpheres() const
+        {
+            return spheres.size();
+        }
+        
+        //! Number of vertices of each sphere (1 for a point cloud): the vertices of sphere i are the vertices
+        //! i * getVerticesPerSphere() to (i + 1) * getVerticesPerSphere() - 1 of the mesh
+        size_t getVerticesPerSphere() const
+        {
+            return unit != NULL ? unit->size() : 1;
+        }
+        
+    protected:
+        class UpdateJob;
+        
+        //! Build the mesh and remember the spheres
+        void bind();
+        
+        Model *model;
+        MeshTask::Type type;
+        int resolution;
+        float radius;
+        ofColor color;
+        bool indexed;
+        
+        //! Spheres as written in the mesh
+        std::vector<SphereInstance> spheres;
+        //! Vertices of the unit sphere, as copied for each sphere (NULL for a point cloud)
+        const std::vector<ofVec3f> *unit;
+        ofMesh mesh;
+    };
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+
+namespace OfxMol
+{
+    //! Runs the generation of a mesh in parallel.
+    //!
+    //! Generators first compute the exact size of the mesh and size its arrays once, then a Job fills
+    //! the part of the arrays of each slice of consecutive atoms. Slices do not depend on the number of threads
+    //! for the output: the mesh is the same with one thread or many.
+    //!
+    //! A builder keeps threads-1 worker threads, started by the first run() with several slices, which wait
+    //! for slices between runs. A builder can be used by several threads at once (MeshTask threads use shared()):
+    //! each run() queues its slices for the workers and runs the ones they have not taken yet.
+    class MeshBuilder
+    {
+    public:
+        //! Work on consecutive items, run by slices
+        class Job
+        {
+        public:
+            virtual ~Job() {}
+            //! Process items begin to end-1, which make the slice-th slice
+            virtual void run(size_t slice, size_t begin, size_t end) = 0;
+        };
+        
+        //! Arrays of a mesh, written by the jobs (NULL when absent). Get them once from the calling thread:
+        //! the accessors of ofMesh mark the mesh as modified.
+        struct Arrays
+        {
+            ofVec3f *vertices;
+            ofVec3f *normals;
+            ofFloatColor *colors;
+            ofIndexType *indices;
+        };
+        
+        //! Clear mesh and size its arrays: nb_vertices vertices, with normals and colors if asked, and nb_indices indices
+        static Arrays resize(ofMesh &mesh, size_t nb_vertices, bool with_normals, bool with_colors, size_t nb_indices = 0);
+        
+        //! Builder using threads threads, or one per processor if threads is 0
+        MeshBuilder(unsigned int threads = 0);
+        
+        //! Stops the workers, once the runs in progress are done
+        void setNumThreads(unsigned int threads);
+        unsigned int getNumThreads() const
+        {
+            return threads;
+        }
+        
+        //! Number of slices of run(job, n, min_slice): one per thread, with at least min_slice items each
+        size_t numSlices(size_t n, size_t min_slice = 1) const;
+        
+        //! Run job on items 0 to n-1 split in numSlices(n, min_slice) slices of the same size, one per thread
+        //! (the calling thread runs the first one and helps the workers). Returns once all the slices are done.
+        void run(Job &job, size_t n, size_t min_slice = 1) const;
+        
+        //! Number of processors
+        static unsigned int hardwareThreads();
+        
+        //! Builder used by the generators of Model, one thread per processor.
+        //! Call setNumThreads on it before generating meshes.
+        static MeshBuilder &shared();
+        
+    protected:
+        class Workers;
+        
+        unsigned int threads;
+        ofPtr<Workers> workers;
+    };
+}
@@ -0,0 +1,80 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+
+namespace OfxMol
+{
+    class Model;
+    
+    // Mesh generation of a Model in a thread (see the Model::*Async generators).
+    //
+    // The Model must outlive the task. Poll isDone() from ofApp::update, then publish() the mesh.
+    // A mesh generation can not be cancelled: destroying the task waits for the mesh.
+    class MeshTask : public ofThread
+    {
+    public:
+        enum Type
+        {
+            ATOMS,
+            ATOMS_WITH_RADIUS,
+            COARSE_ATOMS,
+            COARSE_ATOMS_WITH_COLOR,
+            POINT_CLOUD
+        };
+        
+        MeshTask(Model *model, Type type, int resolution = 16, float radius = 1.0f, ofColor color = ofColor(255, 255, 255), bool indexed = false);
+        ~MeshTask();
+        
+        bool isDone();
+        
+        //! Move the generated mesh to mesh, its arrays are swapped and not copied.
+        //! Returns false (and does nothing) if the task is not done or its mesh was already published.
+        bool publish(ofMesh &mesh);
+        
+    protected:
+        void threadedFunction();
+        
+        Model *model;
+        Type type;
+        int resolution;
+        float radius;
+        ofColor color;
+        bool indexed;
+        ofMesh mesh;
+        bool done;
+        bool published;
+    };
+}
@@ -33,7 +33,11 @@
 #pragma once
 
 #include "ofxMol/Atom.h"
+#include "ofxMol/AtomArrays.h"
 #include "ofxMol/Coarse_Atom.h"
+#include "ofxMol/MeshTask.h"
+#include "ofxMol/MeshBinding.h"
+#include "ofxMol/SphereInstances.h"
 
 namespace OfxMol
 {
@@ -43,16 +47,29 @@ namespace OfxMol
         
         Model();
         Model(int nm);
+        //! Copy the atoms of an ESBTL model, creating its coarse atoms if with_coarse_atoms
+        Model(ESBTL::Default_system_with_coarse_grain::Model &model, bool with_coarse_atoms = true);
         ~Model();
         
+        //! Same as the constructor from an ESBTL model, for a model already in a container
+        //! (atoms are added to this model, sized once from the ESBTL model)
+        void build(ESBTL::Default_system_with_coarse_grain::Model &model, bool with_coarse_atoms = true);
+        
         inline const int model_number(){ return _model_number; }
         
+        //! Reserve memory for the atoms and coarse atoms to be added
+        void reserve(size_t nb_atoms, size_t nb_coarse_atoms = 0);
+        
         //! Add atoms
-        void add_atom(OfxMol::Atom &atom);
+        void add_atom(const OfxMol::Atom &atom);
         inline const int number_of_atoms() { return atoms.size(); }
-        void add_coarse_atom(OfxMol::Coarse_Atom &atom);
+        void add_coarse_atom(const OfxMol::Coarse_Atom &atom);
         inline const int number_of_coarse_atoms() { return coarse_atoms.size(); }
         
+        //! Add atoms constructed in place from ESBTL atoms (no temporary Atom is copied)
+        OfxMol::Atom &emplace_atom(const ESBTL::Default_system_with_coarse_grain::Atom &eatom);
+        OfxMol::Coarse_Atom &emplace_coarse_atom(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom);
+        
         //! Logger
         std::string log();
         
@@ -80,11 +97,53 @@ namespace OfxMol
             return atoms.end();
         }
         
+        //! Atom i, with the position and color of arrays()
         Atom getAtom(unsigned int i)
         {
-            return atoms[i];
+            Atom atom = atoms[i];
+            atom.setPosition(atom_arrays.position(i));
+            atom.setColor(atom_arrays.color[i]);
+            return atom;
+        }
+        
+        //! Structure of arrays view on the atoms, built with the model.
+        //! Positions and colors written in the arrays are the ones used by getAtom and the generators.
+        inline const AtomArrays &arrays() const
+        {
+            return atom_arrays;
         }
         
+        inline AtomArrays &arrays()
+        {
+            return atom_arrays;
+        }
+        
+        //! Move or color atom i, in the atoms and in arrays()
+        void setAtomPosition(unsigned int i, const ofVec3f &position);
+        void setAtomColor(unsigned int i, const ofFloatColor &color);
+        
+        //! Rebuild arrays() from the atoms, after they have been modified through atoms_begin()
+        void updateArrays();
+        
+        //! Index of the atoms by serial number and of the residues by chain, sequence number and insertion code,
+        //! ranks being positions in the atoms (see ESBTL::Model_index). build() copies the index of the ESBTL model.
+        inline const ESBTL::Model_index &index() const
+        {
+            return atom_index;
+        }
+        
+        //! Rebuild index() from the atoms, after atoms have been added with add_atom or emplace_atom
+        void updateIndex();
+        
+        //! Position of the atom with serial number serial, -1 if there is none (constant time)
+        inline int findAtom(unsigned int serial) const
+        {
+            return atom_index.find_atom(serial);
+        }
+        
+        //! Positions first to first+count-1 of the atoms of a residue, false if there is none (constant time)
+        bool findResidueAtoms(char chain, int resSeq, char iCode, unsigned int &first, unsigned int &count) const;
+        
         //! iterators for coarse atoms
         typedef std::vector<OfxMol::Coarse_Atom>::const_iterator Const_coarse_atoms_iterator;
         typedef std::vector<OfxMol::Coarse_Atom>::iterator Coarse_atoms_iterator;
@@ -114,22 +173,56 @@ namespace OfxMol
             return coarse_atoms[i];
         }
         
+        //! Move coarse atom i
+        void setCoarseAtomPosition(unsigned int i, const ofVec3f &position)
+        {
+            coarse_atoms[i].setPosition(position);
+        }
+        
         //! generators
         ofMesh atomsPointCloud();
-        ofMesh atomsMesh(int resolution = 16);
-        ofMesh atomsMesh(float radius, int resolution = 16);
-        ofMesh coarseAtomsMesh(ofColor color, int resolution = 16);
-        ofMesh coarseAtomsMesh(int resolution = 16);
+        //! Point cloud of the first model of a PDB file, read without building models (any file size).
+        //! Atoms are those of System::setup in SIMPLE mode, or in ADVANCED mode if advanced, in file order.
+        static ofMesh atomsPointCloud(const std::string &path, bool advanced = false);
+        //! Sphere meshes: with indexed, each sphere stores its vertices once and the triangles are in the indices of
+        //! the mesh (several times less vertices, see SphereInstances::expandIndexed for 16 bits indices)
+        ofMesh atomsMesh(int resolution = 16, bool indexed = false);
+        ofMesh atomsMesh(float radius, int resolution = 16, bool indexed = false);
+        ofMesh coarseAtomsMesh(ofColor color, int resolution = 16, bool indexed = false);
+        ofMesh coarseAtomsMesh(int resolution = 16, bool indexed = false);
         ofPolyline backbonePoly();
         
+        //! Spheres of the atoms (or coarse atoms) as instances of one unit sphere per resolution (see SphereInstances.h):
+        //! a few bytes per atom to draw with instancing. The meshes above are their expand().
+        SphereInstances atomsInstances(int resolution = 16);
+        SphereInstances atomsInstances(float radius, int resolution = 16);
+        SphereInstances coarseAtomsInstances(ofColor color, int resolution = 16);
+        SphereInstances coarseAtomsInstances(int resolution = 16);
+        
+        //! generators in a thread (see MeshTask.h), the model must outlive the task
+        ofPtr<MeshTask> atomsPointCloudAsync();
+        ofPtr<MeshTask> atomsMeshAsync(int resolution = 16, bool indexed = false);
+        ofPtr<MeshTask> atomsMeshAsync(float radius, int resolution = 16, bool indexed = false);
+        ofPtr<MeshTask> coarseAtomsMeshAsync(ofColor color, int resolution = 16, bool indexed = false);
+        ofPtr<MeshTask> coarseAtomsMeshAsync(int resolution = 16, bool indexed = false);
+        
+        //! generators of meshes following the atoms (see MeshBinding.h): call update() on the binding after moving
+        //! atoms to rewrite their vertices in place. The model must outlive the binding.
+        ofPtr<MeshBinding> atomsPointCloudBinding();
+        ofPtr<MeshBinding> atomsMeshBinding(int resolution = 16, bool indexed = false);
+        ofPtr<MeshBinding> atomsMeshBinding(float radius, int resolution = 16, bool indexed = false);
+        ofPtr<MeshBinding> coarseAtomsMeshBinding(ofColor color, int resolution = 16, bool indexed = false);
+        ofPtr<MeshBinding> coarseAtomsMeshBinding(int resolution = 16, bool indexed = false);
+        
         
     protected:
         int _model_number;
         std::vector<OfxMol::Atom> atoms; // atoms
+        AtomArrays atom_arrays; // same atoms, one array per attribute
+        ESBTL::Model_index atom_index; // atoms by serial number, residues by key
         std::vector<OfxMol::Coarse_Atom> coarse_atoms; // coarse atoms
-        void updateMesh(ofMesh& mesh, const vector<ofMeshFace> &triangles, const ofVec3f position, const ofColor color);
         
-         void updateMesh(ofMesh& mesh, const vector<ofMeshFace> &triangles, const ofVec3f position);
+        friend class Cache;
     };
 }
 
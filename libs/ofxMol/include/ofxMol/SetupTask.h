@@ -0,0 +1,101 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol/System.h"
+
+namespace OfxMol
+{
+    //! Progress of a System setup
+    struct SetupProgress
+    {
+        SetupProgress() : bytes_parsed(0), bytes_total(0), atoms_built(0), coarse_atoms_built(0) {}
+        
+        size_t bytes_parsed;
+        size_t bytes_total; // 0 if unknown (compressed files)
+        size_t atoms_built;
+        size_t coarse_atoms_built;
+    };
+    
+    // Setup of a System in a thread (see System::setupAsync).
+    //
+    // Poll isDone() from ofApp::update, then publish() the System with a single swap.
+    // A cancelled setup stops at the next line or model, its System is never published.
+    class SetupTask : public ofThread
+    {
+    public:
+        SetupTask(std::string path, SetupMode mode, bool useCache);
+        ~SetupTask();
+        
+        std::string getPath() const
+        {
+            return path;
+        }
+        
+        SetupProgress getProgress();
+        
+        void cancel();
+        bool isCancelled();
+        
+        //! True once the setup is finished, cancelled or not
+        bool isDone();
+        
+        //! True if the setup is finished, was not cancelled and produced models
+        bool succeeded();
+        
+        //! Swap the System built with system. Returns false (and does nothing) if the setup has not succeeded.
+        bool publish(System &system);
+        
+        //! Progress reports, called from the setup thread
+        void addBytes(size_t bytes);
+        void setTotalBytes(size_t bytes);
+        void addAtoms(size_t atoms, size_t coarse_atoms);
+        
+    protected:
+        void threadedFunction();
+        //! succeeded() with the lock held
+        bool hasSucceeded() const;
+        
+        std::string path;
+        SetupMode mode;
+        bool useCache;
+        System system;
+        SetupProgress progress;
+        // guarded by the mutex
+        bool cancelled;
+        bool done;
+        bool published;
+    };
+}
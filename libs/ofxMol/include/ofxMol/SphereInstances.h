@@ -0,0 +1,109 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxMol/SphereTemplate.h"
+#include "ofxMol/MeshBuilder.h"
+
+namespace OfxMol
+{
+    //! Attributes of one sphere (32 bytes), laid out to be uploaded as is for instanced drawing
+    struct SphereInstance
+    {
+        ofVec3f position;
+        float radius;
+        ofFloatColor color;
+    };
+    
+    //! Spheres of one resolution: the shared unit sphere (SphereTemplate) and one SphereInstance per sphere.
+    //!
+    //! To draw them with instancing, put sphere().mesh() in an ofVboMesh, upload instances() as attributes
+    //! with a divisor of 1 and compute position + radius * vertex in the vertex shader.
+    //! Without instancing, expand() writes the triangles of all the spheres in a mesh.
+    class SphereInstances
+    {
+    public:
+        SphereInstances(int resolution = 16);
+        
+        void reserve(size_t n);
+        void clear();
+        void add(const ofVec3f &position, float radius, const ofFloatColor &color);
+        size_t size() const { return _instances.size(); }
+        
+        int resolution() const { return _sphere->resolution(); }
+        const SphereTemplate &sphere() const { return *_sphere; }
+        
+        const std::vector<SphereInstance> &instances() const { return _instances; }
+        std::vector<SphereInstance> &instances() { return _instances; }
+        
+        //! Number of vertices of expand()
+        size_t number_of_vertices() const { return _instances.size() * _sphere->faceNormals().size(); }
+        
+        //! Replace the content of mesh by the triangles of the spheres (3 vertices and normals per triangle, and colors
+        //! if with_colors), as the mesh generators of Model do. The arrays of the mesh are sized once and filled in place,
+        //! by the threads of builder.
+        void expand(ofMesh &mesh, bool with_colors = true, const MeshBuilder &builder = MeshBuilder::shared()) const;
+        
+        //! Largest number of vertices of a mesh with 16 bits indices
+        static const size_t MAX_VERTICES_16_BITS = 65536;
+        
+        //! Number of vertices of expandIndexed(), shared by the triangles of a sphere
+        size_t number_of_indexed_vertices() const { return _instances.size() * _sphere->mesh().getNumVertices(); }
+        
+        //! Same triangles as expand(), with the vertices of each sphere stored once and an index buffer.
+        //! Indices are ofIndexType: where it has 16 bits (OpenGL ES), meshes of more than MAX_VERTICES_16_BITS vertices
+        //! must be split with the other expandIndexed().
+        void expandIndexed(ofMesh &mesh, bool with_colors = true, const MeshBuilder &builder = MeshBuilder::shared()) const;
+        
+        //! Same as expandIndexed(mesh, with_colors), split into meshes of at most max_vertices vertices (whole spheres)
+        void expandIndexed(std::vector<ofMesh> &meshes, bool with_colors = true, size_t max_vertices = MAX_VERTICES_16_BITS,
+                           const MeshBuilder &builder = MeshBuilder::shared()) const;
+        
+    protected:
+        //! Jobs of the builder
+        class FacesJob;
+        class IndexedJob;
+        class SplitJob;
+        
+        //! Size the arrays of mesh for count spheres
+        MeshBuilder::Arrays resizeMesh(ofMesh &mesh, bool with_colors, bool indexed, size_t count) const;
+        //! Write spheres first to last-1 in the arrays of a mesh sized by resizeMesh, whose first sphere is base
+        void writeFaces(const MeshBuilder::Arrays &arrays, size_t first, size_t last) const;
+        void writeIndexed(const MeshBuilder::Arrays &arrays, size_t first, size_t last, size_t base) const;
+        
+        const SphereTemplate *_sphere;
+        std::vector<SphereInstance> _instances;
+    };
+}
@@ -0,0 +1,63 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include "ofMain.h"
+
+namespace OfxMol
+{
+    //! Unit sphere of a resolution, tessellated once and shared by all the spheres of that resolution.
+    //! The sphere of radius r at p has the vertices faceNormals()[k] * r + p, as ofSpherePrimitive would give.
+    class SphereTemplate
+    {
+    public:
+        //! Sphere of a resolution, tessellated at the first call from any thread (templates are never freed)
+        static const SphereTemplate &get(int resolution);
+        
+        int resolution() const { return _resolution; }
+        
+        //! Unit sphere of ofSpherePrimitive (indexed), to be drawn with instancing
+        const ofMesh &mesh() const { return unit_mesh; }
+        
+        //! Normals of the vertices of the triangles of the sphere, 3 per triangle, in the order of ofMesh::getUniqueFaces
+        const std::vector<ofVec3f> &faceNormals() const { return face_normals; }
+        
+    protected:
+        SphereTemplate(int resolution);
+        
+        int _resolution;
+        ofMesh unit_mesh;
+        std::vector<ofVec3f> face_normals;
+    };
+}
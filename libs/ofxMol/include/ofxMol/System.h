@@ -33,12 +33,18 @@
 #pragma once
 
 #include <ESBTL/default.h>
+#ifdef OFXMOL_COMPRESSED_PDB
+#include <ESBTL/compressed_ifstream.h>
+#endif
 
 #include "ofMain.h"
 #include "ofxMol/Model.h"
 
 namespace OfxMol
 {
+    class LazyModels;
+    class SetupTask;
+    
     // modes:
     // SIMPLE: all atoms in one system
     //
@@ -58,7 +64,28 @@ namespace OfxMol
     class System
     {
     public:
-        void setup(std::string path, SetupMode mode = SIMPLE);
+        //! Setup from a PDB file. With useCache, models are read from the .ofxmol cache file
+        //! next to the PDB file when it is newer, otherwise the cache is written after parsing.
+        void setup(std::string path, SetupMode mode = SIMPLE, bool useCache = true);
+        
+        //! Setup in a thread. Poll the returned task for progress and call its publish method
+        //! once it is done to swap the new System with this one (see SetupTask.h).
+        static ofPtr<SetupTask> setupAsync(std::string path, SetupMode mode = SIMPLE, bool useCache = true);
+        
+        //! Exchange the models of two systems (no copy)
+        void swap(System &other);
+        
+        //! Setup without parsing the models: the MODEL records of the PDB file are indexed, and getModel
+        //! parses a model when it is needed, keeping the last ones in a cache of about cacheBytes bytes.
+        //! Model iterators are empty in this mode.
+        void setupLazy(std::string path, SetupMode mode = SIMPLE, size_t cacheBytes = 256 * 1024 * 1024);
+        
+        //! Parse model i in background (lazy setup only), so that getModel(i) does not wait.
+        //! Call it with i+1 when playing models.
+        void prefetchModel(unsigned int i);
+        
+        //! Memory budget of the model cache (lazy setup only)
+        void setModelCacheBytes(size_t bytes);
         
         //! iterator for models
         typedef std::vector<OfxMol::Model>::const_iterator Const_models_iterator;
@@ -84,15 +111,10 @@ namespace OfxMol
             return models.end();
         }
         
-        Model &getModel(unsigned int i)
-        {
-            return models[i];
-        }
+        //! With a lazy setup, the reference is valid until the next call to getModel
+        Model &getModel(unsigned int i);
         
-        unsigned int number_of_models() const
-        {
-            return models.size();
-        }
+        unsigned int number_of_models() const;
         
         
         //! iterator for water models
@@ -116,21 +138,23 @@ namespace OfxMol
             return water_models.end();
         }
         
-        Model getWaterModel(unsigned int i)
-        {
-            return water_models[i];
-        }
+        Model getWaterModel(unsigned int i);
         
-        unsigned int number_of_water_models() const
-        {
-            return water_models.size();
-        }
+        unsigned int number_of_water_models() const;
         
     protected:
-        void setupSimple(std::string &path);
-        void setupAdvanced(std::string &path);
+        //! task (if not NULL) gets the progress and can cancel the setup
+        void setup(std::string path, SetupMode mode, bool useCache, SetupTask *task);
+        void setupSimple(std::string &path, SetupTask *task);
+        void setupAdvanced(std::string &path, SetupTask *task);
+        //! Read the systems of sel and build their models, shared by the setup modes (defined in System.cpp)
+        template <class Line_selector>
+        void setupModels(std::string &path, Line_selector &sel, SetupMode mode, SetupTask *task);
         std::vector<ESBTL::Default_system_with_coarse_grain> systems;
         std::vector<OfxMol::Model> models;
         std::vector<OfxMol::Model> water_models;
+        ofPtr<OfxMol::LazyModels> lazyModels;
+        
+        friend class SetupTask;
     };
 }
\ No newline at end of file
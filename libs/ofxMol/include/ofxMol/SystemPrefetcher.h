@@ -0,0 +1,138 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#pragma once
+
+#include <map>
+
+#include "ofMain.h"
+#include "Poco/Condition.h"
+#include "ofxMol/System.h"
+#include "ofxMol/SetupTask.h"
+
+namespace OfxMol
+{
+    //! A System loaded by SystemPrefetcher, with the meshes of its first model
+    struct PrefetchedSystem
+    {
+        std::string path;
+        System system;
+        ofMesh coarseAtomsMesh;
+        ofMesh atomsMesh;
+        ofMesh atomsPointCloud;
+        ofPolyline backbone;
+        size_t bytes; // approximate size of the models and meshes
+    };
+    
+    // Systems of a list of files loaded in a background thread around the current one.
+    //
+    // The current file and its neighbours (the previous and next files) are set up and their
+    // meshes built, while their approximate size stays under a budget. setCurrent evicts the
+    // files out of the neighbourhood and counts a hit when the new current file is ready.
+    // A file is set up by a SetupTask, cancelled if the file leaves the neighbourhood before it is ready.
+    class SystemPrefetcher : public ofThread
+    {
+    public:
+        SystemPrefetcher();
+        ~SystemPrefetcher();
+        
+        //! Prefetch files around the first one, maxBytes limits the neighbours (the current file is always loaded)
+        void setup(const std::vector<std::string> &paths, SetupMode mode = SIMPLE, unsigned int neighbours = 1, size_t maxBytes = 512 * 1024 * 1024);
+        
+        //! Parameters of the meshes, as in Model::coarseAtomsMesh and Model::atomsMesh (call it before setup)
+        void setMeshes(int coarseResolution, float atomsRadius, int atomsResolution);
+        
+        //! Move to file i, loaded first if it is not ready
+        void setCurrent(unsigned int i);
+        unsigned int getCurrent() const
+        {
+            return current;
+        }
+        
+        //! File i if it is ready, empty otherwise. The System stays valid while the pointer is held, even if evicted.
+        ofPtr<PrefetchedSystem> get(unsigned int i);
+        
+        void setNeighbours(unsigned int n);
+        unsigned int getNeighbours() const
+        {
+            return neighbours;
+        }
+        
+        void setMaxBytes(size_t bytes);
+        size_t getMaxBytes() const
+        {
+            return maxBytes;
+        }
+        
+        //! Approximate size of the loaded files
+        size_t getUsedBytes();
+        
+        //! Statistics of setCurrent: the file was ready (hit) or not (miss)
+        unsigned int getHits();
+        unsigned int getMisses();
+        
+        void resetStatistics();
+        
+    protected:
+        void threadedFunction();
+        //! cancel the setup in progress and wait for the thread
+        void stop();
+        
+        //! next file to load, -1 if none (lock held)
+        int next();
+        //! remove the files out of the neighbourhood, cancel the setup of a file out of it (lock held)
+        void evict();
+        bool isNeighbour(unsigned int i) const;
+        //! build the meshes of a file set up and measure it
+        void build(PrefetchedSystem &entry);
+        
+        std::vector<std::string> paths;
+        SetupMode mode;
+        unsigned int neighbours;
+        size_t maxBytes;
+        size_t usedBytes;
+        
+        int coarseResolution;
+        float atomsRadius;
+        int atomsResolution;
+        
+        std::map<unsigned int, ofPtr<PrefetchedSystem> > entries;
+        unsigned int current;
+        int loading; // file loaded by the thread, or -1
+        ofPtr<SetupTask> task; // setup of the file loading
+        Poco::Condition changed; // signalled when next() may have changed, and by stop()
+        bool full; // over budget: no more neighbours until the next move
+        unsigned int hits;
+        unsigned int misses;
+    };
+}
@@ -36,23 +36,37 @@ namespace OfxMol
 {
     typedef ESBTL::Color_of_atom<ESBTL::Default_system_with_coarse_grain::Residue::Atom> OfxMol_Atom_color;
     
-    Atom::Atom(ESBTL::Default_system_with_coarse_grain::Atom eatom)
+    namespace
+    {
+        // First call before main, so that setup threads never race to build the shared classifier.
+        // Atom::set calls shared() itself: atoms set during static initialization do not depend on this one.
+        const bool radius_classifier_built = (Atom::Radius_classifier::shared(), true);
+    }
+    
+    Atom::Atom(const ESBTL::Default_system_with_coarse_grain::Atom &eatom)
+    {
+        set(eatom);
+    }
+    
+    void Atom::set(const ESBTL::Default_system_with_coarse_grain::Atom &eatom)
     {
         _atom = eatom;
-        OfxMol_Atom_color color_of = OfxMol_Atom_color();
-        std::vector<string> rgb = ofSplitString(color_of(eatom), ",");
-        _color.set( ofToFloat(rgb[0]), ofToFloat(rgb[1]), ofToFloat(rgb[2]));
-        _name = ESBTL::get_atom_name(eatom);
-         _is_backbone = ESBTL::is_backbone(eatom);
-        _radius = radius_classifier.get_properties(eatom).value();
+        const float *rgb = OfxMol_Atom_color::rgb_of_residue(eatom.residue_name());
+        _color.set(rgb[0], rgb[1], rgb[2]);
+        _residue_name = eatom.residue_name();
+        _chain_identifier = eatom.chain_identifier();
+        _residue_sequence_number = eatom.residue_sequence_number();
+        _insertion_code = eatom.insertion_code();
+        _is_backbone = ESBTL::is_backbone(eatom);
+        _property = Radius_classifier::shared().get_index(eatom);
     }
     
     std::string Atom::log()
     {
         std::string msg;
-        msg += "Name: [" + name() + "]";
-        msg += " residue name: [" + residue_name() + "]";
-        msg += " element [" + element() + "]";
+        msg += "Name: [" + name().str() + "]";
+        msg += " residue name: [" + residue_name().str() + "]";
+        msg += " element [" + element().str() + "]";
         msg += " position [" + ofToString(position()) + "]";
         msg += " backbone: [" + ofToString(is_backbone()? "yes" : "no") + "]";
         msg += " radius: [" + ofToString(radius()) + "]";
@@ -0,0 +1,93 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/AtomArrays.h"
+
+namespace OfxMol
+{
+    void AtomArrays::push_back(const Atom &atom)
+    {
+        ofVec3f p = atom.position();
+        x.push_back(p.x);
+        y.push_back(p.y);
+        z.push_back(p.z);
+        radius.push_back(atom.radius());
+        color.push_back(atom.getColor());
+        element.push_back(atom.element().id());
+        residue.push_back(atom.residue_name().id());
+        chain.push_back(atom.chain_identifier());
+        bfactor.push_back(atom.temperature_factor());
+        
+        unsigned char f = 0;
+        if (atom.is_backbone()) f |= BACKBONE;
+        if (atom.is_hetatm()) f |= HETATM;
+        if (ESBTL::is_water(atom)) f |= WATER;
+        if (ESBTL::is_hydrogen(atom)) f |= HYDROGEN;
+        flags.push_back(f);
+    }
+    
+    void AtomArrays::reserve(size_t n)
+    {
+        x.reserve(n);
+        y.reserve(n);
+        z.reserve(n);
+        radius.reserve(n);
+        color.reserve(n);
+        element.reserve(n);
+        residue.reserve(n);
+        chain.reserve(n);
+        bfactor.reserve(n);
+        flags.reserve(n);
+    }
+    
+    void AtomArrays::clear()
+    {
+        x.clear();
+        y.clear();
+        z.clear();
+        radius.clear();
+        color.clear();
+        element.clear();
+        residue.clear();
+        chain.clear();
+        bfactor.clear();
+        flags.clear();
+    }
+    
+    void AtomArrays::setPosition(size_t i, const ofVec3f &position)
+    {
+        x[i] = position.x;
+        y[i] = position.y;
+        z[i] = position.z;
+    }
+}
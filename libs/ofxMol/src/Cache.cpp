@@ -0,0 +1,414 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/Cache.h"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace OfxMol
+{
+    namespace
+    {
+        typedef ESBTL::Default_system_with_coarse_grain::Atom ESBTL_Atom;
+        typedef ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom ESBTL_Coarse_atom;
+        
+        const char MAGIC[8] = {'O','F','X','M','O','L','C','\0'};
+        const size_t HEADER_SIZE = 72;
+        // the checksum ends the first 48 bytes of the header
+        const size_t CHECKSUM_OFFSET = 40;
+        const size_t MODEL_HEADER_SIZE = 16;
+        const size_t ATOM_RECORD_SIZE = 88;
+        const size_t COARSE_ATOM_RECORD_SIZE = 44;
+        
+        //! Little-endian encoder
+        class Writer
+        {
+        public:
+            Writer(std::vector<unsigned char> &buffer) : buf(buffer) {}
+            
+            void u8(unsigned char v) { buf.push_back(v); }
+            
+            void u32(uint32_t v)
+            {
+                for (int i=0; i<4; i++) buf.push_back((unsigned char)(v >> (8*i)));
+            }
+            
+            void u64(uint64_t v)
+            {
+                for (int i=0; i<8; i++) buf.push_back((unsigned char)(v >> (8*i)));
+            }
+            
+            void i32(int32_t v) { u32((uint32_t) v); }
+            
+            void f32(float v)
+            {
+                uint32_t bits;
+                memcpy(&bits, &v, 4);
+                u32(bits);
+            }
+            
+            void f64(double v)
+            {
+                uint64_t bits;
+                memcpy(&bits, &v, 8);
+                u64(bits);
+            }
+            
+            void name(const ESBTL::Name &n) { u32(n.id()); }
+            
+            void color(const ofFloatColor &c)
+            {
+                f32(c.r); f32(c.g); f32(c.b); f32(c.a);
+            }
+            
+        private:
+            std::vector<unsigned char> &buf;
+        };
+        
+        //! Little-endian decoder. Bounds are checked by the caller.
+        class Reader
+        {
+        public:
+            Reader(const unsigned char *data) : p(data) {}
+            
+            unsigned char u8() { return *p++; }
+            
+            uint32_t u32()
+            {
+                uint32_t v = 0;
+                for (int i=0; i<4; i++) v |= uint32_t(*p++) << (8*i);
+                return v;
+            }
+            
+            uint64_t u64()
+            {
+                uint64_t v = 0;
+                for (int i=0; i<8; i++) v |= uint64_t(*p++) << (8*i);
+                return v;
+            }
+            
+            int32_t i32() { return (int32_t) u32(); }
+            
+            float f32()
+            {
+                uint32_t bits = u32();
+                float v;
+                memcpy(&v, &bits, 4);
+                return v;
+            }
+            
+            double f64()
+            {
+                uint64_t bits = u64();
+                double v;
+                memcpy(&v, &bits, 8);
+                return v;
+            }
+            
+            //! Returns false if the identifier is not the one of a name
+            bool name(ESBTL::Name &n)
+            {
+                uint32_t id = u32();
+                n = ESBTL::Name::from_id(id);
+                return ESBTL::Name(n.str()).id() == id;
+            }
+            
+            ofFloatColor color()
+            {
+                float r = f32(); float g = f32(); float b = f32(); float a = f32();
+                return ofFloatColor(r, g, b, a);
+            }
+            
+            void skip(size_t n) { p += n; }
+            
+        private:
+            const unsigned char *p;
+        };
+        
+        //! FNV-1a hash of the records
+        uint64_t checksum(const unsigned char *begin, const unsigned char *end)
+        {
+            uint64_t hash = 14695981039346656037ULL;
+            for (; begin!=end; ++begin)
+            {
+                hash ^= *begin;
+                hash *= 1099511628211ULL;
+            }
+            return hash;
+        }
+    }
+    
+    std::string Cache::path(const std::string &pdbPath, SetupMode mode)
+    {
+        return pdbPath + (mode == ADVANCED ? ".advanced.ofxmol" : ".ofxmol");
+    }
+    
+    bool Cache::stat(const std::string &pdbPath, Source &source)
+    {
+        struct stat pdbStat;
+        if (::stat(pdbPath.c_str(), &pdbStat) != 0) return false;
+        source.size = pdbStat.st_size;
+        source.mtime = pdbStat.st_mtime;
+#if defined(TARGET_OSX) || defined(TARGET_OF_IOS)
+        source.mtime_nsec = pdbStat.st_mtimespec.tv_nsec;
+#elif defined(TARGET_LINUX) || defined(TARGET_ANDROID)
+        source.mtime_nsec = pdbStat.st_mtim.tv_nsec;
+#else
+        source.mtime_nsec = 0;
+#endif
+        return true;
+    }
+    
+    bool Cache::isFresh(const std::string &cachePath, const std::string &pdbPath)
+    {
+        Source source;
+        if (!stat(pdbPath, source)) return false;
+        
+        unsigned char header[HEADER_SIZE];
+        std::ifstream file(cachePath.c_str(), std::ios_base::binary);
+        if (!file.read((char*) header, HEADER_SIZE)) return false;
+        
+        // the rest of the header is checked by read()
+        Reader in(header + HEADER_SIZE - 24);
+        return in.u64() == source.size && (int64_t) in.u64() == source.mtime && in.u32() == source.mtime_nsec;
+    }
+    
+    bool Cache::write(const std::string &cachePath, const Source &source, SetupMode mode,
+                      const std::vector<OfxMol::Model> &models, const std::vector<OfxMol::Model> &water_models)
+    {
+        std::vector<unsigned char> buffer;
+        Writer out(buffer);
+        
+        size_t size = HEADER_SIZE;
+        for (int k=0; k<2; k++)
+        {
+            const std::vector<OfxMol::Model> &list = (k == 0 ? models : water_models);
+            for (std::vector<OfxMol::Model>::const_iterator it=list.begin(); it!=list.end(); ++it)
+            {
+                size += MODEL_HEADER_SIZE + it->atoms.size() * ATOM_RECORD_SIZE + it->coarse_atoms.size() * COARSE_ATOM_RECORD_SIZE;
+            }
+        }
+        buffer.reserve(size);
+        
+        // HEADER
+        buffer.insert(buffer.end(), MAGIC, MAGIC + 8);
+        out.u32(VERSION);
+        out.u32(mode);
+        out.u32(ATOM_RECORD_SIZE);
+        out.u32(COARSE_ATOM_RECORD_SIZE);
+        out.u32(models.size());
+        out.u32(water_models.size());
+        out.u64(size);
+        out.u64(0); // checksum, set below
+        out.u64(source.size);
+        out.u64(source.mtime);
+        out.u32(source.mtime_nsec);
+        out.u32(0);
+        
+        // MODELS, then WATER MODELS
+        for (int k=0; k<2; k++)
+        {
+            const std::vector<OfxMol::Model> &list = (k == 0 ? models : water_models);
+            for (std::vector<OfxMol::Model>::const_iterator it=list.begin(); it!=list.end(); ++it)
+            {
+                out.i32(it->_model_number);
+                out.u32(it->atoms.size());
+                out.u32(it->coarse_atoms.size());
+                out.u32(0);
+                
+                for (Model::Const_atoms_iterator atm=it->atoms_begin(); atm!=it->atoms_end(); ++atm)
+                {
+                    const ESBTL_Atom &eatom = atm->_atom;
+                    out.f64(eatom.x());
+                    out.f64(eatom.y());
+                    out.f64(eatom.z());
+                    out.f64(eatom.occupancy());
+                    out.f64(eatom.temperature_factor());
+                    out.color(atm->_color);
+                    out.i32(eatom.atom_serial_number());
+                    out.i32(eatom.charge());
+                    out.i32(atm->_residue_sequence_number);
+                    out.u8(eatom.alternate_location());
+                    out.u8(eatom.is_hetatm());
+                    out.u8(atm->_is_backbone);
+                    out.u8(atm->_property);
+                    out.u8(atm->_chain_identifier);
+                    out.u8(atm->_insertion_code);
+                    out.u8(0);
+                    out.u8(0);
+                    out.name(eatom.atom_name());
+                    out.name(eatom.element());
+                    out.name(atm->_residue_name);
+                }
+                
+                for (Model::Const_coarse_atoms_iterator atm=it->coarse_atoms_begin(); atm!=it->coarse_atoms_end(); ++atm)
+                {
+                    out.f64(atm->_atom.x());
+                    out.f64(atm->_atom.y());
+                    out.f64(atm->_atom.z());
+                    out.color(atm->color);
+                    out.u8(atm->_is_backbone);
+                    out.u8(atm->_property);
+                    out.u8(0);
+                    out.u8(0);
+                }
+            }
+        }
+        
+        uint64_t hash = checksum(&buffer[0] + HEADER_SIZE, &buffer[0] + buffer.size());
+        for (int i=0; i<8; i++) buffer[CHECKSUM_OFFSET + i] = (unsigned char)(hash >> (8*i));
+        
+        // write in a temporary file first: a reader never sees a partial cache
+        std::string tmpPath = cachePath + ".tmp";
+        std::ofstream file(tmpPath.c_str(), std::ios_base::binary | std::ios_base::trunc);
+        if (!file.write((const char*) &buffer[0], buffer.size()))
+        {
+            file.close();
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+        file.close();
+        
+        std::remove(cachePath.c_str());
+        return std::rename(tmpPath.c_str(), cachePath.c_str()) == 0;
+    }
+    
+    bool Cache::read(const std::string &cachePath, SetupMode mode,
+                     std::vector<OfxMol::Model> &models, std::vector<OfxMol::Model> &water_models)
+    {
+        models.clear();
+        water_models.clear();
+        
+        ESBTL::internal::Mapped_file file;
+        if (!file.open(cachePath) || file.size() < HEADER_SIZE) return false;
+        
+        const unsigned char *data = (const unsigned char*) file.data();
+        const size_t size = file.size();
+        
+        // HEADER
+        if (memcmp(data, MAGIC, 8) != 0) return false;
+        Reader in(data + 8);
+        if (in.u32() != VERSION) return false;
+        if (in.u32() != (uint32_t) mode) return false;
+        if (in.u32() != ATOM_RECORD_SIZE || in.u32() != COARSE_ATOM_RECORD_SIZE) return false;
+        uint32_t nb_models = in.u32();
+        uint32_t nb_water_models = in.u32();
+        if (in.u64() != size) return false;
+        if (in.u64() != checksum(data + HEADER_SIZE, data + size)) return false;
+        
+        size_t offset = HEADER_SIZE;
+        bool valid = true;
+        for (int k=0; k<2 && valid; k++)
+        {
+            std::vector<OfxMol::Model> &list = (k == 0 ? models : water_models);
+            uint32_t nb = (k == 0 ? nb_models : nb_water_models);
+            
+            for (uint32_t i=0; i<nb && valid; i++)
+            {
+                if (size - offset < MODEL_HEADER_SIZE) break;
+                in = Reader(data + offset);
+                int32_t model_number = in.i32();
+                uint64_t nb_atoms = in.u32();
+                uint64_t nb_coarse_atoms = in.u32();
+                in.skip(4);
+                offset += MODEL_HEADER_SIZE;
+                
+                if (nb_atoms * ATOM_RECORD_SIZE + nb_coarse_atoms * COARSE_ATOM_RECORD_SIZE > size - offset) break;
+                offset += nb_atoms * ATOM_RECORD_SIZE + nb_coarse_atoms * COARSE_ATOM_RECORD_SIZE;
+                
+                list.push_back(OfxMol::Model(model_number));
+                OfxMol::Model &model = list.back();
+                
+                model.atoms.resize(nb_atoms);
+                for (std::vector<OfxMol::Atom>::iterator atm=model.atoms.begin(); atm!=model.atoms.end(); ++atm)
+                {
+                    double x = in.f64();
+                    double y = in.f64();
+                    double z = in.f64();
+                    ESBTL_Atom &eatom = atm->_atom;
+                    static_cast<ESBTL_Atom::Point_3&>(eatom) = ESBTL_Atom::Point_3(x, y, z);
+                    eatom.occupancy() = in.f64();
+                    eatom.temperature_factor() = in.f64();
+                    atm->_color = in.color();
+                    eatom.atom_serial_number() = in.i32();
+                    eatom.charge() = in.i32();
+                    atm->_residue_sequence_number = in.i32();
+                    eatom.alternate_location() = in.u8();
+                    eatom.is_hetatm() = in.u8() != 0;
+                    atm->_is_backbone = in.u8() != 0;
+                    atm->_property = in.u8();
+                    atm->_chain_identifier = in.u8();
+                    atm->_insertion_code = in.u8();
+                    in.skip(2);
+                    if (atm->_property >= Atom::Radius_classifier::shared().number_of_properties() ||
+                        !in.name(eatom.atom_name()) || !in.name(eatom.element()) || !in.name(atm->_residue_name))
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+                
+                model.coarse_atoms.resize(nb_coarse_atoms);
+                for (std::vector<OfxMol::Coarse_Atom>::iterator atm=model.coarse_atoms.begin(); atm!=model.coarse_atoms.end(); ++atm)
+                {
+                    double x = in.f64();
+                    double y = in.f64();
+                    double z = in.f64();
+                    static_cast<ESBTL_Coarse_atom::Point_3&>(atm->_atom) = ESBTL_Coarse_atom::Point_3(x, y, z);
+                    atm->color = in.color();
+                    atm->_is_backbone = in.u8() != 0;
+                    atm->_property = in.u8();
+                    in.skip(2);
+                    if (atm->_property >= Coarse_Atom::Radius_classifier::shared().number_of_properties())
+                    {
+                        valid = false;
+                        break;
+                    }
+                }
+                model.updateArrays();
+                model.updateIndex();
+            }
+        }
+        
+        if (!valid || offset != size || models.size() != nb_models || water_models.size() != nb_water_models)
+        {
+            models.clear();
+            water_models.clear();
+            return false;
+        }
+        return true;
+    }
+}
@@ -36,13 +36,26 @@ namespace OfxMol
 {
     typedef ESBTL::Color_of_atom<ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom> OfxMol_Coarse_Atom_color;
     
-    Coarse_Atom::Coarse_Atom(ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom eatom)
+    namespace
+    {
+        // First call before main, so that setup threads never race to build the shared classifier.
+        // Coarse_Atom::set calls shared() itself: coarse atoms set during static initialization do not depend on this one.
+        const bool radius_classifier_built = (Coarse_Atom::Radius_classifier::shared(), true);
+    }
+    
+    Coarse_Atom::Coarse_Atom(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom)
+    {
+        set(eatom);
+    }
+    
+    void Coarse_Atom::set(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom)
     {
         _atom = eatom;
-        _radius = radius_classifier.get_properties(eatom).value();
-        OfxMol_Coarse_Atom_color color_of = OfxMol_Coarse_Atom_color();
-        std::vector<string> rgb = ofSplitString(color_of(eatom), ",");
-        color.set( ofToFloat(rgb[0]), ofToFloat(rgb[1]), ofToFloat(rgb[2]));
+        _property = Radius_classifier::shared().get_index(eatom);
+        // Coarse_creator_two_barycenters puts the backbone barycenter at index 0
+        _is_backbone = (eatom.index() == 0);
+        const float *rgb = OfxMol_Coarse_Atom_color::rgb_of_residue(eatom.residue().residue_name());
+        color.set(rgb[0], rgb[1], rgb[2]);
     }
     
     ofSpherePrimitive Coarse_Atom::sphere(int resolution)
@@ -0,0 +1,245 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/ColorScheme.h"
+
+namespace OfxMol
+{
+    namespace
+    {
+        typedef ESBTL::Color_of_atom<ESBTL::Default_system_with_coarse_grain::Residue::Atom> OfxMol_Atom_color;
+        
+        const char *const RESIDUES[] = {"ALA", "CYS", "GLY", "PRO", "SER", "THR", "VAL", "LEU", "ILE", "MET", "MSE",
+            "PHE", "TYR", "TRP", "HIS", "LYS", "ARG", "ASN", "GLN", "GLU", "ASP"};
+        
+        struct Element_color
+        {
+            const char *element;
+            float r, g, b;
+        };
+        
+        // CPK colors, as in Jmol
+        const Element_color ELEMENTS[] = {
+            {"H", 1.f, 1.f, 1.f}, {"C", 0.565f, 0.565f, 0.565f}, {"N", 0.188f, 0.314f, 0.973f},
+            {"O", 1.f, 0.051f, 0.051f}, {"S", 1.f, 1.f, 0.188f}, {"P", 1.f, 0.502f, 0.f},
+            {"F", 0.565f, 0.878f, 0.314f}, {"CL", 0.122f, 0.941f, 0.122f}, {"BR", 0.651f, 0.161f, 0.161f},
+            {"I", 0.58f, 0.f, 0.58f}, {"NA", 0.671f, 0.361f, 0.949f}, {"K", 0.561f, 0.251f, 0.831f},
+            {"MG", 0.541f, 1.f, 0.f}, {"CA", 0.239f, 1.f, 0.f}, {"MN", 0.612f, 0.478f, 0.78f},
+            {"FE", 0.878f, 0.4f, 0.2f}, {"CO", 0.941f, 0.565f, 0.627f}, {"NI", 0.314f, 0.816f, 0.314f},
+            {"CU", 0.784f, 0.502f, 0.2f}, {"ZN", 0.49f, 0.502f, 0.69f}, {"SE", 1.f, 0.631f, 0.f}};
+        
+        // qualitative palette of the chains
+        const float CHAINS[][3] = {
+            {0.122f, 0.467f, 0.706f}, {1.f, 0.498f, 0.055f}, {0.173f, 0.627f, 0.173f}, {0.839f, 0.153f, 0.157f},
+            {0.58f, 0.404f, 0.741f}, {0.549f, 0.337f, 0.294f}, {0.89f, 0.467f, 0.761f}, {0.498f, 0.498f, 0.498f},
+            {0.737f, 0.741f, 0.133f}, {0.09f, 0.745f, 0.812f}};
+        
+        const char CHAIN_ORDER[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
+    }
+    
+    ColorScheme::ColorScheme(Type type) : type(type), bfactorMin(0), bfactorMax(0)
+    {
+        const float *unknown = OfxMol_Atom_color::rgb_of_residue(ESBTL::Name());
+        defaultColor.set(unknown[0], unknown[1], unknown[2]);
+        if (type == ELEMENT)
+        {
+            defaultColor.set(1.f, 0.078f, 0.576f);
+        }
+        else if (type == UNIFORM)
+        {
+            defaultColor.set(1.f, 1.f, 1.f);
+        }
+        
+        for (size_t i=0; i<sizeof(RESIDUES)/sizeof(RESIDUES[0]); i++)
+        {
+            const float *rgb = OfxMol_Atom_color::rgb_of_residue(ESBTL::Name(RESIDUES[i]));
+            residueColors.set(ESBTL::Name(RESIDUES[i]).id(), ofFloatColor(rgb[0], rgb[1], rgb[2]));
+        }
+        
+        for (size_t i=0; i<sizeof(ELEMENTS)/sizeof(ELEMENTS[0]); i++)
+        {
+            elementColors.set(ESBTL::Name(ELEMENTS[i].element).id(), ofFloatColor(ELEMENTS[i].r, ELEMENTS[i].g, ELEMENTS[i].b));
+        }
+        
+        std::vector<ofFloatColor> palette;
+        for (size_t i=0; i<sizeof(CHAINS)/sizeof(CHAINS[0]); i++)
+        {
+            palette.push_back(ofFloatColor(CHAINS[i][0], CHAINS[i][1], CHAINS[i][2]));
+        }
+        setChainPalette(palette);
+        
+        setBFactorColors(ofFloatColor(0.f, 0.f, 1.f), ofFloatColor(1.f, 1.f, 1.f), ofFloatColor(1.f, 0.f, 0.f));
+    }
+    
+    std::string ColorScheme::getName() const
+    {
+        switch (type)
+        {
+            case RESIDUE: return "residue";
+            case ELEMENT: return "element";
+            case CHAIN: return "chain";
+            case BFACTOR: return "B-factor";
+            case UNIFORM: return "uniform";
+        }
+        return "";
+    }
+    
+    void ColorScheme::apply(Model &model) const
+    {
+        AtomArrays &arrays = model.arrays();
+        size_t n = arrays.size();
+        if (n == 0)
+        {
+            return;
+        }
+        
+        ofFloatColor *colors = &arrays.color[0];
+        switch (type)
+        {
+            case RESIDUE:
+                residueColors.apply(&arrays.residue[0], n, defaultColor, colors);
+                break;
+            case ELEMENT:
+                elementColors.apply(&arrays.element[0], n, defaultColor, colors);
+                break;
+            case CHAIN:
+            {
+                const char *chains = &arrays.chain[0];
+                for (size_t i=0; i<n; i++)
+                {
+                    colors[i] = chainColors[(unsigned char) chains[i]];
+                }
+                break;
+            }
+            case BFACTOR:
+                applyBFactor(&arrays.bfactor[0], n, colors);
+                break;
+            case UNIFORM:
+                std::fill(colors, colors + n, defaultColor);
+                break;
+        }
+    }
+    
+    void ColorScheme::applyBFactor(const float *bfactor, size_t n, ofFloatColor *colors) const
+    {
+        float low = bfactorMin;
+        float high = bfactorMax;
+        if (low >= high)
+        {
+            low = *std::min_element(bfactor, bfactor + n);
+            high = *std::max_element(bfactor, bfactor + n);
+        }
+        
+        // index of the gradient, clamped in [0, GRADIENT_SIZE - 1]
+        float scale = (high > low) ? (GRADIENT_SIZE - 1) / (high - low) : 0.f;
+        for (size_t i=0; i<n; i++)
+        {
+            float t = (bfactor[i] - low) * scale + 0.5f;
+            t = std::min(std::max(t, 0.f), float(GRADIENT_SIZE - 1));
+            colors[i] = gradient[(size_t) t];
+        }
+    }
+    
+    void ColorScheme::setDefaultColor(const ofFloatColor &color)
+    {
+        defaultColor = color;
+    }
+    
+    void ColorScheme::setResidueColor(const ESBTL::Name &residue, const ofFloatColor &color)
+    {
+        residueColors.set(residue.id(), color);
+    }
+    
+    void ColorScheme::setElementColor(const ESBTL::Name &element, const ofFloatColor &color)
+    {
+        elementColors.set(element.id(), color);
+    }
+    
+    void ColorScheme::setChainColor(char chain, const ofFloatColor &color)
+    {
+        chainColors[(unsigned char) chain] = color;
+    }
+    
+    void ColorScheme::setChainPalette(const std::vector<ofFloatColor> &palette)
+    {
+        std::fill(chainColors, chainColors + 256, defaultColor);
+        if (palette.empty())
+        {
+            return;
+        }
+        for (size_t i=0; CHAIN_ORDER[i] != '\0'; i++)
+        {
+            chainColors[(unsigned char) CHAIN_ORDER[i]] = palette[i % palette.size()];
+        }
+    }
+    
+    void ColorScheme::setBFactorColors(const ofFloatColor &low, const ofFloatColor &mid, const ofFloatColor &high)
+    {
+        gradient.resize(GRADIENT_SIZE);
+        for (size_t i=0; i<GRADIENT_SIZE; i++)
+        {
+            float t = 2.f * i / (GRADIENT_SIZE - 1);
+            gradient[i] = (t <= 1.f) ? low.getLerped(mid, t) : mid.getLerped(high, t - 1.f);
+        }
+    }
+    
+    void ColorScheme::setBFactorRange(float min, float max)
+    {
+        bfactorMin = min;
+        bfactorMax = max;
+    }
+    
+    void ColorScheme::NameColors::set(uint32_t id, const ofFloatColor &color)
+    {
+        byId[id] = color;
+        
+        // the table is rebuilt for each color set: palettes are small and set once
+        std::vector<ESBTL::internal::Perfect_hash_table::Entry> entries;
+        values.clear();
+        for (std::map<uint32_t, ofFloatColor>::const_iterator it=byId.begin(); it!=byId.end(); ++it)
+        {
+            entries.push_back(ESBTL::internal::Perfect_hash_table::Entry(it->first, values.size()));
+            values.push_back(it->second);
+        }
+        index.build(entries);
+    }
+    
+    void ColorScheme::NameColors::apply(const uint32_t *ids, size_t n, const ofFloatColor &defaultColor, ofFloatColor *colors) const
+    {
+        for (size_t i=0; i<n; i++)
+        {
+            unsigned k;
+            colors[i] = index.find(ids[i], k) ? values[k] : defaultColor;
+        }
+    }
+}
@@ -0,0 +1,349 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/LazyModels.h"
+
+namespace OfxMol
+{
+    namespace
+    {
+        typedef ESBTL::All_atom_system_builder<ESBTL::Default_system_with_coarse_grain> OfxMol_Builder;
+        typedef ESBTL::Accept_all_occupancy_policy<ESBTL::PDB::Line_format<> > Accept_all_occupancy_policy;
+        typedef std::vector<ESBTL::Default_system_with_coarse_grain> Systems;
+        
+        template <class Line_selector>
+        void readRange(const char *begin, const char *end, char altloc, Systems &systems)
+        {
+            Line_selector sel;
+            OfxMol_Builder builder(systems, sel.max_nb_systems());
+            ESBTL::Line_reader<ESBTL::PDB::Line_format<>, Line_selector, OfxMol_Builder> reader(sel, builder);
+            reader.read_buffer(begin, end, Accept_all_occupancy_policy(), altloc);
+        }
+        
+        //! first model of a system, empty model if none
+        Model *firstModel(Systems &systems, size_t i, bool with_coarse_atoms)
+        {
+            if (systems.size() <= i || systems[i].has_no_model())
+            {
+                return new Model();
+            }
+            return new Model(*systems[i].models_begin(), with_coarse_atoms);
+        }
+        
+        size_t modelBytes(Model &model)
+        {
+            return sizeof(Model) + model.number_of_atoms() * sizeof(Atom) + model.number_of_coarse_atoms() * sizeof(Coarse_Atom);
+        }
+    }
+    
+    LazyModels::LazyModels() : mode(SIMPLE), altloc(' '), cacheBytes(0), usedBytes(0), loading(-1), pinned(-1)
+    {
+    }
+    
+    LazyModels::~LazyModels()
+    {
+        stop();
+        clear();
+    }
+    
+    bool LazyModels::setup(const std::string &path, SetupMode mode, size_t cacheBytes)
+    {
+        stop();
+        clear();
+        ranges.clear();
+        
+        this->path = path;
+        this->mode = mode;
+        this->cacheBytes = cacheBytes;
+        altloc = ' ';
+        
+        if (ESBTL::detect_reading_mode(path) != ESBTL::MMAP)
+        {
+            ofLogError() << "[ofxMol::LazyModels] Compressed files can not be indexed: " << path;
+            return false;
+        }
+        
+        if (!file.open(path))
+        {
+            ofLogError() << "[ofxMol::LazyModels] Can not open file: " << path;
+            return false;
+        }
+        
+        // INDEX: byte range of each MODEL record, up to its ENDMDL
+        const char *data = file.data();
+        const char *end = data + file.size();
+        const char *line = data;
+        bool open = false;
+        Range range;
+        
+        while (line != end)
+        {
+            const char *eol = static_cast<const char*>(memchr(line, '\n', end - line));
+            const char *next = (eol == NULL) ? end : eol + 1;
+            size_t length = (eol == NULL ? end : eol) - line;
+            
+            if (ESBTL::internal::line_starts_with(line, length, "MODEL", 5))
+            {
+                if (open)
+                {
+                    range.end = line - data;
+                    ranges.push_back(range);
+                }
+                range.begin = line - data;
+                open = true;
+            }
+            else if (ESBTL::internal::line_starts_with(line, length, "ENDMDL", 6))
+            {
+                if (open)
+                {
+                    range.end = next - data;
+                    ranges.push_back(range);
+                    open = false;
+                }
+            }
+            else if (altloc == ' ' && length > 16 &&
+                     (ESBTL::internal::line_starts_with(line, length, "ATOM", 4) || ESBTL::internal::line_starts_with(line, length, "HETATM", 6)))
+            {
+                // the alternate location used by the whole file
+                altloc = line[16];
+            }
+            line = next;
+        }
+        
+        if (open)
+        {
+            range.end = file.size();
+            ranges.push_back(range);
+        }
+        
+        // no MODEL record: a single model
+        if (ranges.empty())
+        {
+            range.begin = 0;
+            range.end = file.size();
+            ranges.push_back(range);
+        }
+        
+        ofLogNotice() << "[ofxMol::LazyModels] Indexed " << ranges.size() << " models in file: " << path;
+        startThread(true, false);
+        return true;
+    }
+    
+    Model &LazyModels::getModel(unsigned int i)
+    {
+        return *get(i).model;
+    }
+    
+    Model &LazyModels::getWaterModel(unsigned int i)
+    {
+        return *get(i).water;
+    }
+    
+    void LazyModels::prefetch(unsigned int i)
+    {
+        if (i >= ranges.size()) return;
+        
+        ofScopedLock lock(mutex);
+        if (cache.find(i) == cache.end() && loading != (int) i && std::find(requests.begin(), requests.end(), i) == requests.end())
+        {
+            requests.push_back(i);
+            requested.signal();
+        }
+    }
+    
+    void LazyModels::setCacheBytes(size_t bytes)
+    {
+        ofScopedLock lock(mutex);
+        cacheBytes = bytes;
+        evict();
+    }
+    
+    size_t LazyModels::getUsedBytes()
+    {
+        ofScopedLock lock(mutex);
+        return usedBytes;
+    }
+    
+    void LazyModels::threadedFunction()
+    {
+        lock();
+        while (isThreadRunning())
+        {
+            while (!requests.empty() && cache.find(requests.front()) != cache.end())
+            {
+                requests.pop_front();
+            }
+            if (requests.empty())
+            {
+                requested.wait(mutex);
+                continue;
+            }
+            
+            Entry entry;
+            entry.index = requests.front();
+            requests.pop_front();
+            loading = entry.index;
+            unlock();
+            
+            parse(entry.index, entry);
+            
+            lock();
+            insert(entry);
+            loading = -1;
+            loaded.broadcast();
+        }
+        unlock();
+    }
+    
+    void LazyModels::stop()
+    {
+        lock();
+        stopThread();
+        requested.signal();
+        unlock();
+        waitForThread(false);
+    }
+    
+    void LazyModels::parse(unsigned int i, Entry &entry)
+    {
+        const char *data = file.data();
+        Systems systems;
+        
+        if (mode == ADVANCED)
+        {
+            readRange<ESBTL::PDB_line_selector_two_systems>(data + ranges[i].begin, data + ranges[i].end, altloc, systems);
+        }
+        else
+        {
+            readRange<ESBTL::PDB_line_selector>(data + ranges[i].begin, data + ranges[i].end, altloc, systems);
+        }
+        
+        entry.index = i;
+        entry.model = firstModel(systems, 0, true);
+        entry.water = firstModel(systems, 1, false);
+        entry.bytes = modelBytes(*entry.model) + modelBytes(*entry.water);
+    }
+    
+    LazyModels::Entry &LazyModels::get(unsigned int i)
+    {
+        if (i >= ranges.size())
+        {
+            ofLogFatalError() << "[ofxMol::LazyModels] No model " << i << " in file: " << path;
+            i = 0;
+        }
+        
+        lock();
+        while (true)
+        {
+            std::map<unsigned int, std::list<Entry>::iterator>::iterator it = cache.find(i);
+            if (it != cache.end())
+            {
+                // most recently used
+                entries.splice(entries.begin(), entries, it->second);
+                pinned = i;
+                Entry &entry = entries.front();
+                unlock();
+                return entry;
+            }
+            
+            if (loading != (int) i)
+            {
+                break;
+            }
+            // the thread is parsing this model
+            loaded.wait(mutex);
+        }
+        unlock();
+        
+        Entry entry;
+        parse(i, entry);
+        
+        lock();
+        pinned = i;
+        if (cache.find(i) == cache.end())
+        {
+            insert(entry);
+        }
+        else
+        {
+            delete entry.model;
+            delete entry.water;
+        }
+        entries.splice(entries.begin(), entries, cache[i]);
+        evict();
+        Entry &result = entries.front();
+        unlock();
+        return result;
+    }
+    
+    void LazyModels::insert(Entry &entry)
+    {
+        entries.push_front(entry);
+        cache[entry.index] = entries.begin();
+        usedBytes += entry.bytes;
+        evict();
+    }
+    
+    void LazyModels::evict()
+    {
+        std::list<Entry>::iterator it = entries.end();
+        while (usedBytes > cacheBytes && it != entries.begin())
+        {
+            --it;
+            if ((int) it->index == pinned)
+            {
+                continue;
+            }
+            usedBytes -= it->bytes;
+            delete it->model;
+            delete it->water;
+            cache.erase(it->index);
+            it = entries.erase(it);
+        }
+    }
+    
+    void LazyModels::clear()
+    {
+        for (std::list<Entry>::iterator it = entries.begin(); it != entries.end(); ++it)
+        {
+            delete it->model;
+            delete it->water;
+        }
+        entries.clear();
+        cache.clear();
+        requests.clear();
+        usedBytes = 0;
+        loading = -1;
+        pinned = -1;
+    }
+}
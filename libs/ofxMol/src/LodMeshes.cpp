@@ -0,0 +1,481 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/LodMeshes.h"
+
+#include <cassert>
+#include <cfloat>
+#include <boost/cstdint.hpp>
+
+namespace OfxMol
+{
+    namespace
+    {
+        // Level of the tiles before the first update, or after the levels changed
+        const size_t NO_LEVEL = size_t(-1);
+        
+        // Tile coordinates packed in 21 bits each: tiles sorted by key are sorted by x, y and z
+        typedef std::pair<boost::uint64_t, unsigned int> Tile_entry;
+        
+        boost::uint64_t tileKey(const ofVec3f &position, const ofVec3f &origin, float tile_size)
+        {
+            const boost::uint64_t max_coordinate = (1 << 21) - 1;
+            boost::uint64_t key = 0;
+            for (int k=0; k<3; k++)
+            {
+                float coordinate = std::max((position[k] - origin[k]) / tile_size, 0.0f);
+                key = (key << 21) | std::min(static_cast<boost::uint64_t>(coordinate), max_coordinate);
+            }
+            return key;
+        }
+        
+        void growTile(ofVec3f &min, ofVec3f &max, const ofVec3f &position)
+        {
+            for (int k=0; k<3; k++)
+            {
+                min[k] = std::min(min[k], position[k]);
+                max[k] = std::max(max[k], position[k]);
+            }
+        }
+    }
+    
+    LodMeshes::LodMeshes() : model(NULL), far(POINTS), budget(0), far_changed(true), far_triangles(0), far_elements(0), far_tiles(0)
+    {
+        addLevel(24, 16.0f);
+        addLevel(12, 6.0f);
+        addLevel(6, 2.0f);
+    }
+    
+    void LodMeshes::setup(Model *model, float tile_size)
+    {
+        this->model = model;
+        tiles.clear();
+        tile_atoms.clear();
+        tile_coarse_atoms.clear();
+        
+        assert(tile_size > 0.0f);
+        if (!(tile_size > 0.0f))
+        {
+            ofLogError() << "[ofxMol::LodMeshes] Tile size must be positive: " << tile_size;
+            return;
+        }
+        
+        const AtomArrays &arrays = model->arrays();
+        const size_t nb_atoms = arrays.size();
+        const size_t nb_coarse_atoms = model->number_of_coarse_atoms();
+        Model::Const_coarse_atoms_iterator coarse_atoms = static_cast<const Model*>(model)->coarse_atoms_begin();
+        
+        ofVec3f origin(FLT_MAX, FLT_MAX, FLT_MAX);
+        ofVec3f corner(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (size_t i=0; i<nb_atoms; i++)
+        {
+            growTile(origin, corner, arrays.position(i));
+        }
+        for (size_t i=0; i<nb_coarse_atoms; i++)
+        {
+            growTile(origin, corner, coarse_atoms[i].position());
+        }
+        
+        // atoms and coarse atoms sorted by tile
+        std::vector<Tile_entry> atom_entries(nb_atoms);
+        for (size_t i=0; i<nb_atoms; i++)
+        {
+            atom_entries[i] = Tile_entry(tileKey(arrays.position(i), origin, tile_size), i);
+        }
+        std::sort(atom_entries.begin(), atom_entries.end());
+        std::vector<Tile_entry> coarse_entries(nb_coarse_atoms);
+        for (size_t i=0; i<nb_coarse_atoms; i++)
+        {
+            coarse_entries[i] = Tile_entry(tileKey(coarse_atoms[i].position(), origin, tile_size), i);
+        }
+        std::sort(coarse_entries.begin(), coarse_entries.end());
+        
+        // one tile per key of either list
+        tile_atoms.resize(nb_atoms);
+        tile_coarse_atoms.resize(nb_coarse_atoms);
+        size_t a = 0;
+        size_t c = 0;
+        while (a < nb_atoms || c < nb_coarse_atoms)
+        {
+            boost::uint64_t key = a < nb_atoms ? atom_entries[a].first : coarse_entries[c].first;
+            if (c < nb_coarse_atoms)
+            {
+                key = std::min(key, coarse_entries[c].first);
+            }
+            
+            Tile tile;
+            tile.min = ofVec3f(FLT_MAX, FLT_MAX, FLT_MAX);
+            tile.max = ofVec3f(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            tile.radius = 0.0f;
+            tile.first_atom = a;
+            for (; a < nb_atoms && atom_entries[a].first == key; a++)
+            {
+                unsigned int i = atom_entries[a].second;
+                tile_atoms[a] = i;
+                growTile(tile.min, tile.max, arrays.position(i));
+                tile.radius = std::max(tile.radius, arrays.radius[i]);
+            }
+            tile.number_of_atoms = a - tile.first_atom;
+            tile.first_coarse_atom = c;
+            for (; c < nb_coarse_atoms && coarse_entries[c].first == key; c++)
+            {
+                unsigned int i = coarse_entries[c].second;
+                tile_coarse_atoms[c] = i;
+                growTile(tile.min, tile.max, coarse_atoms[i].position());
+                tile.radius = std::max(tile.radius, coarse_atoms[i].radius());
+            }
+            tile.number_of_coarse_atoms = c - tile.first_coarse_atom;
+            tile.level = NO_LEVEL;
+            tile.pixels = 0.0f;
+            tiles.push_back(tile);
+        }
+        
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            levels[l].changed = true;
+        }
+        far_changed = true;
+        
+        ofLogVerbose() << "[ofxMol::LodMeshes] " << nb_atoms << " atoms in " << tiles.size() << " tiles of " << tile_size;
+    }
+    
+    void LodMeshes::clearLevels()
+    {
+        levels.clear();
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            tiles[t].level = NO_LEVEL;
+        }
+        far_changed = true;
+    }
+    
+    void LodMeshes::addLevel(int resolution, float min_pixels)
+    {
+        Level level;
+        level.resolution = resolution;
+        level.min_pixels = min_pixels;
+        level.triangles_per_sphere = SphereTemplate::get(resolution).mesh().getNumIndices() / 3;
+        level.changed = true;
+        level.triangles = 0;
+        level.spheres = 0;
+        level.tiles = 0;
+        // chooseLevel takes the first level reached: keep them by decreasing min_pixels
+        std::vector<Level>::iterator position = levels.begin();
+        while (position != levels.end() && position->min_pixels >= min_pixels)
+        {
+            ++position;
+        }
+        levels.insert(position, level);
+        
+        // the far level moved: build everything again
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            tiles[t].level = NO_LEVEL;
+        }
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            levels[l].changed = true;
+        }
+        far_changed = true;
+    }
+    
+    void LodMeshes::setFar(Far far)
+    {
+        if (far != this->far)
+        {
+            this->far = far;
+            far_changed = true;
+        }
+    }
+    
+    size_t LodMeshes::chooseLevel(float pixels) const
+    {
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            if (pixels >= levels[l].min_pixels)
+            {
+                return l;
+            }
+        }
+        return levels.size();
+    }
+    
+    bool LodMeshes::update(const ofCamera &camera, float viewport_height)
+    {
+        return update(camera.getGlobalPosition(), camera.getFov(), viewport_height);
+    }
+    
+    bool LodMeshes::update(const ofVec3f &eye, float fov, float viewport_height)
+    {
+        if (model == NULL)
+        {
+            return false;
+        }
+        
+        // pixels of a unit length at distance 1
+        const float scale = viewport_height / (2.0f * tanf(ofDegToRad(fov) / 2.0f));
+        
+        std::vector<size_t> previous(tiles.size());
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            Tile &tile = tiles[t];
+            previous[t] = tile.level;
+            
+            // distance to the closest point of the tile
+            ofVec3f closest;
+            for (int k=0; k<3; k++)
+            {
+                closest[k] = ofClamp(eye[k], tile.min[k], tile.max[k]);
+            }
+            tile.pixels = tile.radius * scale / std::max(eye.distance(closest), 1e-3f);
+            tile.level = chooseLevel(tile.pixels);
+        }
+        applyBudget();
+        
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            levels[l].tiles = 0;
+            levels[l].spheres = 0;
+        }
+        far_tiles = 0;
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            const Tile &tile = tiles[t];
+            if (tile.level != previous[t])
+            {
+                for (size_t k=0; k<2; k++)
+                {
+                    size_t level = k == 0 ? previous[t] : tile.level;
+                    if (level < levels.size())
+                    {
+                        levels[level].changed = true;
+                    }
+                    else if (level == levels.size())
+                    {
+                        far_changed = true;
+                    }
+                }
+            }
+            if (tile.level < levels.size())
+            {
+                levels[tile.level].tiles++;
+                levels[tile.level].spheres += tile.number_of_atoms;
+            }
+            else
+            {
+                far_tiles++;
+            }
+        }
+        
+        bool changed = far_changed;
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            levels[l].triangles = levels[l].spheres * levels[l].triangles_per_sphere;
+            if (levels[l].changed)
+            {
+                buildLevel(l);
+                changed = true;
+            }
+        }
+        if (far_changed)
+        {
+            buildFar();
+        }
+        return changed;
+    }
+    
+    size_t LodMeshes::chooseLevels(float factor)
+    {
+        // far coarse atoms are spheres too (see buildFar), far points have no triangles
+        size_t far_triangles_per_sphere = 0;
+        if (far == COARSE_ATOMS && model->number_of_coarse_atoms() != 0)
+        {
+            far_triangles_per_sphere = SphereTemplate::get(farResolution()).mesh().getNumIndices() / 3;
+        }
+        
+        size_t triangles = 0;
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            Tile &tile = tiles[t];
+            tile.level = chooseLevel(tile.pixels / factor);
+            if (tile.level < levels.size())
+            {
+                triangles += tile.number_of_atoms * levels[tile.level].triangles_per_sphere;
+            }
+            else
+            {
+                triangles += tile.number_of_coarse_atoms * far_triangles_per_sphere;
+            }
+        }
+        return triangles;
+    }
+    
+    void LodMeshes::applyBudget()
+    {
+        if (budget == 0 || chooseLevels(1.0f) <= budget)
+        {
+            return;
+        }
+        
+        // the triangles decrease with the factor: double it until they fit, then bisect
+        float low = 1.0f;
+        float high = 2.0f;
+        for (int i=0; i<64 && chooseLevels(high) > budget; i++)
+        {
+            low = high;
+            high *= 2.0f;
+        }
+        for (int i=0; i<20; i++)
+        {
+            float middle = (low + high) / 2.0f;
+            if (chooseLevels(middle) > budget)
+            {
+                low = middle;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        chooseLevels(high);
+    }
+    
+    void LodMeshes::buildLevel(size_t l)
+    {
+        Level &level = levels[l];
+        const AtomArrays &arrays = model->arrays();
+        
+        SphereInstances instances(level.resolution);
+        instances.reserve(level.spheres);
+        for (size_t t=0; t<tiles.size(); t++)
+        {
+            const Tile &tile = tiles[t];
+            if (tile.level != l)
+            {
+                continue;
+            }
+            for (size_t a=tile.first_atom; a<tile.first_atom+tile.number_of_atoms; a++)
+            {
+                unsigned int i = tile_atoms[a];
+                instances.add(arrays.position(i), arrays.radius[i], arrays.color[i]);
+            }
+        }
+        instances.expandIndexed(level.mesh, true);
+        level.changed = false;
+    }
+    
+    void LodMeshes::buildFar()
+    {
+        const size_t far_level = levels.size();
+        far_elements = 0;
+        far_triangles = 0;
+        
+        if (far == COARSE_ATOMS && model->number_of_coarse_atoms() != 0)
+        {
+            // coarse atoms at the coarsest resolution, colored as Model::coarseAtomsInstances
+            Model::Const_coarse_atoms_iterator coarse_atoms = static_cast<const Model*>(model)->coarse_atoms_begin();
+            SphereInstances instances(farResolution());
+            for (size_t t=0; t<tiles.size(); t++)
+            {
+                const Tile &tile = tiles[t];
+                if (tile.level != far_level)
+                {
+                    continue;
+                }
+                for (size_t c=tile.first_coarse_atom; c<tile.first_coarse_atom+tile.number_of_coarse_atoms; c++)
+                {
+                    const Coarse_Atom &atom = coarse_atoms[tile_coarse_atoms[c]];
+                    instances.add(atom.position(), atom.radius(), ofColor(atom.getColor()));
+                }
+            }
+            instances.expandIndexed(far_mesh, true);
+            far_mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+            far_elements = instances.size();
+            far_triangles = far_elements * (instances.sphere().mesh().getNumIndices() / 3);
+        }
+        else
+        {
+            const AtomArrays &arrays = model->arrays();
+            for (size_t t=0; t<tiles.size(); t++)
+            {
+                if (tiles[t].level == far_level)
+                {
+                    far_elements += tiles[t].number_of_atoms;
+                }
+            }
+            
+            MeshBuilder::Arrays points = MeshBuilder::resize(far_mesh, far_elements, false, true);
+            size_t v = 0;
+            for (size_t t=0; t<tiles.size(); t++)
+            {
+                const Tile &tile = tiles[t];
+                if (tile.level != far_level)
+                {
+                    continue;
+                }
+                for (size_t a=tile.first_atom; a<tile.first_atom+tile.number_of_atoms; a++, v++)
+                {
+                    unsigned int i = tile_atoms[a];
+                    points.vertices[v] = arrays.position(i);
+                    points.colors[v] = arrays.color[i];
+                }
+            }
+            far_mesh.setMode(OF_PRIMITIVE_POINTS);
+        }
+        far_changed = false;
+    }
+    
+    int LodMeshes::farResolution() const
+    {
+        return levels.empty() ? 6 : levels.back().resolution;
+    }
+    
+    size_t LodMeshes::getTotalTriangles() const
+    {
+        size_t triangles = far_triangles;
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            triangles += levels[l].triangles;
+        }
+        return triangles;
+    }
+    
+    void LodMeshes::draw()
+    {
+        for (size_t l=0; l<levels.size(); l++)
+        {
+            levels[l].mesh.draw();
+        }
+        far_mesh.draw();
+    }
+}
@@ -0,0 +1,188 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/MeshBinding.h"
+#include "ofxMol/Model.h"
+
+namespace OfxMol
+{
+    namespace
+    {
+        // Vertices of a slice of the updates: enough for the threads to be worth starting
+        const size_t MIN_VERTICES_PER_SLICE = 65536;
+        
+        // Spheres of the generator of type, as built by Model
+        SphereInstances instancesOf(Model &model, MeshTask::Type type, int resolution, float radius, const ofColor &color)
+        {
+            switch (type)
+            {
+                case MeshTask::ATOMS_WITH_RADIUS:
+                    return model.atomsInstances(radius, resolution);
+                case MeshTask::COARSE_ATOMS:
+                    return model.coarseAtomsInstances(resolution);
+                case MeshTask::COARSE_ATOMS_WITH_COLOR:
+                    return model.coarseAtomsInstances(color, resolution);
+                default:
+                    return model.atomsInstances(resolution);
+            }
+        }
+    }
+    
+    //! Rewrites the spheres whose position changed, counting them by slice
+    class MeshBinding::UpdateJob : public MeshBuilder::Job
+    {
+    public:
+        UpdateJob(MeshBinding &binding, size_t first, size_t slices) :
+            binding(binding), first(first), arrays(binding.model->arrays()), coarse(binding.model->coarse_atoms_begin()),
+            vertices(&binding.mesh.getVertices()[0]), moved(slices, 0)
+        {
+        }
+        
+        void run(size_t slice, size_t begin, size_t end)
+        {
+            const bool coarse_atoms = binding.type == MeshTask::COARSE_ATOMS || binding.type == MeshTask::COARSE_ATOMS_WITH_COLOR;
+            const std::vector<ofVec3f> *unit = binding.unit;
+            
+            for (size_t i=first+begin; i<first+end; i++)
+            {
+                const ofVec3f position = coarse_atoms ? coarse[i].position() : arrays.position(i);
+                SphereInstance &sphere = binding.spheres[i];
+                if (position == sphere.position)
+                {
+                    continue;
+                }
+                sphere.position = position;
+                moved[slice]++;
+                
+                if (unit == NULL)
+                {
+                    vertices[i] = position;
+                    continue;
+                }
+                // same vertices as SphereInstances::expand and expandIndexed
+                ofVec3f *v = vertices + i * unit->size();
+                for (size_t k=0; k<unit->size(); k++)
+                {
+                    v[k] = (*unit)[k] * sphere.radius + position;
+                }
+            }
+        }
+        
+        size_t total() const
+        {
+            size_t n = 0;
+            for (size_t s=0; s<moved.size(); s++)
+            {
+                n += moved[s];
+            }
+            return n;
+        }
+        
+    protected:
+        MeshBinding &binding;
+        size_t first;
+        const AtomArrays &arrays;
+        Model::Coarse_atoms_iterator coarse;
+        ofVec3f *vertices;
+        std::vector<size_t> moved;
+    };
+    
+    MeshBinding::MeshBinding(Model *model, MeshTask::Type type, int resolution, float radius, ofColor color, bool indexed) :
+        model(model), type(type), resolution(resolution), radius(radius), color(color), indexed(indexed), unit(NULL)
+    {
+        bind();
+    }
+    
+    size_t MeshBinding::update(const MeshBuilder &builder)
+    {
+        return update(0, spheres.size(), builder);
+    }
+    
+    size_t MeshBinding::update(size_t first, size_t count, const MeshBuilder &builder)
+    {
+        const bool coarse_atoms = type == MeshTask::COARSE_ATOMS || type == MeshTask::COARSE_ATOMS_WITH_COLOR;
+        const size_t model_size = coarse_atoms ? model->number_of_coarse_atoms() : model->arrays().size();
+        if (model_size != spheres.size())
+        {
+            ofLogNotice() << "[ofxMol::MeshBinding] Number of atoms changed: building the mesh again";
+            bind();
+            return spheres.size();
+        }
+        
+        first = std::min(first, spheres.size());
+        count = std::min(count, spheres.size() - first);
+        if (count == 0)
+        {
+            return 0;
+        }
+        
+        const size_t min_slice = std::max(MIN_VERTICES_PER_SLICE / getVerticesPerSphere(), size_t(1));
+        UpdateJob job(*this, first, builder.numSlices(count, min_slice));
+        builder.run(job, count, min_slice);
+        return job.total();
+    }
+    
+    void MeshBinding::bind()
+    {
+        if (type == MeshTask::POINT_CLOUD)
+        {
+            mesh = model->atomsPointCloud();
+            unit = NULL;
+            
+            const AtomArrays &arrays = model->arrays();
+            spheres.resize(arrays.size());
+            for (size_t i=0; i<arrays.size(); i++)
+            {
+                spheres[i].position = arrays.position(i);
+                spheres[i].radius = 0.0f;
+                spheres[i].color = arrays.color[i];
+            }
+            return;
+        }
+        
+        // atom meshes have no colors, as the generators of Model
+        const bool with_colors = type == MeshTask::COARSE_ATOMS || type == MeshTask::COARSE_ATOMS_WITH_COLOR;
+        SphereInstances instances = instancesOf(*model, type, resolution, radius, color);
+        if (indexed)
+        {
+            instances.expandIndexed(mesh, with_colors);
+            unit = &instances.sphere().mesh().getVertices();
+        }
+        else
+        {
+            instances.expand(mesh, with_colors);
+            unit = &instances.sphere().faceNormals();
+        }
+        spheres = instances.instances();
+    }
+}
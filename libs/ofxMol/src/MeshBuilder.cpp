@@ -0,0 +1,284 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/MeshBuilder.h"
+
+#include <deque>
+#include "Poco/Condition.h"
+
+#ifdef TARGET_WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace OfxMol
+{
+    // Worker threads of a builder, fed through a queue of slices
+    class MeshBuilder::Workers
+    {
+    public:
+        // Slices of a run() not done yet
+        struct Batch
+        {
+            size_t remaining;
+        };
+        
+        struct Slice
+        {
+            Job *job;
+            size_t slice;
+            size_t begin;
+            size_t end;
+            Batch *batch;
+        };
+        
+        Workers(size_t size) :
+            size(size), stopping(false)
+        {
+        }
+        
+        ~Workers()
+        {
+            {
+                ofScopedLock lock(mutex);
+                stopping = true;
+                work.broadcast();
+            }
+            for (size_t i=0; i<threads.size(); i++)
+            {
+                threads[i]->waitForThread(false);
+            }
+        }
+        
+        void run(Job &job, size_t n, size_t slices)
+        {
+            Batch batch;
+            batch.remaining = slices - 1;
+            
+            {
+                ofScopedLock lock(mutex);
+                // started by the first run, so that no thread is started before main
+                while (threads.size() < size)
+                {
+                    threads.push_back(ofPtr<Worker>(new Worker(*this)));
+                    threads.back()->startThread(true, false);
+                }
+                
+                // slice s is [s * n / slices, (s + 1) * n / slices)
+                for (size_t s=1; s<slices; s++)
+                {
+                    Slice slice = {&job, s, s * n / slices, (s + 1) * n / slices, &batch};
+                    queue.push_back(slice);
+                }
+                work.broadcast();
+            }
+            
+            job.run(0, 0, n / slices);
+            
+            // run the slices the workers have not taken yet, then wait for the others
+            mutex.lock();
+            while (batch.remaining > 0)
+            {
+                std::deque<Slice>::iterator it = queue.begin();
+                while (it != queue.end() && it->batch != &batch)
+                {
+                    ++it;
+                }
+                if (it == queue.end())
+                {
+                    done.wait(mutex);
+                    continue;
+                }
+                Slice slice = *it;
+                queue.erase(it);
+                mutex.unlock();
+                execute(slice);
+                mutex.lock();
+            }
+            mutex.unlock();
+        }
+        
+        // run by each worker until the workers stop
+        void loop()
+        {
+            mutex.lock();
+            while (true)
+            {
+                while (queue.empty() && !stopping)
+                {
+                    work.wait(mutex);
+                }
+                if (stopping)
+                {
+                    break;
+                }
+                Slice slice = queue.front();
+                queue.pop_front();
+                mutex.unlock();
+                execute(slice);
+                mutex.lock();
+            }
+            mutex.unlock();
+        }
+        
+    protected:
+        class Worker : public ofThread
+        {
+        public:
+            Worker(Workers &workers) :
+                workers(workers)
+            {
+            }
+            
+        protected:
+            void threadedFunction()
+            {
+                workers.loop();
+            }
+            
+            Workers &workers;
+        };
+        
+        // run a slice without the lock, then count it done
+        void execute(const Slice &slice)
+        {
+            slice.job->run(slice.slice, slice.begin, slice.end);
+            
+            ofScopedLock lock(mutex);
+            if (--slice.batch->remaining == 0)
+            {
+                done.broadcast();
+            }
+        }
+        
+        size_t size;
+        std::vector<ofPtr<Worker> > threads;
+        std::deque<Slice> queue;
+        bool stopping;
+        ofMutex mutex;
+        Poco::Condition work; // a slice is queued, or the workers stop
+        Poco::Condition done; // a batch is done
+    };
+    
+    namespace
+    {
+        // Build the shared builder before main, so that mesh threads never race on it
+        MeshBuilder &shared_builder = MeshBuilder::shared();
+    }
+    
+    MeshBuilder::Arrays MeshBuilder::resize(ofMesh &mesh, size_t nb_vertices, bool with_normals, bool with_colors, size_t nb_indices)
+    {
+        mesh.clear();
+        Arrays arrays;
+        arrays.vertices = NULL;
+        arrays.normals = NULL;
+        arrays.colors = NULL;
+        arrays.indices = NULL;
+        
+        if (with_colors)
+        {
+            mesh.enableColors();
+        }
+        if (nb_vertices != 0)
+        {
+            mesh.getVertices().resize(nb_vertices);
+            arrays.vertices = &mesh.getVertices()[0];
+            if (with_normals)
+            {
+                mesh.getNormals().resize(nb_vertices);
+                arrays.normals = &mesh.getNormals()[0];
+            }
+            if (with_colors)
+            {
+                mesh.getColors().resize(nb_vertices);
+                arrays.colors = &mesh.getColors()[0];
+            }
+        }
+        if (nb_indices != 0)
+        {
+            mesh.getIndices().resize(nb_indices);
+            arrays.indices = &mesh.getIndices()[0];
+        }
+        return arrays;
+    }
+    
+    MeshBuilder::MeshBuilder(unsigned int threads)
+    {
+        setNumThreads(threads);
+    }
+    
+    void MeshBuilder::setNumThreads(unsigned int threads)
+    {
+        this->threads = threads == 0 ? hardwareThreads() : threads;
+        // the previous workers stop once the runs holding them are done
+        workers = ofPtr<Workers>(new Workers(this->threads - 1));
+    }
+    
+    size_t MeshBuilder::numSlices(size_t n, size_t min_slice) const
+    {
+        size_t slices = n / std::max(min_slice, size_t(1));
+        return std::max(std::min(slices, size_t(threads)), size_t(1));
+    }
+    
+    void MeshBuilder::run(Job &job, size_t n, size_t min_slice) const
+    {
+        const size_t slices = numSlices(n, min_slice);
+        if (slices == 1)
+        {
+            job.run(0, 0, n);
+            return;
+        }
+        
+        ofPtr<Workers> pool = workers;
+        pool->run(job, n, slices);
+    }
+    
+    unsigned int MeshBuilder::hardwareThreads()
+    {
+#ifdef TARGET_WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        long n = info.dwNumberOfProcessors;
+#else
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        return n > 0 ? static_cast<unsigned int>(n) : 1;
+    }
+    
+    MeshBuilder &MeshBuilder::shared()
+    {
+        static MeshBuilder builder;
+        return builder;
+    }
+}
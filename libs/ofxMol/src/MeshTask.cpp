@@ -0,0 +1,134 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/MeshTask.h"
+#include "ofxMol/Model.h"
+
+namespace OfxMol
+{
+    MeshTask::MeshTask(Model *model, Type type, int resolution, float radius, ofColor color, bool indexed) :
+        model(model), type(type), resolution(resolution), radius(radius), color(color), indexed(indexed), done(false), published(false)
+    {
+    }
+    
+    MeshTask::~MeshTask()
+    {
+        waitForThread(true);
+    }
+    
+    bool MeshTask::isDone()
+    {
+        ofScopedLock lock(mutex);
+        return done;
+    }
+    
+    bool MeshTask::publish(ofMesh &target)
+    {
+        ofScopedLock lock(mutex);
+        if (!done || published)
+        {
+            return false;
+        }
+        
+        target.setMode(mesh.getMode());
+        target.getVertices().swap(mesh.getVertices());
+        target.getNormals().swap(mesh.getNormals());
+        target.getColors().swap(mesh.getColors());
+        target.getTexCoords().swap(mesh.getTexCoords());
+        target.getIndices().swap(mesh.getIndices());
+        if (mesh.usingColors())
+        {
+            target.enableColors();
+        }
+        else
+        {
+            target.disableColors();
+        }
+        if (mesh.usingNormals())
+        {
+            target.enableNormals();
+        }
+        else
+        {
+            target.disableNormals();
+        }
+        if (mesh.usingTextures())
+        {
+            target.enableTextures();
+        }
+        else
+        {
+            target.disableTextures();
+        }
+        if (mesh.usingIndices())
+        {
+            target.enableIndices();
+        }
+        else
+        {
+            target.disableIndices();
+        }
+        // the previous arrays of target
+        mesh.clear();
+        published = true;
+        return true;
+    }
+    
+    void MeshTask::threadedFunction()
+    {
+        // mesh is only read by publish once done is set
+        switch (type)
+        {
+            case ATOMS:
+                mesh = model->atomsMesh(resolution, indexed);
+                break;
+            case ATOMS_WITH_RADIUS:
+                mesh = model->atomsMesh(radius, resolution, indexed);
+                break;
+            case COARSE_ATOMS:
+                mesh = model->coarseAtomsMesh(resolution, indexed);
+                break;
+            case COARSE_ATOMS_WITH_COLOR:
+                mesh = model->coarseAtomsMesh(color, resolution, indexed);
+                break;
+            case POINT_CLOUD:
+                mesh = model->atomsPointCloud();
+                break;
+            default:
+                break;
+        }
+        
+        ofScopedLock lock(mutex);
+        done = true;
+    }
+}
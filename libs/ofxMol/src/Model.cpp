@@ -32,8 +32,145 @@
 
 #include "ofxMol/Model.h"
 
+#include <ESBTL/streaming_builder.h>
+#ifdef OFXMOL_COMPRESSED_PDB
+#include <ESBTL/compressed_ifstream.h>
+#endif
+
 namespace OfxMol
 {
+    typedef ESBTL::Coarse_atoms_iterators<ESBTL::Default_system_with_coarse_grain::Model>::iterator OfxMol_Coarse_atoms_iterator;
+    
+    namespace
+    {
+        typedef ESBTL::Color_of_atom<ESBTL::Default_system_with_coarse_grain::Residue::Atom> OfxMol_Atom_color;
+        
+        //! Point cloud of the atoms of the first model streamed (atoms of the first system)
+        class Point_cloud_visitor
+        {
+        public:
+            Point_cloud_visitor(ofMesh &mesh) : mesh(mesh), model_number(0), started(false) {}
+            
+            void operator()(const std::vector<ESBTL::Streamed_atom> &batch)
+            {
+                for (std::vector<ESBTL::Streamed_atom>::const_iterator it = batch.begin(); it != batch.end(); ++it)
+                {
+                    if (it->system_index != 1)
+                    {
+                        continue;
+                    }
+                    if (!started)
+                    {
+                        model_number = it->model_number;
+                        started = true;
+                    }
+                    else if (it->model_number != model_number)
+                    {
+                        continue;
+                    }
+                    mesh.addColor(color(it->residue_name));
+                    mesh.addVertex(ofVec3f(it->x, it->y, it->z));
+                }
+            }
+            
+        private:
+            //! same color as Atom
+            ofFloatColor color(const ESBTL::Name &residue_name)
+            {
+                const float *rgb = OfxMol_Atom_color::rgb_of_residue(residue_name);
+                return ofFloatColor(rgb[0], rgb[1], rgb[2]);
+            }
+            
+            ofMesh &mesh;
+            int model_number;
+            bool started;
+        };
+        
+        template <class Line_selector>
+        bool streamPDB(const std::string &path, Line_selector &sel, Point_cloud_visitor &visitor)
+        {
+            typedef ESBTL::Accept_all_occupancy_policy<ESBTL::PDB::Line_format<> > Accept_all_occupancy_policy;
+#ifdef OFXMOL_COMPRESSED_PDB
+            return ESBTL::stream_a_pdb_file<ESBTL::AUTO>(path, sel, visitor, Accept_all_occupancy_policy());
+#else
+            if (ESBTL::detect_reading_mode(path) != ESBTL::MMAP)
+            {
+                ofLogError() << "[ofxMol::Model] Compressed file: " << path << " (define OFXMOL_COMPRESSED_PDB to read compressed files)";
+                return false;
+            }
+            return ESBTL::stream_a_pdb_file<ESBTL::MMAP>(path, sel, visitor, Accept_all_occupancy_policy());
+#endif
+        }
+        
+        // Slices of atoms of the jobs: enough for the threads to be worth starting
+        const size_t MIN_ATOMS_PER_SLICE = 4096;
+        
+        //! Positions of the atoms in the vertices of a point cloud
+        class Point_cloud_job : public MeshBuilder::Job
+        {
+        public:
+            Point_cloud_job(const AtomArrays &arrays, ofVec3f *vertices) : arrays(arrays), vertices(vertices) {}
+            
+            void run(size_t /*slice*/, size_t begin, size_t end)
+            {
+                for (size_t i=begin; i<end; i++)
+                {
+                    vertices[i] = arrays.position(i);
+                }
+            }
+            
+        protected:
+            const AtomArrays &arrays;
+            ofVec3f *vertices;
+        };
+        
+        //! Positions of the backbone atoms: the first pass counts them by slice, the second one copies them
+        //! after the atoms of the previous slices
+        class Backbone_job : public MeshBuilder::Job
+        {
+        public:
+            Backbone_job(const AtomArrays &arrays, size_t slices) : arrays(arrays), counts(slices, 0) {}
+            
+            void run(size_t slice, size_t begin, size_t end)
+            {
+                if (points.empty())
+                {
+                    for (size_t i=begin; i<end; i++)
+                    {
+                        counts[slice] += (arrays.flags[i] & AtomArrays::BACKBONE) != 0;
+                    }
+                    return;
+                }
+                
+                size_t v = counts[slice];
+                for (size_t i=begin; i<end; i++)
+                {
+                    if (arrays.flags[i] & AtomArrays::BACKBONE)
+                    {
+                        points[v++] = arrays.position(i);
+                    }
+                }
+            }
+            
+            //! After the first pass, size the points and turn the counts into the first point of each slice
+            void allocate()
+            {
+                size_t total = 0;
+                for (size_t s=0; s<counts.size(); s++)
+                {
+                    size_t count = counts[s];
+                    counts[s] = total;
+                    total += count;
+                }
+                points.resize(total);
+            }
+            
+            const AtomArrays &arrays;
+            std::vector<size_t> counts;
+            std::vector<ofPoint> points;
+        };
+    }
+    
     Model::Model(): _model_number(0)
     {
         atoms.clear();
@@ -46,22 +183,145 @@ namespace OfxMol
         coarse_atoms.clear();
     }
     
+    Model::Model(ESBTL::Default_system_with_coarse_grain::Model &model, bool with_coarse_atoms) : _model_number(model.model_number())
+    {
+        build(model, with_coarse_atoms);
+    }
+    
     Model::~Model()
     {
         atoms.clear();
+        atom_arrays.clear();
         coarse_atoms.clear();
     }
     
-    void Model::add_atom(OfxMol::Atom &atom)
+    void Model::build(ESBTL::Default_system_with_coarse_grain::Model &model, bool with_coarse_atoms)
+    {
+        _model_number = model.model_number();
+        size_t nb_coarse_atoms = 0;
+        bool copy_index = atoms.empty() && model.index().number_of_atoms() == model.number_of_atoms();
+        
+        if (with_coarse_atoms)
+        {
+            /*
+             * Creator of a coarse grain model creating up to two pseudo-atoms:
+             * one as the barycenter of backbone atoms (if relevant) and one as the barycenter
+             * of non-barycenter atoms.
+             * Backbone atoms are identified using the global function ESBTL::is_backbone.
+             */
+            ESBTL::Coarse_creator_two_barycenters<ESBTL::Default_system_with_coarse_grain::Residue> creator;
+            for (ESBTL::Default_system_with_coarse_grain::Model::Residues_iterator it_res=model.residues_begin(); it_res!=model.residues_end(); ++it_res)
+            {
+                nb_coarse_atoms += it_res->create_coarse_atoms(creator);
+            }
+        }
+        
+        reserve(atoms.size() + model.number_of_atoms(), coarse_atoms.size() + nb_coarse_atoms);
+        
+        for (ESBTL::Default_system_with_coarse_grain::Model::Atoms_iterator it_atm=model.atoms_begin(); it_atm!=model.atoms_end(); ++it_atm)
+        {
+            emplace_atom(*it_atm);
+        }
+        
+        // index built by ESBTL when the systems were created, its ranks are the positions of the atoms
+        if (copy_index)
+        {
+            atom_index = model.index();
+        }
+        else
+        {
+            updateIndex();
+        }
+        
+        if (with_coarse_atoms)
+        {
+            for (OfxMol_Coarse_atoms_iterator itc=ESBTL::coarse_atoms_begin(model); itc!=ESBTL::coarse_atoms_end(model); ++itc)
+            {
+                emplace_coarse_atom(*itc);
+            }
+        }
+    }
+    
+    void Model::reserve(size_t nb_atoms, size_t nb_coarse_atoms)
+    {
+        atoms.reserve(nb_atoms);
+        atom_arrays.reserve(nb_atoms);
+        coarse_atoms.reserve(nb_coarse_atoms);
+    }
+    
+    void Model::add_atom(const OfxMol::Atom &atom)
     {
         atoms.push_back(atom);
+        atom_arrays.push_back(atom);
+    }
+    
+    OfxMol::Atom &Model::emplace_atom(const ESBTL::Default_system_with_coarse_grain::Atom &eatom)
+    {
+        atoms.resize(atoms.size() + 1);
+        atoms.back().set(eatom);
+        atom_arrays.push_back(atoms.back());
+        return atoms.back();
+    }
+    
+    void Model::setAtomPosition(unsigned int i, const ofVec3f &position)
+    {
+        atoms[i].setPosition(position);
+        atom_arrays.setPosition(i, position);
     }
     
-    void Model::add_coarse_atom(OfxMol::Coarse_Atom &atom)
+    void Model::setAtomColor(unsigned int i, const ofFloatColor &color)
+    {
+        atoms[i].setColor(color);
+        atom_arrays.color[i] = color;
+    }
+    
+    void Model::updateArrays()
+    {
+        atom_arrays.clear();
+        atom_arrays.reserve(atoms.size());
+        for (Const_atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        {
+            atom_arrays.push_back(*atm);
+        }
+    }
+    
+    void Model::updateIndex()
+    {
+        atom_index.clear();
+        for (Const_atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        {
+            if (atm==atoms_begin() || atm->chain_identifier() != (atm-1)->chain_identifier() ||
+                atm->residue_sequence_number() != (atm-1)->residue_sequence_number() ||
+                atm->insertion_code() != (atm-1)->insertion_code())
+            {
+                atom_index.add_residue(atm->chain_identifier(), atm->residue_sequence_number(), atm->insertion_code());
+            }
+            atom_index.add_atom(atm->atom_serial_number());
+        }
+        atom_index.build();
+    }
+    
+    bool Model::findResidueAtoms(char chain, int resSeq, char iCode, unsigned int &first, unsigned int &count) const
+    {
+        int residue = atom_index.find_residue(chain, resSeq, iCode);
+        if (residue == -1) return false;
+        first = atom_index.first_atom_of_residue(residue);
+        count = atom_index.number_of_atoms_of_residue(residue);
+        return true;
+    }
+    
+    void Model::add_coarse_atom(const OfxMol::Coarse_Atom &atom)
     {
         coarse_atoms.push_back(atom);
     }
     
+    OfxMol::Coarse_Atom &Model::emplace_coarse_atom(const ESBTL::Default_system_with_coarse_grain::Residue::Coarse_atom &eatom)
+    {
+        coarse_atoms.resize(coarse_atoms.size() + 1);
+        coarse_atoms.back().set(eatom);
+        return coarse_atoms.back();
+    }
+    
     std::string Model::log()
     {
         std::string msg = "Model number: " + ofToString( model_number()) + "\n";
@@ -75,130 +335,214 @@ namespace OfxMol
     {
         ofPolyline line;
         
-        for (Const_atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        const MeshBuilder &builder = MeshBuilder::shared();
+        Backbone_job job(atom_arrays, builder.numSlices(atom_arrays.size(), MIN_ATOMS_PER_SLICE));
+        builder.run(job, atom_arrays.size(), MIN_ATOMS_PER_SLICE);
+        job.allocate();
+        if (!job.points.empty())
         {
-            if (atm->is_backbone())
-            {
-                line.addVertex(atm->position());
-            }
+            builder.run(job, atom_arrays.size(), MIN_ATOMS_PER_SLICE);
+            line.addVertices(job.points);
         }
         
         return line;
     }
     
-    ofMesh Model::coarseAtomsMesh(int resolution)
+    SphereInstances Model::coarseAtomsInstances(int resolution)
     {
-        ofMesh mesh;
-        mesh.clear();
-        mesh.enableColors();
+        SphereInstances instances(resolution);
+        instances.reserve(coarse_atoms.size());
         
         for (Coarse_atoms_iterator atm=coarse_atoms_begin(); atm!=coarse_atoms_end(); ++atm)
         {
-            ofSpherePrimitive sphere = atm->sphere(resolution);
-            vector<ofMeshFace> triangles = sphere.getMesh().getUniqueFaces();
-            updateMesh(mesh, triangles, atm->position(),atm->getColor());
+            // coarse atom meshes have always used 8 bits colors
+            instances.add(atm->position(), atm->radius(), ofColor(atm->getColor()));
         }
-
-        return mesh;
+        return instances;
     }
     
-    ofMesh Model::coarseAtomsMesh(ofColor color, int resolution)
+    SphereInstances Model::coarseAtomsInstances(ofColor color, int resolution)
     {
-        ofMesh mesh;
-        mesh.clear();
-        mesh.enableColors();
+        SphereInstances instances(resolution);
+        instances.reserve(coarse_atoms.size());
         
         for (Coarse_atoms_iterator atm=coarse_atoms_begin(); atm!=coarse_atoms_end(); ++atm)
         {
-            ofSpherePrimitive sphere = atm->sphere(resolution);
-            vector<ofMeshFace> triangles = sphere.getMesh().getUniqueFaces();
-            updateMesh(mesh, triangles, atm->position(), color);
+            instances.add(atm->position(), atm->radius(), color);
         }
-        
-        return mesh;
+        return instances;
     }
     
-    //! Create a sphere for each atom in the system.
-    //! Radius: given that default radius id 1.8 (check ESBTL code)
-    //! I have 2 methods: atomsMesh with no radius arg use atom radius.
-    //! The method with radius arg override arom radius.
-    ofMesh Model::atomsMesh(int resolution)
+    SphereInstances Model::atomsInstances(int resolution)
     {
-        ofMesh mesh;
-        mesh.clear();
+        SphereInstances instances(resolution);
+        instances.reserve(atom_arrays.size());
         
-        for (Atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        for (size_t i=0; i<atom_arrays.size(); i++)
         {
-            ofSpherePrimitive sphere = atm->sphere(resolution);
-            vector<ofMeshFace> triangles = sphere.getMesh().getUniqueFaces();
-            updateMesh(mesh, triangles, atm->position());
+            instances.add(atom_arrays.position(i), atom_arrays.radius[i], atom_arrays.color[i]);
         }
-        return mesh;
+        return instances;
     }
     
-    // ! method for mesh gen with an arbitrary radius for all atoms
-    ofMesh Model::atomsMesh(float radius, int resolution)
+    SphereInstances Model::atomsInstances(float radius, int resolution)
     {
-        ofMesh mesh;
-        mesh.clear();
+        SphereInstances instances(resolution);
+        instances.reserve(atom_arrays.size());
         
-        for (Atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        for (size_t i=0; i<atom_arrays.size(); i++)
         {
-            ofSpherePrimitive sphere = atm->sphere(radius, resolution);
-            vector<ofMeshFace> triangles = sphere.getMesh().getUniqueFaces();
-            updateMesh(mesh, triangles, atm->position());
+            instances.add(atom_arrays.position(i), radius, atom_arrays.color[i]);
         }
-        return mesh;
+        return instances;
     }
     
-    void Model::updateMesh(ofMesh& mesh, const vector<ofMeshFace> &triangles,  const ofVec3f position)
+    //! Spheres of the instances in a mesh, with shared vertices if indexed
+    static void expandInstances(const SphereInstances &instances, ofMesh &mesh, bool with_colors, bool indexed)
     {
-        for (int j=0; j<triangles.size(); j++)
+        if (indexed)
         {
-            ofMeshFace face = triangles[j];
-            mesh.addVertex(face.getVertex(0) + position);
-            mesh.addNormal(face.getNormal(0));
-            mesh.addVertex(face.getVertex(1) + position);
-            mesh.addNormal(face.getNormal(1));
-            mesh.addVertex(face.getVertex(2) + position);
-            mesh.addNormal(face.getNormal(2));
+            instances.expandIndexed(mesh, with_colors);
+        }
+        else
+        {
+            instances.expand(mesh, with_colors);
         }
     }
     
-    void Model::updateMesh(ofMesh& mesh, const vector<ofMeshFace> &triangles,  const ofVec3f position, const ofColor color)
+    ofMesh Model::coarseAtomsMesh(int resolution, bool indexed)
     {
-        for (int j=0; j<triangles.size(); j++)
-        {
-            ofMeshFace face = triangles[j];
-            
-            mesh.addVertex(face.getVertex(0) + position);
-            mesh.addNormal(face.getNormal(0));
-            mesh.addColor(color);
-            
-            mesh.addVertex(face.getVertex(1) + position);
-            mesh.addNormal(face.getNormal(1));
-            mesh.addColor(color);
-            
-            mesh.addVertex(face.getVertex(2) + position);
-            mesh.addNormal(face.getNormal(2));
-            mesh.addColor(color);
-        }
+        ofMesh mesh;
+        expandInstances(coarseAtomsInstances(resolution), mesh, true, indexed);
+        return mesh;
+    }
+    
+    ofMesh Model::coarseAtomsMesh(ofColor color, int resolution, bool indexed)
+    {
+        ofMesh mesh;
+        expandInstances(coarseAtomsInstances(color, resolution), mesh, true, indexed);
+        return mesh;
+    }
+    
+    //! Create a sphere for each atom in the system.
+    //! Radius: given that default radius id 1.8 (check ESBTL code)
+    //! I have 2 methods: atomsMesh with no radius arg use atom radius.
+    //! The method with radius arg override arom radius.
+    //! Spheres are copies of one SphereTemplate per resolution, expanded without colors.
+    ofMesh Model::atomsMesh(int resolution, bool indexed)
+    {
+        ofMesh mesh;
+        expandInstances(atomsInstances(resolution), mesh, false, indexed);
+        return mesh;
+    }
+    
+    // ! method for mesh gen with an arbitrary radius for all atoms
+    ofMesh Model::atomsMesh(float radius, int resolution, bool indexed)
+    {
+        ofMesh mesh;
+        expandInstances(atomsInstances(radius, resolution), mesh, false, indexed);
+        return mesh;
     }
 
     //! create a point cloud using atoms and atoms colors
     ofMesh Model::atomsPointCloud()
+    {
+        ofMesh mesh;
+        
+        // colors are contiguous: copy them at once, and the positions by slices
+        MeshBuilder::Arrays arrays = MeshBuilder::resize(mesh, atom_arrays.size(), false, true);
+        std::copy(atom_arrays.color.begin(), atom_arrays.color.end(), arrays.colors);
+        
+        Point_cloud_job job(atom_arrays, arrays.vertices);
+        MeshBuilder::shared().run(job, atom_arrays.size(), MIN_ATOMS_PER_SLICE);
+        
+        return mesh;
+    }
+    
+    ofMesh Model::atomsPointCloud(const std::string &path, bool advanced)
     {
         ofMesh mesh;
         mesh.enableColors();
         
-        for (Const_atoms_iterator atm=atoms_begin(); atm!=atoms_end(); ++atm)
+        Point_cloud_visitor visitor(mesh);
+        bool ok;
+        if (advanced)
         {
-            mesh.addColor(atm->getColor());
-            mesh.addVertex(atm->position());
+            ESBTL::PDB_line_selector_two_systems sel;
+            ok = streamPDB(path, sel, visitor);
+        }
+        else
+        {
+            ESBTL::PDB_line_selector sel;
+            ok = streamPDB(path, sel, visitor);
         }
         
+        if (!ok)
+        {
+            ofLogError() << "[ofxMol::Model] Can not read file: " << path;
+        }
         return mesh;
     }
+    
+    ofPtr<MeshTask> Model::atomsPointCloudAsync()
+    {
+        ofPtr<MeshTask> task(new MeshTask(this, MeshTask::POINT_CLOUD));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    ofPtr<MeshTask> Model::atomsMeshAsync(int resolution, bool indexed)
+    {
+        ofPtr<MeshTask> task(new MeshTask(this, MeshTask::ATOMS, resolution, 1.0f, ofColor(255, 255, 255), indexed));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    ofPtr<MeshTask> Model::atomsMeshAsync(float radius, int resolution, bool indexed)
+    {
+        ofPtr<MeshTask> task(new MeshTask(this, MeshTask::ATOMS_WITH_RADIUS, resolution, radius, ofColor(255, 255, 255), indexed));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    ofPtr<MeshTask> Model::coarseAtomsMeshAsync(ofColor color, int resolution, bool indexed)
+    {
+        ofPtr<MeshTask> task(new MeshTask(this, MeshTask::COARSE_ATOMS_WITH_COLOR, resolution, 1.0f, color, indexed));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    ofPtr<MeshTask> Model::coarseAtomsMeshAsync(int resolution, bool indexed)
+    {
+        ofPtr<MeshTask> task(new MeshTask(this, MeshTask::COARSE_ATOMS, resolution, 1.0f, ofColor(255, 255, 255), indexed));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    ofPtr<MeshBinding> Model::atomsPointCloudBinding()
+    {
+        return ofPtr<MeshBinding>(new MeshBinding(this, MeshTask::POINT_CLOUD));
+    }
+    
+    ofPtr<MeshBinding> Model::atomsMeshBinding(int resolution, bool indexed)
+    {
+        return ofPtr<MeshBinding>(new MeshBinding(this, MeshTask::ATOMS, resolution, 1.0f, ofColor(255, 255, 255), indexed));
+    }
+    
+    ofPtr<MeshBinding> Model::atomsMeshBinding(float radius, int resolution, bool indexed)
+    {
+        return ofPtr<MeshBinding>(new MeshBinding(this, MeshTask::ATOMS_WITH_RADIUS, resolution, radius, ofColor(255, 255, 255), indexed));
+    }
+    
+    ofPtr<MeshBinding> Model::coarseAtomsMeshBinding(ofColor color, int resolution, bool indexed)
+    {
+        return ofPtr<MeshBinding>(new MeshBinding(this, MeshTask::COARSE_ATOMS_WITH_COLOR, resolution, 1.0f, color, indexed));
+    }
+    
+    ofPtr<MeshBinding> Model::coarseAtomsMeshBinding(int resolution, bool indexed)
+    {
+        return ofPtr<MeshBinding>(new MeshBinding(this, MeshTask::COARSE_ATOMS, resolution, 1.0f, ofColor(255, 255, 255), indexed));
+    }
 }
 
 
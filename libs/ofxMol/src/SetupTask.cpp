@@ -0,0 +1,123 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/SetupTask.h"
+
+namespace OfxMol
+{
+    SetupTask::SetupTask(std::string path, SetupMode mode, bool useCache) :
+        path(path), mode(mode), useCache(useCache), cancelled(false), done(false), published(false)
+    {
+    }
+    
+    SetupTask::~SetupTask()
+    {
+        cancel();
+        waitForThread(true);
+    }
+    
+    SetupProgress SetupTask::getProgress()
+    {
+        ofScopedLock lock(mutex);
+        return progress;
+    }
+    
+    void SetupTask::cancel()
+    {
+        ofScopedLock lock(mutex);
+        cancelled = true;
+    }
+    
+    bool SetupTask::isCancelled()
+    {
+        ofScopedLock lock(mutex);
+        return cancelled;
+    }
+    
+    bool SetupTask::isDone()
+    {
+        ofScopedLock lock(mutex);
+        return done;
+    }
+    
+    bool SetupTask::succeeded()
+    {
+        ofScopedLock lock(mutex);
+        return hasSucceeded();
+    }
+    
+    bool SetupTask::hasSucceeded() const
+    {
+        return done && !cancelled && !published && system.number_of_models() > 0;
+    }
+    
+    bool SetupTask::publish(System &target)
+    {
+        ofScopedLock lock(mutex);
+        if (!hasSucceeded())
+        {
+            return false;
+        }
+        
+        target.swap(system);
+        published = true;
+        return true;
+    }
+    
+    void SetupTask::addBytes(size_t bytes)
+    {
+        ofScopedLock lock(mutex);
+        progress.bytes_parsed += bytes;
+    }
+    
+    void SetupTask::setTotalBytes(size_t bytes)
+    {
+        ofScopedLock lock(mutex);
+        progress.bytes_total = bytes;
+    }
+    
+    void SetupTask::addAtoms(size_t atoms, size_t coarse_atoms)
+    {
+        ofScopedLock lock(mutex);
+        progress.atoms_built += atoms;
+        progress.coarse_atoms_built += coarse_atoms;
+    }
+    
+    void SetupTask::threadedFunction()
+    {
+        system.setup(path, mode, useCache, this);
+        
+        ofScopedLock lock(mutex);
+        done = true;
+    }
+}
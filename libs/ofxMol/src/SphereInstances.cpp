@@ -0,0 +1,208 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/SphereInstances.h"
+
+namespace OfxMol
+{
+    SphereInstances::SphereInstances(int resolution) : _sphere(&SphereTemplate::get(resolution))
+    {
+    }
+    
+    void SphereInstances::reserve(size_t n)
+    {
+        _instances.reserve(n);
+    }
+    
+    void SphereInstances::clear()
+    {
+        _instances.clear();
+    }
+    
+    void SphereInstances::add(const ofVec3f &position, float radius, const ofFloatColor &color)
+    {
+        _instances.push_back(SphereInstance());
+        SphereInstance &instance = _instances.back();
+        instance.position = position;
+        instance.radius = radius;
+        instance.color = color;
+    }
+    
+    class SphereInstances::FacesJob : public MeshBuilder::Job
+    {
+    public:
+        FacesJob(const SphereInstances &instances, const MeshBuilder::Arrays &arrays) :
+            instances(instances), arrays(arrays)
+        {
+        }
+        
+        void run(size_t /*slice*/, size_t begin, size_t end)
+        {
+            instances.writeFaces(arrays, begin, end);
+        }
+        
+    protected:
+        const SphereInstances &instances;
+        MeshBuilder::Arrays arrays;
+    };
+    
+    class SphereInstances::IndexedJob : public MeshBuilder::Job
+    {
+    public:
+        IndexedJob(const SphereInstances &instances, const MeshBuilder::Arrays &arrays) :
+            instances(instances), arrays(arrays)
+        {
+        }
+        
+        void run(size_t /*slice*/, size_t begin, size_t end)
+        {
+            instances.writeIndexed(arrays, begin, end, 0);
+        }
+        
+    protected:
+        const SphereInstances &instances;
+        MeshBuilder::Arrays arrays;
+    };
+    
+    // Items are the meshes of the split, each one sized and written by its thread
+    class SphereInstances::SplitJob : public MeshBuilder::Job
+    {
+    public:
+        SplitJob(const SphereInstances &instances, std::vector<ofMesh> &meshes, bool with_colors, size_t spheres_per_mesh) :
+            instances(instances), meshes(meshes), with_colors(with_colors), spheres_per_mesh(spheres_per_mesh)
+        {
+        }
+        
+        void run(size_t /*slice*/, size_t begin, size_t end)
+        {
+            for (size_t i=begin; i<end; i++)
+            {
+                size_t first = i * spheres_per_mesh;
+                size_t last = std::min(first + spheres_per_mesh, instances.size());
+                instances.writeIndexed(instances.resizeMesh(meshes[i], with_colors, true, last - first), first, last, first);
+            }
+        }
+        
+    protected:
+        const SphereInstances &instances;
+        std::vector<ofMesh> &meshes;
+        bool with_colors;
+        size_t spheres_per_mesh;
+    };
+    
+    // Spheres of a slice of the jobs: enough for the threads to be worth starting
+    static const size_t MIN_SPHERES_PER_SLICE = 256;
+    
+    void SphereInstances::expand(ofMesh &mesh, bool with_colors, const MeshBuilder &builder) const
+    {
+        FacesJob job(*this, resizeMesh(mesh, with_colors, false, _instances.size()));
+        builder.run(job, _instances.size(), MIN_SPHERES_PER_SLICE);
+    }
+    
+    void SphereInstances::expandIndexed(ofMesh &mesh, bool with_colors, const MeshBuilder &builder) const
+    {
+        IndexedJob job(*this, resizeMesh(mesh, with_colors, true, _instances.size()));
+        builder.run(job, _instances.size(), MIN_SPHERES_PER_SLICE);
+    }
+    
+    void SphereInstances::expandIndexed(std::vector<ofMesh> &meshes, bool with_colors, size_t max_vertices, const MeshBuilder &builder) const
+    {
+        const size_t sphere_vertices = _sphere->mesh().getNumVertices();
+        const size_t spheres_per_mesh = std::max(max_vertices / sphere_vertices, size_t(1));
+        
+        meshes.clear();
+        meshes.resize((_instances.size() + spheres_per_mesh - 1) / spheres_per_mesh);
+        SplitJob job(*this, meshes, with_colors, spheres_per_mesh);
+        builder.run(job, meshes.size());
+    }
+    
+    MeshBuilder::Arrays SphereInstances::resizeMesh(ofMesh &mesh, bool with_colors, bool indexed, size_t count) const
+    {
+        if (indexed)
+        {
+            return MeshBuilder::resize(mesh, count * _sphere->mesh().getNumVertices(), true, with_colors, count * _sphere->mesh().getNumIndices());
+        }
+        return MeshBuilder::resize(mesh, count * _sphere->faceNormals().size(), true, with_colors);
+    }
+    
+    void SphereInstances::writeFaces(const MeshBuilder::Arrays &arrays, size_t first, size_t last) const
+    {
+        const std::vector<ofVec3f> &normals = _sphere->faceNormals();
+        
+        size_t v = first * normals.size();
+        for (size_t i=first; i<last; i++)
+        {
+            const SphereInstance &instance = _instances[i];
+            for (size_t k=0; k<normals.size(); k++, v++)
+            {
+                arrays.vertices[v] = normals[k] * instance.radius + instance.position;
+                arrays.normals[v] = normals[k];
+            }
+            if (arrays.colors != NULL)
+            {
+                std::fill(arrays.colors + (v - normals.size()), arrays.colors + v, instance.color);
+            }
+        }
+    }
+    
+    void SphereInstances::writeIndexed(const MeshBuilder::Arrays &arrays, size_t first, size_t last, size_t base) const
+    {
+        const std::vector<ofVec3f> &unit_vertices = _sphere->mesh().getVertices();
+        const std::vector<ofVec3f> &unit_normals = _sphere->mesh().getNormals();
+        const std::vector<ofIndexType> &unit_indices = _sphere->mesh().getIndices();
+        const size_t sphere_vertices = unit_vertices.size();
+        
+        size_t v = (first - base) * sphere_vertices;
+        size_t n = (first - base) * unit_indices.size();
+        for (size_t i=first; i<last; i++)
+        {
+            const SphereInstance &instance = _instances[i];
+            // indices of this sphere are shifted by its first vertex
+            const ofIndexType offset = static_cast<ofIndexType>(v);
+            for (size_t k=0; k<unit_indices.size(); k++, n++)
+            {
+                arrays.indices[n] = unit_indices[k] + offset;
+            }
+            for (size_t k=0; k<sphere_vertices; k++, v++)
+            {
+                // the unit sphere has radius 1: its vertices are its normals, as in faceNormals()
+                arrays.vertices[v] = unit_vertices[k] * instance.radius + instance.position;
+                arrays.normals[v] = unit_normals[k];
+            }
+            if (arrays.colors != NULL)
+            {
+                std::fill(arrays.colors + (v - sphere_vertices), arrays.colors + v, instance.color);
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/SphereTemplate.h"
+
+namespace OfxMol
+{
+    namespace
+    {
+        ofMutex templates_mutex;
+        std::map<int, SphereTemplate*> templates;
+    }
+    
+    const SphereTemplate &SphereTemplate::get(int resolution)
+    {
+        ofScopedLock lock(templates_mutex);
+        SphereTemplate *&sphere = templates[resolution];
+        if (sphere == NULL)
+        {
+            sphere = new SphereTemplate(resolution);
+        }
+        return *sphere;
+    }
+    
+    SphereTemplate::SphereTemplate(int resolution) : _resolution(resolution)
+    {
+        ofSpherePrimitive sphere;
+        sphere.setResolution(resolution);
+        sphere.setRadius(1.0f);
+        unit_mesh = sphere.getMesh();
+        
+        vector<ofMeshFace> triangles = unit_mesh.getUniqueFaces();
+        face_normals.reserve(3 * triangles.size());
+        for (size_t j=0; j<triangles.size(); j++)
+        {
+            face_normals.push_back(triangles[j].getNormal(0));
+            face_normals.push_back(triangles[j].getNormal(1));
+            face_normals.push_back(triangles[j].getNormal(2));
+        }
+    }
+}
@@ -31,198 +31,393 @@
 // Author(s)     :  Davide Rambaldi
 
 #include "ofxMol/System.h"
+#include "ofxMol/Cache.h"
+#include "ofxMol/LazyModels.h"
+#include "ofxMol/SetupTask.h"
 
 namespace OfxMol
 {
     // SYSTEM IS DEFAULT WITH COARSE GRAIN
     typedef ESBTL::All_atom_system_builder<ESBTL::Default_system_with_coarse_grain> OfxMol_Builder;
-    typedef ESBTL::Coarse_atoms_iterators<ESBTL::Default_system_with_coarse_grain::Model>::iterator OfxMol_Coarse_atoms_iterator;
     
     // OCCUPANCY POLICIES
     typedef ESBTL::Accept_all_occupancy_policy<ESBTL::PDB::Line_format<> > Accept_all_occupancy_policy;
     typedef ESBTL::Accept_none_occupancy_policy<ESBTL::PDB::Line_format<> > Accept_none_occupancy_policy;
     
-    void System::setupSimple(std::string &path)
+    namespace
     {
-        // simple line selector: all atoms and hetero-atoms are in the one system.
-        ESBTL::PDB_line_selector sel;
-        /*
-         * Class responsible for building a coarse grain model
-         * Creator of a coarse grain model creating up to two pseudo-atoms:
-         * one as the barycenter of backbone atoms (if relevant) and one as the barycenter
-         * of non-barycenter atoms.
-         * Backbone atoms are identified using the global function ESBTL::is_backbone.
-         */
-        ESBTL::Coarse_creator_two_barycenters<ESBTL::Default_system_with_coarse_grain::Residue> creator;
-        
-        systems.clear();
-        models.clear();
-        water_models.clear();
-        
-        //Build the system from the PDB file.
-        OfxMol_Builder builder(systems,sel.max_nb_systems());
-        
-        if (ESBTL::read_a_pdb_file(path,sel,builder,Accept_all_occupancy_policy()))
+        //! Lines of a buffer in memory (the memory-mapped PDB file)
+        class Buffer_lines
         {
-            if (systems.empty() || systems.size() != 1)
+        public:
+            Buffer_lines(const char *begin, const char *end) : begin(begin), end(end) {}
+            
+            bool next_line(ESBTL::Line_span &line)
             {
-                ofLogFatalError() << "[ofxMol::System] Can create systems from input file: " << path << " using Mode SIMPLE";
+                if (begin == end)
+                {
+                    return false;
+                }
+                const char *eol = static_cast<const char *>(memchr(begin, '\n', end - begin));
+                if (eol == NULL)
+                {
+                    eol = end;
+                }
+                line = ESBTL::Line_span(begin, eol);
+                begin = (eol == end) ? end : eol + 1;
+                return true;
             }
             
-            if (systems[0].has_no_model())
+        private:
+            const char *begin;
+            const char *end;
+        };
+        
+        //! Lines of a Line_source reported to a SetupTask (if any): the source ends early when the task is cancelled
+        template <class Line_source>
+        class Task_lines
+        {
+        public:
+            Task_lines(Line_source &source, SetupTask *task) : source(source), task(task), pending(0) {}
+            
+            ~Task_lines()
             {
-                ofLogError() << "[ofxMol::System] No models found in file: " << path;
+                flush();
             }
             
-            // BEGIN MODEL LOOP
-            for (ESBTL::Default_system_with_coarse_grain::Models_iterator it_model=systems[0].models_begin(); it_model!=systems[0].models_end(); ++it_model)
+            bool next_line(ESBTL::Line_span &line)
             {
-                // create coarse atoms in models
-                ESBTL::Default_system_with_coarse_grain::Model& model =* it_model;
-                for (ESBTL::Default_system_with_coarse_grain::Model::Residues_iterator it_res=model.residues_begin(); it_res!=model.residues_end(); ++it_res)
+                if (!source.next_line(line))
                 {
-                    it_res->create_coarse_atoms(creator);
+                    return false;
                 }
-                
-                // ofxModel
-                OfxMol::Model ofxModel = OfxMol::Model(model.model_number());
-                
-                for (ESBTL::Default_system_with_coarse_grain::Model::Atoms_iterator it_atm=model.atoms_begin(); it_atm!=model.atoms_end(); ++it_atm)
+                if (task)
                 {
-                    // add atom
-                    OfxMol::Atom atom = OfxMol::Atom(*it_atm);
-                    // ofLogNotice() << it_atm->temperature_factor();
-                    ofxModel.add_atom(atom);
+                    pending += line.length() + 1;
+                    // report by blocks of 64 KB, not to lock the task for each line
+                    if (pending >= 64 * 1024)
+                    {
+                        flush();
+                        if (task->isCancelled())
+                        {
+                            return false;
+                        }
+                    }
                 }
-                
-                for (OfxMol_Coarse_atoms_iterator itc=ESBTL::coarse_atoms_begin(model); itc!=ESBTL::coarse_atoms_end(model); ++itc)
+                return true;
+            }
+            
+            void flush()
+            {
+                if (task && pending)
                 {
-                    // add coarse atoms
-                    OfxMol::Coarse_Atom coarse_atom = OfxMol::Coarse_Atom(*itc);
-                    ofxModel.add_coarse_atom(coarse_atom);
+                    task->addBytes(pending);
                 }
-                
-                // push model
-                models.push_back(ofxModel);
+                pending = 0;
             }
-            // END MODEL LOOP
             
-            ofLogNotice() << "[ofxMol::System] Setup complete for file: " << path;
-        }
-        else
+        private:
+            Line_source &source;
+            SetupTask *task;
+            size_t pending;
+        };
+        
+#ifdef OFXMOL_COMPRESSED_PDB
+        template <ESBTL::Reading_mode mode, class Line_selector>
+        bool readCompressedPDB(const std::string &path, Line_selector &sel, OfxMol_Builder &builder, SetupTask *task)
         {
-            ofLogFatalError() << "[ofxMol::System] Setup incomplete for file: " << path;
+            // the decompressor thread feeds the parser
+            ESBTL::Decompression_pipeline<mode> input;
+            if (!input.open(path))
+            {
+                ofLogError() << "[ofxMol::System] Can not open file: " << path;
+                return false;
+            }
+            
+            // the size of the decompressed file is unknown: only bytes_parsed is reported
+            Task_lines<ESBTL::Decompression_pipeline<mode> > lines(input, task);
+            ESBTL::Line_reader<ESBTL::PDB::Line_format<>, Line_selector, OfxMol_Builder> reader(sel, builder);
+            bool ok = reader.read_lines(lines, Accept_all_occupancy_policy());
+            if (input.failed())
+            {
+                ofLogError() << "[ofxMol::System] Can not decompress file: " << path;
+                return false;
+            }
+            ofLogNotice() << "[ofxMol::System] " << path << ": " << input.statistics();
+            return ok;
         }
-    }
-    
-    void System::setupAdvanced(std::string &path)
-    {
-        /** This is a line selector defining two systems:
-         * - the first one contains all heavy atoms that do not belong to a water molecule.
-         * - the second one contains all containing heavy atoms of water molecules.
-         */
-        ESBTL::PDB_line_selector_two_systems sel;
-        /*
-         * Class responsible for building a coarse grain model
-         * Creator of a coarse grain model creating up to two pseudo-atoms:
-         * one as the barycenter of backbone atoms (if relevant) and one as the barycenter
-         * of non-barycenter atoms.
-         * Backbone atoms are identified using the global function ESBTL::is_backbone.
-         */
-        ESBTL::Coarse_creator_two_barycenters<ESBTL::Default_system_with_coarse_grain::Residue> creator;
+#endif
         
-        systems.clear();
-        models.clear();
-        water_models.clear();
-        
-        //Build the system from the PDB file.
-        OfxMol_Builder builder(systems,sel.max_nb_systems());
-        
-        if (ESBTL::read_a_pdb_file(path,sel,builder,Accept_all_occupancy_policy()))
+        template <class Line_selector>
+        bool readMappedPDB(const std::string &path, Line_selector &sel, OfxMol_Builder &builder, SetupTask *task)
         {
-            if (systems.empty() || systems.size() != 2)
+            ESBTL::internal::Mapped_file file;
+            if (!file.open(path))
             {
-                ofLogFatalError() << "[ofxMol::System] Can create systems from input file: " << path << " using Mode ADVANCED";
+                ofLogError() << "[ofxMol::System] Can not open file: " << path;
+                return false;
             }
             
-            if (systems[0].has_no_model())
+            if (task)
             {
-                ofLogError() << "[ofxMol::System] No atoms found in file: " << path;
+                task->setTotalBytes(file.size());
             }
             
-            systems[0].name() = "atoms";
-            systems[1].name() = "water";
-            
-            // BEGIN MODEL LOOP
-            for (ESBTL::Default_system_with_coarse_grain::Models_iterator it_model=systems[0].models_begin(); it_model!=systems[0].models_end(); ++it_model)
+            Buffer_lines input(file.data(), file.data() + file.size());
+            Task_lines<Buffer_lines> lines(input, task);
+            ESBTL::Line_reader<ESBTL::PDB::Line_format<>, Line_selector, OfxMol_Builder> reader(sel, builder);
+            return reader.read_lines(lines, Accept_all_occupancy_policy());
+        }
+        
+        //! Read a PDB file, compressed with gzip or bzip2 or not. Progress is reported to task if not NULL.
+        template <class Line_selector>
+        bool readPDB(const std::string &path, Line_selector &sel, OfxMol_Builder &builder, SetupTask *task)
+        {
+            switch (ESBTL::detect_reading_mode(path))
             {
-                // create coarse atoms in models
-                ESBTL::Default_system_with_coarse_grain::Model& model =* it_model;
-                for (ESBTL::Default_system_with_coarse_grain::Model::Residues_iterator it_res=model.residues_begin(); it_res!=model.residues_end(); ++it_res)
-                {
-                    it_res->create_coarse_atoms(creator);
-                }
-                
-                // ofxModel
-                OfxMol::Model ofxModel = OfxMol::Model(model.model_number());
-                
-                for (ESBTL::Default_system_with_coarse_grain::Model::Atoms_iterator it_atm=model.atoms_begin(); it_atm!=model.atoms_end(); ++it_atm)
-                {
-                    // add atom
-                    OfxMol::Atom atom = OfxMol::Atom(*it_atm);
-                    // ofLogNotice() << it_atm->temperature_factor();
-                    ofxModel.add_atom(atom);
-                }
-                
-                for (OfxMol_Coarse_atoms_iterator itc=ESBTL::coarse_atoms_begin(model); itc!=ESBTL::coarse_atoms_end(model); ++itc)
-                {
-                    // add coarse atoms
-                    OfxMol::Coarse_Atom coarse_atom = OfxMol::Coarse_Atom(*itc);
-                    ofxModel.add_coarse_atom(coarse_atom);
-                }
-                
-                // push model
-                models.push_back(ofxModel);
+#ifdef OFXMOL_COMPRESSED_PDB
+                case ESBTL::GZIP:
+                    return readCompressedPDB<ESBTL::GZIP>(path, sel, builder, task);
+                case ESBTL::BZIP2:
+                    return readCompressedPDB<ESBTL::BZIP2>(path, sel, builder, task);
+#else
+                case ESBTL::GZIP:
+                case ESBTL::BZIP2:
+                    ofLogError() << "[ofxMol::System] Compressed file: " << path << " (define OFXMOL_COMPRESSED_PDB to read compressed files)";
+                    return false;
+#endif
+                default:
+                    return readMappedPDB(path, sel, builder, task);
             }
-            // END MODEL LOOP
-            
-            
-            // BEGIN WATER MODEL LOOP
-            for (ESBTL::Default_system_with_coarse_grain::Models_iterator it_model=systems[1].models_begin(); it_model!=systems[1].models_end(); ++it_model)
+        }
+        
+        bool isCancelled(SetupTask *task)
+        {
+            return task && task->isCancelled();
+        }
+    }
+    
+    namespace
+    {
+        //! Append the models of an ESBTL system to models, each built in place. Returns false if the task is cancelled.
+        bool buildModels(ESBTL::Default_system_with_coarse_grain &system, std::vector<OfxMol::Model> &models, bool with_coarse_atoms, SetupTask *task)
+        {
+            models.reserve(models.size() + system.number_of_models());
+            for (ESBTL::Default_system_with_coarse_grain::Models_iterator it_model=system.models_begin(); it_model!=system.models_end(); ++it_model)
             {
-                const ESBTL::Default_system_with_coarse_grain::Model& model =* it_model;
-                OfxMol::Model ofxWaterModel = OfxMol::Model(model.model_number());
-                
-                for (ESBTL::Default_system_with_coarse_grain::Model::Atoms_const_iterator it_atm=model.atoms_begin(); it_atm!=model.atoms_end(); ++it_atm)
+                if (isCancelled(task))
                 {
-                    OfxMol::Atom atom = OfxMol::Atom(*it_atm);
-                    ofxWaterModel.add_atom(atom);
+                    return false;
                 }
                 
-                water_models.push_back(ofxWaterModel);
+                // an empty model is pushed and then filled, not to copy the atoms of a built model
+                models.push_back(OfxMol::Model());
+                models.back().build(*it_model, with_coarse_atoms);
+                if (task)
+                {
+                    task->addAtoms(models.back().number_of_atoms(), models.back().number_of_coarse_atoms());
+                }
             }
-            // BEGIN WATER MODEL LOOP
-            ofLogNotice() << "[ofxMol::System] Setup complete for file: " << path;
+            return true;
         }
-        else
+    }
+    
+    template <class Line_selector>
+    void System::setupModels(std::string &path, Line_selector &sel, SetupMode mode, SetupTask *task)
+    {
+        const char *mode_name = (mode == ADVANCED) ? "ADVANCED" : "SIMPLE";
+        systems.clear();
+        models.clear();
+        water_models.clear();
+        
+        //Build the system from the PDB file.
+        OfxMol_Builder builder(systems,sel.max_nb_systems());
+        
+        bool ok = readPDB(path,sel,builder,task);
+        if (isCancelled(task))
+        {
+            ofLogNotice() << "[ofxMol::System] Setup cancelled for file: " << path;
+            return;
+        }
+        
+        if (!ok)
         {
             ofLogFatalError() << "[ofxMol::System] Setup incomplete for file: " << path;
+            return;
+        }
+        
+        if (systems.size() != sel.max_nb_systems())
+        {
+            ofLogFatalError() << "[ofxMol::System] Can create systems from input file: " << path << " using Mode " << mode_name;
+            return;
+        }
+        
+        if (systems[0].has_no_model())
+        {
+            ofLogError() << "[ofxMol::System] " << (mode == ADVANCED ? "No atoms" : "No models") << " found in file: " << path;
+        }
+        
+        if (mode == ADVANCED)
+        {
+            systems[0].name() = "atoms";
+            systems[1].name() = "water";
         }
+        
+        // models with coarse atoms, then water models (second system, if any) without
+        if (!buildModels(systems[0], models, true, task) ||
+            (systems.size() > 1 && !buildModels(systems[1], water_models, false, task)))
+        {
+            ofLogNotice() << "[ofxMol::System] Setup cancelled for file: " << path;
+            return;
+        }
+        
+        ofLogNotice() << "[ofxMol::System] Setup complete for file: " << path;
     }
     
-    void System::setup(std::string path, SetupMode mode)
+    void System::setupSimple(std::string &path, SetupTask *task)
     {
+        // simple line selector: all atoms and hetero-atoms are in the one system.
+        ESBTL::PDB_line_selector sel;
+        setupModels(path, sel, SIMPLE, task);
+    }
+    
+    void System::setupAdvanced(std::string &path, SetupTask *task)
+    {
+        /** This is a line selector defining two systems:
+         * - the first one contains all heavy atoms that do not belong to a water molecule.
+         * - the second one contains all containing heavy atoms of water molecules.
+         */
+        ESBTL::PDB_line_selector_two_systems sel;
+        setupModels(path, sel, ADVANCED, task);
+    }
+    
+    void System::setup(std::string path, SetupMode mode, bool useCache)
+    {
+        setup(path, mode, useCache, NULL);
+    }
+    
+    void System::setup(std::string path, SetupMode mode, bool useCache, SetupTask *task)
+    {
+        unsigned long long start = ofGetElapsedTimeMicros();
+        lazyModels.reset();
+        std::string cachePath = Cache::path(path, mode);
+        // stat the file before parsing it: a cache is never newer than what was parsed
+        Cache::Source source;
+        useCache = useCache && Cache::stat(path, source);
+        
+        if (useCache && Cache::isFresh(cachePath, path))
+        {
+            systems.clear();
+            if (Cache::read(cachePath, mode, models, water_models))
+            {
+                ofLogVerbose() << "[ofxMol::System] Setup complete from cache: " << cachePath << " in " << (ofGetElapsedTimeMicros() - start) / 1000.0 << " ms";
+                return;
+            }
+            ofLogWarning() << "[ofxMol::System] Invalid cache file: " << cachePath;
+        }
+        
         switch (mode)
         {
             case SIMPLE:
-                setupSimple(path);
+                setupSimple(path, task);
                 break;
             case ADVANCED:
-                setupAdvanced(path);
+                setupAdvanced(path, task);
                 break;
             default:
                 break;
         }
-
+        if (isCancelled(task))
+        {
+            // never cache (or publish) the models of a cancelled setup
+            return;
+        }
+        ofLogVerbose() << "[ofxMol::System] Parsed " << path << " in " << (ofGetElapsedTimeMicros() - start) / 1000.0 << " ms";
+        
+        if (useCache && !models.empty() && !Cache::write(cachePath, source, mode, models, water_models))
+        {
+            ofLogWarning() << "[ofxMol::System] Can not write cache file: " << cachePath;
+        }
+    }
+    
+    ofPtr<SetupTask> System::setupAsync(std::string path, SetupMode mode, bool useCache)
+    {
+        ofPtr<SetupTask> task(new SetupTask(path, mode, useCache));
+        task->startThread(true, false);
+        return task;
+    }
+    
+    void System::swap(System &other)
+    {
+        systems.swap(other.systems);
+        models.swap(other.models);
+        water_models.swap(other.water_models);
+        lazyModels.swap(other.lazyModels);
+    }
+    
+    void System::setupLazy(std::string path, SetupMode mode, size_t cacheBytes)
+    {
+        systems.clear();
+        models.clear();
+        water_models.clear();
+        
+        lazyModels = ofPtr<OfxMol::LazyModels>(new OfxMol::LazyModels());
+        if (!lazyModels->setup(path, mode, cacheBytes))
+        {
+            lazyModels.reset();
+            ofLogFatalError() << "[ofxMol::System] Setup incomplete for file: " << path;
+        }
+    }
+    
+    void System::prefetchModel(unsigned int i)
+    {
+        if (lazyModels)
+        {
+            lazyModels->prefetch(i);
+        }
+    }
+    
+    void System::setModelCacheBytes(size_t bytes)
+    {
+        if (lazyModels)
+        {
+            lazyModels->setCacheBytes(bytes);
+        }
+    }
+    
+    Model &System::getModel(unsigned int i)
+    {
+        if (lazyModels)
+        {
+            return lazyModels->getModel(i);
+        }
+        return models[i];
+    }
+    
+    unsigned int System::number_of_models() const
+    {
+        if (lazyModels)
+        {
+            return lazyModels->number_of_models();
+        }
+        return models.size();
+    }
+    
+    Model System::getWaterModel(unsigned int i)
+    {
+        if (lazyModels)
+        {
+            return lazyModels->getWaterModel(i);
+        }
+        return water_models[i];
+    }
+    
+    unsigned int System::number_of_water_models() const
+    {
+        if (lazyModels)
+        {
+            return lazyModels->number_of_water_models();
+        }
+        return water_models.size();
     }
-}
\ No newline at end of file
+}
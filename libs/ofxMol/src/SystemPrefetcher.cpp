@@ -0,0 +1,335 @@
+// Copyright (c) 2015 Davide Rambaldi.
+// All rights reserved.
+//
+// This file is part of ofxMol.
+//
+// ofxMol is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// ofxMol is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with ofxMol.  If not, see <http://www.gnu.org/licenses/>.
+//
+//
+// Additional permission under GNU GPL version 3 section 7
+//
+// If you modify this Library, or any covered work, by linking or
+// combining it with ofxMol (or a modified version of that library), the
+// licensors of this Library grant you additional permission to convey
+// the resulting work. Corresponding Source for a non-source form of
+// such a combination shall include the source code for the parts of CGAL
+// used as well as that of the covered work.
+//
+//
+//
+// Author(s)     :  Davide Rambaldi
+
+
+#include "ofxMol/SystemPrefetcher.h"
+
+namespace OfxMol
+{
+    namespace
+    {
+        size_t modelBytes(Model &model)
+        {
+            return sizeof(Model) + model.number_of_atoms() * sizeof(Atom) + model.number_of_coarse_atoms() * sizeof(Coarse_Atom);
+        }
+        
+        size_t meshBytes(ofMesh &mesh)
+        {
+            return (mesh.getNumVertices() + mesh.getNumNormals()) * sizeof(ofVec3f) + mesh.getNumColors() * sizeof(ofFloatColor) + mesh.getNumIndices() * sizeof(ofIndexType);
+        }
+        
+        unsigned int distance(unsigned int i, unsigned int j)
+        {
+            return i > j ? i - j : j - i;
+        }
+    }
+    
+    SystemPrefetcher::SystemPrefetcher() :
+        mode(SIMPLE), neighbours(1), maxBytes(0), usedBytes(0), coarseResolution(8), atomsRadius(1.0f), atomsResolution(16),
+        current(0), loading(-1), full(false), hits(0), misses(0)
+    {
+    }
+    
+    SystemPrefetcher::~SystemPrefetcher()
+    {
+        stop();
+    }
+    
+    void SystemPrefetcher::setup(const std::vector<std::string> &paths, SetupMode mode, unsigned int neighbours, size_t maxBytes)
+    {
+        stop();
+        
+        this->paths = paths;
+        this->mode = mode;
+        this->neighbours = neighbours;
+        this->maxBytes = maxBytes;
+        entries.clear();
+        usedBytes = 0;
+        current = 0;
+        loading = -1;
+        full = false;
+        hits = 0;
+        misses = 0;
+        
+        if (!paths.empty())
+        {
+            startThread(true, false);
+        }
+    }
+    
+    void SystemPrefetcher::setMeshes(int coarseResolution, float atomsRadius, int atomsResolution)
+    {
+        this->coarseResolution = coarseResolution;
+        this->atomsRadius = atomsRadius;
+        this->atomsResolution = atomsResolution;
+    }
+    
+    void SystemPrefetcher::setCurrent(unsigned int i)
+    {
+        ofScopedLock lock(mutex);
+        if (i >= paths.size())
+        {
+            return;
+        }
+        
+        if (entries.find(i) != entries.end())
+        {
+            ++hits;
+        }
+        else
+        {
+            ++misses;
+        }
+        current = i;
+        full = false;
+        evict();
+        changed.signal();
+    }
+    
+    ofPtr<PrefetchedSystem> SystemPrefetcher::get(unsigned int i)
+    {
+        ofScopedLock lock(mutex);
+        std::map<unsigned int, ofPtr<PrefetchedSystem> >::iterator it = entries.find(i);
+        if (it == entries.end())
+        {
+            return ofPtr<PrefetchedSystem>();
+        }
+        return it->second;
+    }
+    
+    void SystemPrefetcher::setNeighbours(unsigned int n)
+    {
+        ofScopedLock lock(mutex);
+        neighbours = n;
+        full = false;
+        evict();
+        changed.signal();
+    }
+    
+    void SystemPrefetcher::setMaxBytes(size_t bytes)
+    {
+        ofScopedLock lock(mutex);
+        maxBytes = bytes;
+        full = false;
+        evict();
+        changed.signal();
+    }
+    
+    size_t SystemPrefetcher::getUsedBytes()
+    {
+        ofScopedLock lock(mutex);
+        return usedBytes;
+    }
+    
+    unsigned int SystemPrefetcher::getHits()
+    {
+        ofScopedLock lock(mutex);
+        return hits;
+    }
+    
+    unsigned int SystemPrefetcher::getMisses()
+    {
+        ofScopedLock lock(mutex);
+        return misses;
+    }
+    
+    void SystemPrefetcher::resetStatistics()
+    {
+        ofScopedLock lock(mutex);
+        hits = 0;
+        misses = 0;
+    }
+    
+    void SystemPrefetcher::threadedFunction()
+    {
+        lock();
+        while (isThreadRunning())
+        {
+            int i = next();
+            if (i < 0)
+            {
+                // until a move, a change of the budget or stop()
+                changed.wait(mutex);
+                continue;
+            }
+            loading = i;
+            task = System::setupAsync(paths[i], mode);
+            ofPtr<SetupTask> setup = task;
+            unlock();
+            
+            unsigned long long start = ofGetElapsedTimeMicros();
+            ofPtr<PrefetchedSystem> entry(new PrefetchedSystem());
+            entry->path = setup->getPath();
+            setup->waitForThread(false);
+            
+            // a file out of the neighbourhood was cancelled by evict()
+            if (!setup->isCancelled())
+            {
+                // a file that can not be set up is kept without models, it is not loaded again
+                setup->publish(entry->system);
+                build(*entry);
+                ofLogNotice() << "[ofxMol::SystemPrefetcher] Loaded " << entry->path << " (" << entry->bytes / 1024 << " KB) in " << (ofGetElapsedTimeMicros() - start) / 1000.0 << " ms";
+            }
+            
+            lock();
+            loading = -1;
+            task.reset();
+            if (!setup->isCancelled() && isNeighbour(i) && entries.find(i) == entries.end())
+            {
+                entries[i] = entry;
+                usedBytes += entry->bytes;
+                if (usedBytes > maxBytes)
+                {
+                    // stop prefetching until the next move
+                    full = true;
+                    evict();
+                }
+            }
+        }
+        unlock();
+    }
+    
+    void SystemPrefetcher::stop()
+    {
+        lock();
+        if (task)
+        {
+            task->cancel();
+        }
+        stopThread();
+        changed.signal();
+        unlock();
+        waitForThread(false);
+    }
+    
+    int SystemPrefetcher::next()
+    {
+        // the current file, then its neighbours from the nearest
+        for (unsigned int d = 0; d <= neighbours; ++d)
+        {
+            if (d > 0 && (full || usedBytes >= maxBytes))
+            {
+                return -1;
+            }
+            
+            for (int side = 0; side < 2; ++side)
+            {
+                if (d == 0 && side == 1)
+                {
+                    break;
+                }
+                
+                int i = side == 0 ? (int) current + d : (int) current - (int) d;
+                if (i < 0 || i >= (int) paths.size() || i == loading)
+                {
+                    continue;
+                }
+                if (entries.find(i) == entries.end())
+                {
+                    return i;
+                }
+            }
+        }
+        return -1;
+    }
+    
+    bool SystemPrefetcher::isNeighbour(unsigned int i) const
+    {
+        return distance(i, current) <= neighbours;
+    }
+    
+    void SystemPrefetcher::evict()
+    {
+        std::map<unsigned int, ofPtr<PrefetchedSystem> >::iterator it = entries.begin();
+        while (it != entries.end())
+        {
+            if (!isNeighbour(it->first))
+            {
+                usedBytes -= it->second->bytes;
+                entries.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        
+        // then the farthest files above the budget, never the current one
+        while (usedBytes > maxBytes)
+        {
+            std::map<unsigned int, ofPtr<PrefetchedSystem> >::iterator farthest = entries.end();
+            for (it = entries.begin(); it != entries.end(); ++it)
+            {
+                if (it->first != current && (farthest == entries.end() || distance(it->first, current) > distance(farthest->first, current)))
+                {
+                    farthest = it;
+                }
+            }
+            if (farthest == entries.end())
+            {
+                break;
+            }
+            usedBytes -= farthest->second->bytes;
+            entries.erase(farthest);
+        }
+        
+        if (loading >= 0 && !isNeighbour(loading) && task)
+        {
+            task->cancel();
+        }
+    }
+    
+    void SystemPrefetcher::build(PrefetchedSystem &entry)
+    {
+        entry.bytes = sizeof(PrefetchedSystem);
+        
+        if (entry.system.number_of_models() > 0)
+        {
+            Model &model = entry.system.getModel(0);
+            entry.coarseAtomsMesh = model.coarseAtomsMesh(coarseResolution);
+            entry.atomsMesh = model.atomsMesh(atomsRadius, atomsResolution);
+            entry.atomsPointCloud = model.atomsPointCloud();
+            entry.backbone = model.backbonePoly();
+            
+            entry.bytes += meshBytes(entry.coarseAtomsMesh) + meshBytes(entry.atomsMesh) + meshBytes(entry.atomsPointCloud) + entry.backbone.size() * sizeof(ofPoint);
+        }
+        
+        for (System::Models_iterator it = entry.system.models_begin(); it != entry.system.models_end(); ++it)
+        {
+            entry.bytes += modelBytes(*it);
+        }
+        for (System::Models_iterator it = entry.system.water_models_begin(); it != entry.system.water_models_end(); ++it)
+        {
+            entry.bytes += modelBytes(*it);
+        }
+    }
+}
@@ -33,5 +33,9 @@
 #pragma once
 
 #include "ofxMol/System.h"
+#include "ofxMol/ColorScheme.h"
+#include "ofxMol/SetupTask.h"
+#include "ofxMol/SystemPrefetcher.h"
+#include "ofxMol/LodMeshes.h"
 
 
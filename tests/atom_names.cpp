@@ -0,0 +1,63 @@
+// Reads atom names with inner spaces (such as "C 1") in the three reading modes of ESBTL.
+//
+// g++ -I../libs/ESBTL/include atom_names.cpp -o atom_names -lboost_thread -lboost_system -lpthread && ./atom_names
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <ESBTL/default.h>
+#include <ESBTL/parallel_line_reader.h>
+
+typedef ESBTL::Accept_none_occupancy_policy<ESBTL::PDB::Line_format<> > Accept_none_occupancy_policy;
+
+enum Mode{ASCII_MODE,MMAP_MODE,PARALLEL_MODE};
+
+//returns the number of errors
+int check(const std::string& filename,Mode mode,const char* mode_name){
+  ESBTL::PDB_line_selector sel;
+  std::vector<ESBTL::Default_system> systems;
+  ESBTL::All_atom_system_builder<ESBTL::Default_system> builder(systems,sel.max_nb_systems());
+  bool ok=false;
+  switch(mode){
+    case ASCII_MODE:    ok=ESBTL::read_a_pdb_file<ESBTL::ASCII>(filename,sel,builder,Accept_none_occupancy_policy()); break;
+    case MMAP_MODE:     ok=ESBTL::read_a_pdb_file<ESBTL::MMAP>(filename,sel,builder,Accept_none_occupancy_policy()); break;
+    case PARALLEL_MODE: ok=ESBTL::read_a_pdb_file_in_parallel(filename,sel,builder,Accept_none_occupancy_policy(),' ',2); break;
+  }
+  if (!ok || systems.empty()){
+    std::cerr << mode_name << ": cannot read " << filename << std::endl;
+    return 1;
+  }
+  
+  const char* expected[]={"C 1","CA","N"};
+  int errors=0;
+  unsigned i=0;
+  const ESBTL::Default_system::Model& model=*systems[0].models_begin();
+  for (ESBTL::Default_system::Model::Atoms_const_iterator it=model.atoms_begin();it!=model.atoms_end();++it,++i){
+    if (i>=3 || it->atom_name()!=expected[i]){
+      std::cerr << mode_name << ": atom " << i << " is named <|" << it->atom_name() << "|>, expected <|" << (i<3?expected[i]:"") << "|>" << std::endl;
+      ++errors;
+    }
+  }
+  if (i!=3){
+    std::cerr << mode_name << ": " << i << " atoms read, expected 3" << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int main(){
+  const std::string filename="atom_names.pdb";
+  {
+    std::ofstream out(filename.c_str());
+    out << "HETATM    1  C 1 LIG A   1       3.023  15.761  22.868  1.00 24.81           C  \n";
+    out << "HETATM    2  CA  LIG A   1       2.012  15.419  21.825  1.00 24.80           C  \n";
+    out << "HETATM    3  N   LIG A   1       1.000  14.000  20.000  1.00 24.80           N  \n";
+    out << "END\n";
+  }
+  
+  int errors=check(filename,ASCII_MODE,"ASCII")+check(filename,MMAP_MODE,"MMAP")+check(filename,PARALLEL_MODE,"parallel");
+  std::remove(filename.c_str());
+  
+  std::cout << (errors==0?"OK":"FAILED") << std::endl;
+  return errors==0?EXIT_SUCCESS:EXIT_FAILURE;
+}